@@ -0,0 +1,296 @@
+#include "batchRender.h"
+
+#include "camera/usdCamera.h"
+#include "core/utils.h"
+#include "render/usdRenderEngineGL.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+#include <QRegularExpression>
+#include <QThread>
+#include <pxr/usd/usdGeom/camera.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+constexpr int EXIT_RENDER_FAILED = 1;
+constexpr int EXIT_INVALID_ARGUMENTS = 2;
+
+QString formatFrame(const UsdTimeCode& time, int width)
+{
+    const double frame = time.IsDefault() ? 0.0 : time.GetValue();
+    if (frame == std::floor(frame))
+    {
+        return QString("%1").arg(static_cast<qint64>(frame), width, 10, QChar('0'));
+    }
+    return QString::number(frame, 'f', 3);
+}
+
+QString framePath(const QString& pattern, const UsdTimeCode& time, bool multipleFrames)
+{
+    static const QRegularExpression hashes("#+");
+
+    const QRegularExpressionMatch match = hashes.match(pattern);
+    if (match.hasMatch())
+    {
+        const QString frame = formatFrame(time, match.capturedLength());
+        return QString(pattern).replace(match.capturedStart(), match.capturedLength(), frame);
+    }
+
+    if (!multipleFrames)
+    {
+        return pattern;
+    }
+
+    const QFileInfo info(pattern);
+    return QDir(info.path()).filePath(
+        QString("%1.%2.%3").arg(info.completeBaseName(), formatFrame(time, 4), info.suffix()));
+}
+
+} // namespace
+
+namespace TINKERUSD_NS
+{
+
+bool parseFrameRange(const QString& text, BatchRenderOptions* options)
+{
+    const QStringList parts = text.split(':');
+    if (parts.size() > 3)
+    {
+        return false;
+    }
+
+    bool   ok = true;
+    double values[3] = { 0.0, 0.0, 1.0 };
+    for (int i = 0; i < parts.size() && ok; ++i)
+    {
+        values[i] = parts[i].toDouble(&ok);
+    }
+    if (parts.size() == 1)
+    {
+        values[1] = values[0];
+    }
+
+    if (!ok || values[1] < values[0] || values[2] <= 0.0)
+    {
+        return false;
+    }
+
+    options->hasFrameRange = true;
+    options->startFrame = values[0];
+    options->endFrame = values[1];
+    options->frameStep = values[2];
+    return true;
+}
+
+bool parseResolution(const QString& text, BatchRenderOptions* options)
+{
+    const QStringList parts = text.toLower().split('x');
+    if (parts.size() != 2)
+    {
+        return false;
+    }
+
+    bool      okWidth = false;
+    bool      okHeight = false;
+    const int width = parts[0].toInt(&okWidth);
+    const int height = parts[1].toInt(&okHeight);
+    if (!okWidth || !okHeight || width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    options->width = width;
+    options->height = height;
+    return true;
+}
+
+int runBatchRender(const UsdStageRefPtr& stage, const BatchRenderOptions& options)
+{
+    if (options.outputPath.isEmpty())
+    {
+        qCritical() << "[Batch] No output image path.";
+        return EXIT_INVALID_ARGUMENTS;
+    }
+
+    SdfPath cameraPath;
+    if (!options.cameraPath.isEmpty())
+    {
+        const std::string pathString = options.cameraPath.toStdString();
+        if (SdfPath::IsValidPathString(pathString))
+        {
+            cameraPath = SdfPath(pathString);
+        }
+        if (cameraPath.IsEmpty() || !stage->GetPrimAtPath(cameraPath).IsA<UsdGeomCamera>())
+        {
+            qCritical() << "[Batch] Not a camera prim:" << options.cameraPath;
+            return EXIT_INVALID_ARGUMENTS;
+        }
+    }
+
+    std::vector<UsdTimeCode> times;
+    if (options.hasFrameRange || stage->HasAuthoredTimeCodeRange())
+    {
+        double startFrame = options.startFrame;
+        double endFrame = options.endFrame;
+        double frameStep = options.frameStep;
+        if (!options.hasFrameRange)
+        {
+            // one frame at the stage frame rate apart, like the timeline plays it
+            const double framesPerSecond = stage->GetFramesPerSecond();
+            const double timeCodesPerSecond = stage->GetTimeCodesPerSecond();
+            startFrame = stage->GetStartTimeCode();
+            endFrame = stage->GetEndTimeCode();
+            frameStep = framesPerSecond > 0.0 && timeCodesPerSecond > 0.0
+                          ? timeCodesPerSecond / framesPerSecond
+                          : 1.0;
+        }
+
+        // counted rather than accumulated, so fractional steps do not drift
+        const double span = (endFrame - startFrame) / frameStep;
+        const int    count = static_cast<int>(std::floor(span + 1e-6));
+        for (int i = 0; i <= count; ++i)
+        {
+            times.emplace_back(startFrame + i * frameStep);
+        }
+    }
+    if (times.empty())
+    {
+        times.push_back(UsdTimeCode::Default());
+    }
+
+    // engines are created up front, one per job: renderer plugins are loaded on first use.
+    const int jobs = std::clamp(options.jobs, 1, static_cast<int>(times.size()));
+    const TfToken rendererId(options.rendererId.toStdString());
+
+    std::vector<std::unique_ptr<UsdRenderEngineGL>> engines;
+    for (int job = 0; job < jobs; ++job)
+    {
+        auto engine = std::make_unique<UsdRenderEngineGL>();
+        if (!engine->initializeOffscreen(stage, rendererId))
+        {
+            qCritical() << "[Batch] Cannot render with" << options.rendererId
+                        << ", a renderer plugin that runs without a GPU is required.";
+            return EXIT_INVALID_ARGUMENTS;
+        }
+        engines.push_back(std::move(engine));
+    }
+
+    qInfo().noquote() << QString("[Batch] Rendering %1 frame(s) at %2x%3 with %4, %5 job(s)")
+                             .arg(times.size())
+                             .arg(options.width)
+                             .arg(options.height)
+                             .arg(QString::fromStdString(engines.front()->rendererDisplayName()))
+                             .arg(jobs);
+
+    std::atomic<int> failedFrames { 0 };
+    const qint64     timeoutMs = static_cast<qint64>(options.frameTimeoutSeconds * 1000.0);
+
+    auto renderFrames = [&](int job) {
+        UsdRenderEngineGL&         engine = *engines[job];
+        std::unique_ptr<UsdCamera> freeCamera;
+        if (cameraPath.IsEmpty())
+        {
+            freeCamera = std::make_unique<UsdCamera>(stage);
+        }
+
+        engine.params().clearColor = GfVec4f(0.2f, 0.2f, 0.2f, 1.0f);
+        engine.params().showRender = true;
+
+        for (size_t i = job; i < times.size(); i += jobs)
+        {
+            QElapsedTimer timer;
+            timer.start();
+
+            engine.params().frame = times[i];
+
+            // progressive renderers are polled until they reach their sample count or run out of time
+            bool converged = false;
+            while (true)
+            {
+                if (freeCamera)
+                {
+                    engine.render(stage, freeCamera.get(), options.width, options.height);
+                }
+                else
+                {
+                    engine.render(stage, cameraPath, options.width, options.height);
+                }
+                converged = engine.isConverged();
+                if (converged || timer.elapsed() > timeoutMs)
+                {
+                    break;
+                }
+                QThread::msleep(5);
+            }
+
+            if (!converged)
+            {
+                qCritical().noquote() << QString("[Batch] Frame %1 did not converge within %2 s")
+                                             .arg(formatFrame(times[i], 1))
+                                             .arg(options.frameTimeoutSeconds);
+                ++failedFrames;
+                continue;
+            }
+
+            const QString path = framePath(options.outputPath, times[i], times.size() > 1);
+            QImage        image;
+            QDir().mkpath(QFileInfo(path).absolutePath());
+            if (!engine.colorImage(&image) || !image.save(path))
+            {
+                qCritical().noquote() << QString("[Batch] Could not write frame %1 to %2")
+                                             .arg(formatFrame(times[i], 1), path);
+                ++failedFrames;
+                continue;
+            }
+
+            const double memory = residentMemoryMb();
+            qInfo().noquote() << QString("[Batch] Frame %1 rendered in %2 ms, %3 MB resident -> %4")
+                                     .arg(formatFrame(times[i], 1))
+                                     .arg(timer.elapsed())
+                                     .arg(memory < 0.0 ? QString("n/a") : QString::number(memory, 'f', 1))
+                                     .arg(path);
+        }
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (jobs == 1)
+    {
+        renderFrames(0);
+    }
+    else
+    {
+        std::vector<QThread*> threads;
+        for (int job = 0; job < jobs; ++job)
+        {
+            threads.push_back(QThread::create(renderFrames, job));
+            threads.back()->start();
+        }
+        for (QThread* thread : threads)
+        {
+            thread->wait();
+            delete thread;
+        }
+    }
+
+    qInfo().noquote() << QString("[Batch] Rendered %1 frame(s) in %2 ms, %3 failed")
+                             .arg(times.size())
+                             .arg(timer.elapsed())
+                             .arg(failedFrames.load());
+
+    return failedFrames > 0 ? EXIT_RENDER_FAILED : 0;
+}
+
+} // namespace TINKERUSD_NS
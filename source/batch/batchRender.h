@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <pxr/usd/usd/stage.h>
+
+namespace TINKERUSD_NS
+{
+
+// what runBatchRender renders and where the images go.
+struct BatchRenderOptions
+{
+    // image path, a run of '#' is replaced by the zero padded frame number, e.g. shot.####.png.
+    // Without it the frame number is inserted before the suffix when more than one frame is rendered.
+    QString outputPath;
+
+    // camera prim to render through. The stage is framed by a default camera when empty.
+    QString cameraPath;
+
+    // hydra renderer plugin. It must render on the CPU as no GL context is created.
+    QString rendererId { "HdEmbreeRendererPlugin" };
+
+    // inclusive frame range, in time codes. The stage time range is used when not set, one
+    // frame at the stage frame rate apart, or the default time when the stage has none.
+    bool   hasFrameRange { false };
+    double startFrame { 0.0 };
+    double endFrame { 0.0 };
+    double frameStep { 1.0 };
+
+    int width { 1280 };
+    int height { 720 };
+
+    // number of frames rendered at once, each by its own engine.
+    int jobs { 1 };
+
+    // a frame whose progressive render has not converged after this long fails.
+    double frameTimeoutSeconds { 600.0 };
+};
+
+// parses "start:end" or "start:end:step" into options. Returns false on malformed input.
+bool parseFrameRange(const QString& text, BatchRenderOptions* options);
+
+// parses "WIDTHxHEIGHT" into options. Returns false on malformed input.
+bool parseResolution(const QString& text, BatchRenderOptions* options);
+
+/*
+Renders frames of the stage to image files without a display or GL context, through a CPU
+hydra renderer. The render time and the resident memory of the process are reported per frame.
+
+Returns 0 when every frame was written, 1 when a frame failed or timed out and 2 when the options cannot
+be used with this stage, following the batch mode exit status.
+*/
+int runBatchRender(const PXR_NS::UsdStageRefPtr& stage, const BatchRenderOptions& options);
+
+} // namespace TINKERUSD_NS
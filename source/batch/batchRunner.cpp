@@ -0,0 +1,169 @@
+#include "batchRunner.h"
+
+#include "batchRender.h"
+#include "core/usdDocument.h"
+#include "ui/scriptEditor/pythonInterpreter.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+
+#include <cstring>
+
+namespace
+{
+constexpr int EXIT_INVALID_ARGUMENTS = 2;
+} // namespace
+
+namespace TINKERUSD_NS
+{
+
+bool isBatchMode(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--batch") == 0 || std::strcmp(argv[i], "--no-gui") == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int runBatch(QCoreApplication& app)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("TinkerUsd headless batch mode");
+    parser.addHelpOption();
+    parser.addOption({ { "batch", "no-gui" }, "Run without a display or GL context." });
+    parser.addOption({ "stage", "USD file to open before running the script.", "file" });
+    parser.addOption({ "script", "Python script to run.", "file" });
+    parser.addOption({ "mask", "Prim path or pattern to restrict the stage population to (repeatable).", "path" });
+    parser.addOption({ "load", "Payload load policy: all or none.", "policy", "all" });
+    parser.addOption({ "render", "Render the stage to images, # in the path is replaced by the frame.", "image" });
+    parser.addOption({ "camera", "Camera prim to render through, the stage is framed when omitted.", "path" });
+    parser.addOption({ "frames", "Frames to render as start:end or start:end:step.", "range" });
+    parser.addOption({ "resolution", "Rendered image size.", "WIDTHxHEIGHT", "1280x720" });
+    parser.addOption({ "renderer", "Hydra renderer plugin running without a GPU.", "id", "HdEmbreeRendererPlugin" });
+    parser.addOption({ "jobs", "Number of frames rendered concurrently.", "count", "1" });
+    parser.addOption({ "frame-timeout", "Seconds before an unconverged frame fails.", "seconds", "600" });
+    parser.addPositionalArgument("args", "Arguments passed to the script through sys.argv.", "[args...]");
+    parser.process(app);
+
+    const QString stagePath = parser.value("stage");
+    const QString scriptPath = parser.value("script");
+    const QString loadPolicy = parser.value("load");
+    const bool    render = parser.isSet("render");
+
+    if (stagePath.isEmpty() && scriptPath.isEmpty())
+    {
+        qCritical() << "[Batch] Nothing to do, pass --stage and/or --script.";
+        return EXIT_INVALID_ARGUMENTS;
+    }
+
+    BatchRenderOptions renderOptions;
+    if (render)
+    {
+        bool jobsOk = false;
+        bool timeoutOk = false;
+        renderOptions.outputPath = parser.value("render");
+        renderOptions.cameraPath = parser.value("camera");
+        renderOptions.rendererId = parser.value("renderer");
+        renderOptions.jobs = parser.value("jobs").toInt(&jobsOk);
+        renderOptions.frameTimeoutSeconds = parser.value("frame-timeout").toDouble(&timeoutOk);
+
+        if (parser.isSet("frames") && !parseFrameRange(parser.value("frames"), &renderOptions))
+        {
+            qCritical() << "[Batch] Invalid frame range:" << parser.value("frames");
+            return EXIT_INVALID_ARGUMENTS;
+        }
+        if (!parseResolution(parser.value("resolution"), &renderOptions))
+        {
+            qCritical() << "[Batch] Invalid resolution:" << parser.value("resolution");
+            return EXIT_INVALID_ARGUMENTS;
+        }
+        if (!jobsOk || renderOptions.jobs < 1)
+        {
+            qCritical() << "[Batch] Invalid job count:" << parser.value("jobs");
+            return EXIT_INVALID_ARGUMENTS;
+        }
+        if (!timeoutOk || renderOptions.frameTimeoutSeconds <= 0.0)
+        {
+            qCritical() << "[Batch] Invalid frame timeout:" << parser.value("frame-timeout");
+            return EXIT_INVALID_ARGUMENTS;
+        }
+    }
+
+    if (loadPolicy != "all" && loadPolicy != "none")
+    {
+        qCritical() << "[Batch] Invalid load policy:" << loadPolicy;
+        return EXIT_INVALID_ARGUMENTS;
+    }
+
+    // headless runs leave the journals of interactive sessions alone, a crashed session's
+    // edits are recovered by the GUI only
+    UsdDocument document;
+    document.setEditJournalEnabled(false);
+
+    if (!stagePath.isEmpty())
+    {
+        StageOpenOptions options;
+        options.populationMask = parser.values("mask");
+        options.loadPolicy = loadPolicy == "none" ? StageOpenOptions::LoadPolicy::LOAD_NONE
+                                                  : StageOpenOptions::LoadPolicy::LOAD_ALL;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        if (!document.openStage(stagePath, options))
+        {
+            return EXIT_INVALID_ARGUMENTS;
+        }
+
+        qInfo().noquote() << QString("[Batch] Opened %1 in %2 ms").arg(stagePath).arg(timer.elapsed());
+    }
+    else
+    {
+        document.createNewStageInMemory();
+    }
+
+    // the script runs first, so that it can prepare the stage for rendering
+    if (scriptPath.isEmpty())
+    {
+        return render ? runBatchRender(document.getCurrentStage(), renderOptions) : 0;
+    }
+
+    QFile scriptFile(scriptPath);
+    if (!scriptFile.open(QFile::ReadOnly | QFile::Text))
+    {
+        qCritical() << "[Batch] Cannot read script:" << scriptPath;
+        return EXIT_INVALID_ARGUMENTS;
+    }
+    const QString script = QString::fromUtf8(scriptFile.readAll());
+
+    PythonInterpreter& interpreter = PythonInterpreter::instance();
+    interpreter.initialize();
+    interpreter.setArguments(QStringList { scriptPath } + parser.positionalArguments());
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int status = interpreter.run(script, QFileInfo(scriptPath).absoluteFilePath());
+
+    qInfo().noquote()
+        << QString("[Batch] Ran %1 in %2 ms, exit status %3").arg(scriptPath).arg(timer.elapsed()).arg(status);
+
+    interpreter.finalize();
+
+    if (status != 0 || !render)
+    {
+        return status;
+    }
+
+    return runBatchRender(document.getCurrentStage(), renderOptions);
+}
+
+} // namespace TINKERUSD_NS
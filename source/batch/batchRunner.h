@@ -0,0 +1,22 @@
+#pragma once
+
+class QCoreApplication;
+
+namespace TINKERUSD_NS
+{
+
+// returns true when the command line asks for the headless mode (--batch or --no-gui).
+bool isBatchMode(int argc, char** argv);
+
+/*
+Headless entry point: opens a stage through UsdDocument, runs a Python script with the
+embedded interpreter, optionally renders the stage to images with --render, and returns the
+process exit status. No display or GL context is needed, which makes it usable on
+render-farm and CI workers.
+
+Exit status: 0 on success, 1 when the script or a rendered frame fails, 2 for invalid
+arguments or when the stage cannot be opened. A script calling sys.exit(n) exits with n.
+*/
+int runBatch(QCoreApplication& app);
+
+} // namespace TINKERUSD_NS
@@ -0,0 +1,165 @@
+#include "benchmark.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+
+namespace
+{
+// nearest-rank percentile of an ascending sorted sample set.
+double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+double median(const std::vector<double>& sorted)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    const size_t mid = sorted.size() / 2;
+    return (sorted.size() % 2) ? sorted[mid] : 0.5 * (sorted[mid - 1] + sorted[mid]);
+}
+} // namespace
+
+namespace TINKERUSD_NS
+{
+
+BenchmarkResult runBenchmark(const BenchmarkCase& benchmarkCase, int iterations)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<double> samples;
+    samples.reserve(iterations);
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        if (benchmarkCase.setup)
+        {
+            benchmarkCase.setup();
+        }
+
+        const auto start = Clock::now();
+        benchmarkCase.run();
+        const auto end = Clock::now();
+
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    BenchmarkResult result;
+    result.name = benchmarkCase.name;
+    result.iterations = iterations;
+    result.minMs = samples.empty() ? 0.0 : samples.front();
+    result.medianMs = median(samples);
+    result.p95Ms = percentile(samples, 95.0);
+
+    qInfo().noquote() << QString("%1: min %2 ms, median %3 ms, p95 %4 ms")
+                             .arg(result.name)
+                             .arg(result.minMs, 0, 'f', 3)
+                             .arg(result.medianMs, 0, 'f', 3)
+                             .arg(result.p95Ms, 0, 'f', 3);
+    return result;
+}
+
+QJsonObject benchmarkResultsToJson(const std::vector<BenchmarkResult>& results)
+{
+    QJsonArray cases;
+    for (const auto& result : results)
+    {
+        QJsonObject entry;
+        entry["name"] = result.name;
+        entry["iterations"] = result.iterations;
+        entry["min_ms"] = result.minMs;
+        entry["median_ms"] = result.medianMs;
+        entry["p95_ms"] = result.p95Ms;
+        cases.append(entry);
+    }
+
+    QJsonObject root;
+    root["cases"] = cases;
+    return root;
+}
+
+bool writeBenchmarkResults(const QString& filePath, const std::vector<BenchmarkResult>& results)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qCritical() << "Failed to write benchmark results to" << filePath;
+        return false;
+    }
+
+    file.write(QJsonDocument(benchmarkResultsToJson(results)).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+int compareWithBaseline(
+    const QString&                      baselinePath,
+    const std::vector<BenchmarkResult>& results,
+    double                              thresholdPercent)
+{
+    QFile file(baselinePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qCritical() << "Failed to read benchmark baseline" << baselinePath;
+        return -1;
+    }
+
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject())
+    {
+        qCritical() << "Invalid benchmark baseline" << baselinePath;
+        return -1;
+    }
+
+    std::unordered_map<QString, double> baselineMedians;
+    for (const auto& value : doc.object()["cases"].toArray())
+    {
+        const QJsonObject entry = value.toObject();
+        baselineMedians[entry["name"].toString()] = entry["median_ms"].toDouble();
+    }
+
+    int regressions = 0;
+    for (const auto& result : results)
+    {
+        auto it = baselineMedians.find(result.name);
+        if (it == baselineMedians.end())
+        {
+            qInfo().noquote() << QString("%1: no baseline").arg(result.name);
+            continue;
+        }
+
+        const double baseline = it->second;
+        const double change = baseline > 0.0 ? (result.medianMs - baseline) / baseline * 100.0 : 0.0;
+        const bool   regressed = change > thresholdPercent;
+        if (regressed)
+        {
+            ++regressions;
+        }
+
+        qInfo().noquote() << QString("%1: %2 ms -> %3 ms (%4%5%)%6")
+                                 .arg(result.name)
+                                 .arg(baseline, 0, 'f', 3)
+                                 .arg(result.medianMs, 0, 'f', 3)
+                                 .arg(change >= 0.0 ? "+" : "")
+                                 .arg(change, 0, 'f', 1)
+                                 .arg(regressed ? " REGRESSION" : "");
+    }
+    return regressions;
+}
+
+} // namespace TINKERUSD_NS
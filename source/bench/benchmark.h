@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+
+#include <functional>
+#include <vector>
+
+namespace TINKERUSD_NS
+{
+
+// timing summary of one benchmark case, in milliseconds.
+struct BenchmarkResult
+{
+    QString name;
+    int     iterations { 0 };
+    double  minMs { 0.0 };
+    double  medianMs { 0.0 };
+    double  p95Ms { 0.0 };
+};
+
+// a named piece of work to time. setup runs before every iteration and is not timed.
+struct BenchmarkCase
+{
+    QString               name;
+    std::function<void()> setup;
+    std::function<void()> run;
+};
+
+BenchmarkResult runBenchmark(const BenchmarkCase& benchmarkCase, int iterations);
+
+QJsonObject benchmarkResultsToJson(const std::vector<BenchmarkResult>& results);
+
+bool writeBenchmarkResults(const QString& filePath, const std::vector<BenchmarkResult>& results);
+
+// compares the medians against a baseline written by writeBenchmarkResults and
+// reports every case that got slower by more than thresholdPercent.
+// returns the number of regressions, or -1 if the baseline could not be read.
+int compareWithBaseline(
+    const QString&                      baselinePath,
+    const std::vector<BenchmarkResult>& results,
+    double                              thresholdPercent);
+
+} // namespace TINKERUSD_NS
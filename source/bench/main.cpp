@@ -0,0 +1,409 @@
+#include "benchmark.h"
+#include "core/boundsCache.h"
+#include "core/globalSelection.h"
+#include "core/stageCache.h"
+#include "core/usdDocument.h"
+#include "core/utils.h"
+#include "undo/usdEditJournal.h"
+#include "undo/usdUndoManager.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <pxr/usd/sdf/changeBlock.h>
+#include <pxr/usd/usd/primRange.h>
+#include <pxr/usd/usdGeom/cube.h>
+#include <pxr/usd/usdGeom/xform.h>
+#include <pxr/usd/usdGeom/xformCommonAPI.h>
+
+using namespace PXR_NS;
+using namespace TINKERUSD_NS;
+
+namespace
+{
+constexpr int    DEFAULT_ITERATIONS = 10;
+constexpr double DEFAULT_THRESHOLD_PERCENT = 10.0;
+constexpr int    PRIMS_PER_GROUP = 100;
+
+constexpr int EXIT_REGRESSION = 1;
+constexpr int EXIT_INVALID_ARGUMENTS = 2;
+
+// keeps the traversal from being optimized away.
+size_t traversedPrims = 0;
+
+// writes a stage with primCount cubes spread over groups of PRIMS_PER_GROUP transforms.
+bool generateStage(const QString& filePath, int primCount)
+{
+    UsdStageRefPtr stage = UsdStage::CreateNew(filePath.toStdString());
+    if (!stage)
+    {
+        qCritical() << "Failed to create" << filePath;
+        return false;
+    }
+
+    {
+        SdfChangeBlock changeBlock;
+
+        UsdGeomXform world = UsdGeomXform::Define(stage, SdfPath("/World"));
+        stage->SetDefaultPrim(world.GetPrim());
+
+        for (int i = 0; i < primCount; ++i)
+        {
+            const SdfPath groupPath
+                = SdfPath("/World").AppendChild(TfToken(TfStringPrintf("Group_%d", i / PRIMS_PER_GROUP)));
+            if (i % PRIMS_PER_GROUP == 0)
+            {
+                UsdGeomXform::Define(stage, groupPath);
+            }
+
+            UsdGeomCube cube
+                = UsdGeomCube::Define(stage, groupPath.AppendChild(TfToken(TfStringPrintf("Cube_%d", i))));
+            UsdGeomXformCommonAPI(cube).SetTranslate(GfVec3d(i % 100, (i / 100) % 100, i / 10000));
+        }
+    }
+
+    return stage->GetRootLayer()->Save();
+}
+
+// writes a root layer with layerCount sublayers, each of them referencing its own asset layer.
+bool generateLayerTree(const QString& dirPath, int layerCount)
+{
+    SdfLayerRefPtr rootLayer = SdfLayer::CreateNew(QDir(dirPath).filePath("root.usda").toStdString());
+    if (!rootLayer)
+    {
+        qCritical() << "Failed to create layer tree in" << dirPath;
+        return false;
+    }
+
+    for (int i = 0; i < layerCount; ++i)
+    {
+        const std::string assetName = TfStringPrintf("asset_%d.usda", i);
+        const std::string subLayerName = TfStringPrintf("sub_%d.usda", i);
+
+        UsdStageRefPtr asset = UsdStage::CreateNew(QDir(dirPath).filePath(assetName.c_str()).toStdString());
+        UsdGeomCube    cube = UsdGeomCube::Define(asset, SdfPath("/Asset"));
+        asset->SetDefaultPrim(cube.GetPrim());
+
+        UsdStageRefPtr subLayer = UsdStage::CreateNew(QDir(dirPath).filePath(subLayerName.c_str()).toStdString());
+        UsdPrim        prim = subLayer->DefinePrim(SdfPath(TfStringPrintf("/World/Item_%d", i)));
+        prim.GetReferences().AddReference("./" + assetName);
+
+        if (!asset->GetRootLayer()->Save() || !subLayer->GetRootLayer()->Save())
+        {
+            return false;
+        }
+        rootLayer->InsertSubLayerPath("./" + subLayerName);
+    }
+
+    return rootLayer->Save();
+}
+
+// journals the authoring of primCount transformed prims on a new layer.
+SdfLayerRefPtr generateJournal(const QString& dirPath, int primCount, const QString& journalPath)
+{
+    SdfLayerRefPtr layer = SdfLayer::CreateNew(QDir(dirPath).filePath("journal_target.usda").toStdString());
+    if (!layer)
+    {
+        qCritical() << "Failed to create journal target layer in" << dirPath;
+        return nullptr;
+    }
+
+    // the journal records the edits reported by the undo state delegate
+    UsdUndoManager::instance().trackLayerStates(layer);
+
+    auto& journal = UsdEditJournal::instance();
+    if (!journal.start(layer, journalPath.toStdString()))
+    {
+        return nullptr;
+    }
+
+    UsdStageRefPtr stage = UsdStage::Open(layer);
+    for (int i = 0; i < primCount; ++i)
+    {
+        UsdGeomXform xform = UsdGeomXform::Define(stage, SdfPath(TfStringPrintf("/World/Item_%d", i)));
+        xform.AddTranslateOp().Set(GfVec3d(i, 0.0, 0.0));
+    }
+
+    journal.stop(layer->GetIdentifier(), false);
+    return layer;
+}
+
+// replaying the journal on top of the emptied layer it was recorded on.
+void addJournalCases(
+    std::vector<BenchmarkCase>& cases,
+    const SdfLayerRefPtr&       layer,
+    const QString&              journalPath,
+    int                         primCount)
+{
+    cases.push_back({ QString("journalReplay[%1 prims]").arg(primCount),
+                      [layer]() {
+                          // replayed edits must not be journaled again
+                          UsdEditJournal::instance().stopAll(true);
+                          layer->Clear();
+                      },
+                      [journalPath]() { UsdEditJournal::replay(journalPath.toStdString()); } });
+}
+
+// opening the same layer tree with a serial and a parallel prefetch.
+void addPrefetchCases(std::vector<BenchmarkCase>& cases, UsdDocument& document, const QString& rootPath)
+{
+    const auto resetDocument = [&document]() {
+        document.createNewStageInMemory();
+        StageCache::instance().clear();
+    };
+
+    for (const bool parallel : { false, true })
+    {
+        StageOpenOptions options;
+        options.parallelPrefetch = parallel;
+
+        cases.push_back({ QString("openStage[%1, %2 prefetch]")
+                              .arg(QFileInfo(rootPath).dir().dirName(), parallel ? "parallel" : "serial"),
+                          resetDocument,
+                          [&document, rootPath, options]() { document.openStage(rootPath, options); } });
+    }
+}
+
+void addStageCases(std::vector<BenchmarkCase>& cases, UsdDocument& document, const QString& stagePath)
+{
+    const QString label = QFileInfo(stagePath).fileName();
+
+    // the cache is cleared and the current stage released so every iteration re-reads the layers.
+    cases.push_back({ QString("openStage[%1]").arg(label),
+                      [&document]() {
+                          document.createNewStageInMemory();
+                          StageCache::instance().clear();
+                      },
+                      [&document, stagePath]() { document.openStage(stagePath); } });
+
+    const auto ensureOpen = [&document, stagePath]() {
+        UsdStageRefPtr stage = document.getCurrentStage();
+        if (!stage || stage->GetRootLayer() != SdfLayer::Find(stagePath.toStdString()))
+        {
+            document.openStage(stagePath);
+        }
+    };
+
+    cases.push_back({ QString("traverse[%1]").arg(label), ensureOpen, [&document]() {
+                         for (const UsdPrim& prim : UsdPrimRange(document.getCurrentStage()->GetPseudoRoot()))
+                         {
+                             traversedPrims += prim.IsValid();
+                         }
+                     } });
+
+    // the bounds cache is cleared so that the cold computation is measured, the cached
+    // case measures the lookup that selection changes and frame-selected pay afterwards
+    const auto clearBounds = [&document, ensureOpen]() {
+        ensureOpen();
+        BoundsCache::forStage(document.getCurrentStage())->clear();
+    };
+
+    cases.push_back({ QString("stageBbox[%1]").arg(label), clearBounds, [&document]() {
+                         stageBbox(document.getCurrentStage());
+                     } });
+
+    cases.push_back({ QString("stageBboxCached[%1]").arg(label), ensureOpen, [&document]() {
+                         stageBbox(document.getCurrentStage());
+                     } });
+
+    // select the default prim, or the first root prim, so the selection bbox covers most of the stage.
+    const auto selectRoot = [&document, clearBounds]() {
+        clearBounds();
+        UsdStageRefPtr stage = document.getCurrentStage();
+        UsdPrim        prim = stage->GetDefaultPrim();
+        if (!prim)
+        {
+            auto children = stage->GetPseudoRoot().GetChildren();
+            prim = children.empty() ? UsdPrim() : children.front();
+        }
+        GlobalSelection::instance().setPrim(prim);
+    };
+
+    cases.push_back({ QString("globalSelectionBbox[%1]").arg(label), selectRoot, [&document]() {
+                         globalSelectionBbox(document.getCurrentStage());
+                     } });
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("tinkerusd_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("TinkerUsd stage open and traversal benchmarks");
+    parser.addHelpOption();
+    parser.addOption({ "stage", "Benchmark an existing stage. Can be repeated.", "path" });
+    parser.addOption({ "generate",
+                       "Comma separated prim counts of generated stages (default 1000,100000). "
+                       "Pass 0 to skip generated stages.",
+                       "counts",
+                       "1000,100000" });
+    parser.addOption({ "layer-tree",
+                       "Number of sublayers, each with a referenced asset, of a generated layer tree used to "
+                       "compare serial and parallel layer prefetch (default 200). Pass 0 to skip it.",
+                       "count",
+                       "200" });
+    parser.addOption({ "io-delay",
+                       "Artificial latency in milliseconds added to every layer opened before composition.",
+                       "ms",
+                       "0" });
+    parser.addOption({ "journal-prims",
+                       "Number of prims authored into an edit journal whose replay is measured (default 10000). "
+                       "Pass 0 to skip it.",
+                       "count",
+                       "10000" });
+    parser.addOption(
+        { "iterations", "Number of timed iterations per case.", "count", QString::number(DEFAULT_ITERATIONS) });
+    parser.addOption({ "output", "Write the results as JSON to this file.", "path" });
+    parser.addOption({ "baseline", "Compare the results against a previous JSON output.", "path" });
+    parser.addOption({ "threshold",
+                       "Median slowdown in percent that counts as a regression.",
+                       "percent",
+                       QString::number(DEFAULT_THRESHOLD_PERCENT) });
+    parser.process(app);
+
+    bool      ok = true;
+    const int iterations = parser.value("iterations").toInt(&ok);
+    if (!ok || iterations <= 0)
+    {
+        qCritical() << "Invalid --iterations value" << parser.value("iterations");
+        return EXIT_INVALID_ARGUMENTS;
+    }
+
+    const double threshold = parser.value("threshold").toDouble(&ok);
+    if (!ok || threshold < 0.0)
+    {
+        qCritical() << "Invalid --threshold value" << parser.value("threshold");
+        return EXIT_INVALID_ARGUMENTS;
+    }
+
+    const int ioDelay = parser.value("io-delay").toInt(&ok);
+    if (!ok || ioDelay < 0)
+    {
+        qCritical() << "Invalid --io-delay value" << parser.value("io-delay");
+        return EXIT_INVALID_ARGUMENTS;
+    }
+    // read by UsdDocument the first time a layer is opened. A delay set in the environment is
+    // kept unless the option is given.
+    if (parser.isSet("io-delay"))
+    {
+        qputenv("TINKERUSD_LAYER_OPEN_DELAY_MS", QByteArray::number(ioDelay));
+    }
+
+    const int layerTreeSize = parser.value("layer-tree").toInt(&ok);
+    if (!ok || layerTreeSize < 0)
+    {
+        qCritical() << "Invalid --layer-tree value" << parser.value("layer-tree");
+        return EXIT_INVALID_ARGUMENTS;
+    }
+
+    const int journalPrims = parser.value("journal-prims").toInt(&ok);
+    if (!ok || journalPrims < 0)
+    {
+        qCritical() << "Invalid --journal-prims value" << parser.value("journal-prims");
+        return EXIT_INVALID_ARGUMENTS;
+    }
+
+    QStringList stagePaths = parser.values("stage");
+
+    QTemporaryDir tempDir;
+    for (const QString& value : parser.value("generate").split(',', Qt::SkipEmptyParts))
+    {
+        const int primCount = value.trimmed().toInt(&ok);
+        if (!ok || primCount < 0)
+        {
+            qCritical() << "Invalid --generate value" << value;
+            return EXIT_INVALID_ARGUMENTS;
+        }
+        if (primCount == 0)
+        {
+            continue;
+        }
+
+        const QString filePath = tempDir.filePath(QString("generated_%1.usdc").arg(primCount));
+        if (!generateStage(filePath, primCount))
+        {
+            return EXIT_INVALID_ARGUMENTS;
+        }
+        stagePaths.append(filePath);
+    }
+
+    QString layerTreeRoot;
+    if (layerTreeSize > 0)
+    {
+        const QString dirPath = tempDir.filePath(QString("layer_tree_%1").arg(layerTreeSize));
+        if (!QDir().mkpath(dirPath) || !generateLayerTree(dirPath, layerTreeSize))
+        {
+            return EXIT_INVALID_ARGUMENTS;
+        }
+        layerTreeRoot = QDir(dirPath).filePath("root.usda");
+    }
+
+    if (stagePaths.isEmpty() && layerTreeRoot.isEmpty() && journalPrims == 0)
+    {
+        qCritical() << "Nothing to benchmark. Use --stage, --generate, --layer-tree or --journal-prims.";
+        return EXIT_INVALID_ARGUMENTS;
+    }
+
+    // opens measure composition only, and must not take over the journals of an interactive session
+    UsdDocument document;
+    document.setEditJournalEnabled(false);
+
+    std::vector<BenchmarkCase> cases;
+    for (const QString& stagePath : stagePaths)
+    {
+        if (!QFileInfo::exists(stagePath))
+        {
+            qCritical() << "Stage does not exist:" << stagePath;
+            return EXIT_INVALID_ARGUMENTS;
+        }
+        addStageCases(cases, document, stagePath);
+    }
+    if (!layerTreeRoot.isEmpty())
+    {
+        addPrefetchCases(cases, document, layerTreeRoot);
+    }
+
+    SdfLayerRefPtr journalLayer;
+    if (journalPrims > 0)
+    {
+        const QString journalPath = tempDir.filePath("edits.journal");
+        journalLayer = generateJournal(tempDir.path(), journalPrims, journalPath);
+        if (!journalLayer)
+        {
+            return EXIT_INVALID_ARGUMENTS;
+        }
+        addJournalCases(cases, journalLayer, journalPath, journalPrims);
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (const auto& benchmarkCase : cases)
+    {
+        results.push_back(runBenchmark(benchmarkCase, iterations));
+    }
+
+    if (parser.isSet("output") && !writeBenchmarkResults(parser.value("output"), results))
+    {
+        return EXIT_INVALID_ARGUMENTS;
+    }
+
+    if (parser.isSet("baseline"))
+    {
+        const int regressions = compareWithBaseline(parser.value("baseline"), results, threshold);
+        if (regressions < 0)
+        {
+            return EXIT_INVALID_ARGUMENTS;
+        }
+        if (regressions > 0)
+        {
+            qWarning() << regressions << "benchmark(s) regressed by more than" << threshold << "%";
+            return EXIT_REGRESSION;
+        }
+    }
+
+    return 0;
+}
@@ -1,8 +1,9 @@
 #include "usdCamera.h"
 
+#include "core/boundsCache.h"
+
 #include <pxr/base/gf/frustum.h>
 #include <pxr/imaging/cameraUtil/framing.h>
-#include <pxr/usd/usdGeom/bboxCache.h>
 #include <pxr/usd/usdGeom/metrics.h>
 
 #define PI 3.14159265358979323846f
@@ -28,8 +29,7 @@ void UsdCamera::initialize()
     m_rotPsi = 0;
     m_aspectRatio = 1.0;
 
-    UsdGeomBBoxCache bboxCache(UsdTimeCode::Default(), UsdGeomImageable::GetOrderedPurposeTokens());
-    setBoundingBox(bboxCache.ComputeWorldBound(m_stage->GetPseudoRoot()));
+    setBoundingBox(BoundsCache::forStage(m_stage)->worldBound(m_stage->GetPseudoRoot()));
 
     m_camera.SetPerspectiveFromAspectRatioAndFieldOfView(m_aspectRatio, m_fov, GfCamera::FOVVertical);
     m_camera.SetFocusDistance(m_distance);
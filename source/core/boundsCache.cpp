@@ -0,0 +1,551 @@
+#include "boundsCache.h"
+
+#include <pxr/base/tf/stringUtils.h>
+#include <pxr/base/work/loops.h>
+#include <pxr/usd/usd/primRange.h>
+#include <pxr/usd/usdGeom/boundable.h>
+#include <pxr/usd/usdGeom/imageable.h>
+#include <pxr/usd/usdGeom/pointInstancer.h>
+#include <pxr/usd/usdGeom/tokens.h>
+#include <pxr/usd/usdGeom/xformable.h>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace PXR_NS;
+
+namespace TINKERUSD_NS
+{
+
+namespace
+{
+// namespaces of properties that never contribute to the bounds of a prim. inputs: is not one
+// of them, UsdLux lights are sized by their inputs.
+const std::vector<std::string> BOUNDS_NEUTRAL_NAMESPACES = {
+    "primvars:", "material:", "outputs:", "ui:", "info:", "collection:", "userProperties:",
+};
+
+struct Entry
+{
+    UsdStageWeakPtr              stage;
+    std::shared_ptr<BoundsCache> cache;
+};
+
+std::mutex                                 s_registryMutex;
+std::unordered_map<const UsdStage*, Entry> s_registry;
+} // namespace
+
+std::shared_ptr<BoundsCache> BoundsCache::forStage(const UsdStageRefPtr& stage)
+{
+    if (!stage)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+
+    // drop the caches of stages that went away, their address may be reused
+    for (auto it = s_registry.begin(); it != s_registry.end();)
+    {
+        it = it->second.stage ? std::next(it) : s_registry.erase(it);
+    }
+
+    Entry& entry = s_registry[get_pointer(stage)];
+    if (!entry.cache)
+    {
+        entry.stage = stage;
+        entry.cache.reset(new BoundsCache(stage));
+    }
+    return entry.cache;
+}
+
+BoundsCache::BoundsCache(const UsdStageRefPtr& stage)
+    : m_stage(stage)
+    , m_xformCache(UsdTimeCode::Default())
+{
+    // indexed up front, the first edit must not pay for a traversal of the stage
+    indexInstancers(SdfPath::AbsoluteRootPath());
+
+    TfWeakPtr<BoundsCache> me(this);
+    m_objectsChangedKey = TfNotice::Register(me, &BoundsCache::onObjectsChanged, m_stage);
+}
+
+BoundsCache::~BoundsCache() { TfNotice::Revoke(m_objectsChangedKey); }
+
+void BoundsCache::setTime(UsdTimeCode time)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (time == m_time)
+    {
+        return;
+    }
+
+    m_time = time;
+    for (auto& [path, cache] : m_bboxCaches)
+    {
+        cache->SetTime(time);
+    }
+    m_xformCache.SetTime(time);
+    m_worldBounds.clear();
+}
+
+UsdTimeCode BoundsCache::time() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_time;
+}
+
+GfBBox3d BoundsCache::worldBound(const UsdPrim& prim)
+{
+    if (!prim.IsValid())
+    {
+        return GfBBox3d();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return computeWorldBound(prim);
+}
+
+GfBBox3d BoundsCache::worldBound(const SdfPathSet& paths)
+{
+    if (!m_stage)
+    {
+        return GfBBox3d();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // descendants directly follow their ancestor in the sorted set, and are already
+    // covered by its bound
+    GfBBox3d bbox;
+    SdfPath  coveredPath;
+    for (const auto& path : paths)
+    {
+        if (!coveredPath.IsEmpty() && path.HasPrefix(coveredPath))
+        {
+            continue;
+        }
+
+        const UsdPrim prim = m_stage->GetPrimAtPath(path);
+        if (!prim.IsValid())
+        {
+            continue;
+        }
+
+        coveredPath = path;
+        bbox = GfBBox3d::Combine(bbox, computeWorldBound(prim));
+    }
+    return bbox;
+}
+
+GfMatrix4d BoundsCache::localToWorldTransform(const UsdPrim& prim)
+{
+    if (!prim.IsValid())
+    {
+        return GfMatrix4d(1.0);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return computeLocalToWorld(prim);
+}
+
+bool BoundsCache::isAffectedBy(const TfToken& propertyName)
+{
+    const std::string& name = propertyName.GetString();
+    for (const auto& ns : BOUNDS_NEUTRAL_NAMESPACES)
+    {
+        if (TfStringStartsWith(name, ns))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BoundsCache::warmUp()
+{
+    if (!m_stage)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<UsdPrim> subtrees;
+    collectSubtrees(m_stage->GetPseudoRoot(), subtrees);
+
+    // the transforms and caches are looked up serially, every cache is then used by one task
+    std::vector<UsdGeomBBoxCache*> caches;
+    std::vector<GfMatrix4d>        transforms;
+    for (const auto& prim : subtrees)
+    {
+        caches.push_back(&bboxCacheFor(prim.GetPath()));
+        transforms.push_back(computeLocalToWorld(prim));
+    }
+
+    std::vector<GfBBox3d> bounds(subtrees.size());
+    WorkParallelForN(subtrees.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            bounds[i] = caches[i]->ComputeUntransformedBound(subtrees[i]);
+            bounds[i].Transform(transforms[i]);
+        }
+    });
+
+    m_misses += subtrees.size();
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+        m_worldBounds.emplace(subtrees[i].GetPath(), bounds[i]);
+    }
+
+    computeWorldBound(m_stage->GetPseudoRoot());
+}
+
+void BoundsCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_worldBounds.clear();
+    m_bboxCaches.clear();
+    m_staleBBoxCaches.clear();
+    m_xformCache.Clear();
+    m_xformCacheStale = false;
+}
+
+size_t BoundsCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+size_t BoundsCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
+
+GfBBox3d BoundsCache::computeWorldBound(const UsdPrim& prim)
+{
+    const auto it = m_worldBounds.find(prim.GetPath());
+    if (it != m_worldBounds.end())
+    {
+        ++m_hits;
+        return it->second;
+    }
+
+    ++m_misses;
+
+    GfBBox3d bbox;
+    if (isCombined(prim))
+    {
+        for (const auto& child : prim.GetChildren())
+        {
+            bbox = GfBBox3d::Combine(bbox, computeWorldBound(child));
+        }
+    }
+    else
+    {
+        bbox = bboxCacheFor(prim.GetPath()).ComputeUntransformedBound(prim);
+        bbox.Transform(computeLocalToWorld(prim));
+    }
+
+    m_worldBounds.emplace(prim.GetPath(), bbox);
+    return bbox;
+}
+
+GfMatrix4d BoundsCache::computeLocalToWorld(const UsdPrim& prim)
+{
+    if (m_xformCacheStale)
+    {
+        m_xformCache.Clear();
+        m_xformCacheStale = false;
+    }
+    return m_xformCache.GetLocalToWorldTransform(prim);
+}
+
+bool BoundsCache::isCombined(const UsdPrim& prim) const
+{
+    if (prim.IsPseudoRoot())
+    {
+        return true;
+    }
+    if (prim.GetPath().GetPathElementCount() >= PARTITION_DEPTH)
+    {
+        return false;
+    }
+
+    // the bound of a visible group is the union of its children's bounds. Anything
+    // UsdGeomBBoxCache treats differently is left to it.
+    if (prim.IsInstance() || prim.IsA<UsdGeomBoundable>())
+    {
+        return false;
+    }
+    if (!prim.IsA<UsdGeomImageable>())
+    {
+        return prim.GetTypeName().IsEmpty();
+    }
+    return UsdGeomImageable(prim).ComputeVisibility(m_time) != UsdGeomTokens->invisible;
+}
+
+UsdGeomBBoxCache& BoundsCache::bboxCacheFor(const SdfPath& primPath)
+{
+    SdfPath root = primPath;
+    while (root.GetPathElementCount() > PARTITION_DEPTH)
+    {
+        root = root.GetParentPath();
+    }
+
+    auto& cache = m_bboxCaches[root];
+    if (!cache)
+    {
+        cache = std::make_unique<UsdGeomBBoxCache>(m_time, UsdGeomImageable::GetOrderedPurposeTokens());
+    }
+    if (m_staleBBoxCaches.erase(root))
+    {
+        cache->Clear();
+    }
+    return *cache;
+}
+
+void BoundsCache::collectSubtrees(const UsdPrim& prim, std::vector<UsdPrim>& subtrees) const
+{
+    if (m_worldBounds.count(prim.GetPath()))
+    {
+        return;
+    }
+
+    if (!isCombined(prim))
+    {
+        subtrees.push_back(prim);
+        return;
+    }
+
+    for (const auto& child : prim.GetChildren())
+    {
+        collectSubtrees(child, subtrees);
+    }
+}
+
+void BoundsCache::onObjectsChanged(const UsdNotice::ObjectsChanged& notice, const UsdStageWeakPtr& sender)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // the instancers index is kept up to date with the resynced prims and the prototypes
+    // relationships that changed
+    std::vector<std::pair<SdfPath, bool>> changedPrims; // prim path, transform only
+    for (const auto& path : notice.GetResyncedPaths())
+    {
+        indexInstancers(path.GetPrimPath());
+        changedPrims.emplace_back(path.GetPrimPath(), false);
+        m_xformCacheStale = true;
+    }
+
+    // metadata changes on the prims themselves, e.g. kind or documentation, do not move bounds
+    for (const auto& path : notice.GetChangedInfoOnlyPaths())
+    {
+        if (!path.IsPropertyPath() || !isAffectedBy(path.GetNameToken()))
+        {
+            continue;
+        }
+
+        if (path.GetNameToken() == UsdGeomTokens->prototypes)
+        {
+            indexInstancers(path.GetPrimPath());
+        }
+
+        const bool transformOnly = UsdGeomXformable::IsTransformationAffectedByAttrNamed(path.GetNameToken());
+        if (transformOnly)
+        {
+            m_xformCacheStale = true;
+        }
+        changedPrims.emplace_back(path.GetPrimPath(), transformOnly);
+    }
+
+    for (const auto& [path, transformOnly] : changedPrims)
+    {
+        invalidate(path, transformOnly);
+    }
+}
+
+void BoundsCache::invalidate(const SdfPath& primPath, bool transformOnly)
+{
+    // instances and instancers depending on the prim change shape, not only place
+    std::vector<SdfPath> pending { primPath };
+    std::set<SdfPath>    visited;
+    while (!pending.empty())
+    {
+        const SdfPath path = pending.back();
+        pending.pop_back();
+        if (!visited.insert(path).second)
+        {
+            continue;
+        }
+
+        dropEntries(path);
+        markBBoxCachesStale(path, transformOnly && path == primPath);
+        if (path.IsAbsoluteRootPath())
+        {
+            continue;
+        }
+
+        // instances share the bounds of their prototype, which is a root prim
+        SdfPath rootPath = path;
+        while (rootPath.GetParentPath() != SdfPath::AbsoluteRootPath())
+        {
+            rootPath = rootPath.GetParentPath();
+        }
+        const UsdPrim root = m_stage->GetPrimAtPath(rootPath);
+        if (root && root.IsPrototype())
+        {
+            for (const auto& instance : root.GetInstances())
+            {
+                pending.push_back(instance.GetPath());
+            }
+        }
+
+        // point instancers are bounded by the prototypes they place
+        collectInstancers(path, pending);
+    }
+}
+
+void BoundsCache::collectInstancers(const SdfPath& path, std::vector<SdfPath>& instancers) const
+{
+    if (m_prototypeInstancers.empty())
+    {
+        return;
+    }
+
+    // prototypes at or above the path
+    for (SdfPath prototype = path; !prototype.IsAbsoluteRootPath(); prototype = prototype.GetParentPath())
+    {
+        const auto it = m_prototypeInstancers.find(prototype);
+        if (it != m_prototypeInstancers.end())
+        {
+            instancers.insert(instancers.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    // prototypes below the path directly follow it in path order
+    for (auto it = m_prototypeInstancers.upper_bound(path);
+         it != m_prototypeInstancers.end() && it->first.HasPrefix(path);
+         ++it)
+    {
+        instancers.insert(instancers.end(), it->second.begin(), it->second.end());
+    }
+}
+
+void BoundsCache::dropEntries(const SdfPath& primPath)
+{
+    for (SdfPath path = primPath; !path.IsEmpty(); path = path.GetParentPath())
+    {
+        m_worldBounds.erase(path);
+    }
+
+    // descendants directly follow the prim in path order
+    for (auto it = m_worldBounds.lower_bound(primPath); it != m_worldBounds.end() && it->first.HasPrefix(primPath);)
+    {
+        it = m_worldBounds.erase(it);
+    }
+}
+
+void BoundsCache::markBBoxCachesStale(const SdfPath& primPath, bool transformOnly)
+{
+    // the caches of the subtrees containing the prim hold bounds that include its transform,
+    // the subtree rooted at the prim holds its bounds without it
+    const SdfPath first = transformOnly ? primPath.GetParentPath() : primPath;
+    for (SdfPath path = first; !path.IsEmpty(); path = path.GetParentPath())
+    {
+        if (m_bboxCaches.count(path))
+        {
+            m_staleBBoxCaches.insert(path);
+        }
+    }
+
+    // bounds below the prim are computed in their own space, only its content can move them
+    if (transformOnly)
+    {
+        return;
+    }
+
+    for (auto it = m_bboxCaches.upper_bound(primPath); it != m_bboxCaches.end() && it->first.HasPrefix(primPath);
+         ++it)
+    {
+        m_staleBBoxCaches.insert(it->first);
+    }
+}
+
+void BoundsCache::indexInstancers(const SdfPath& primPath)
+{
+    std::vector<SdfPath> removed;
+    for (auto it = m_instancerPrototypes.lower_bound(primPath);
+         it != m_instancerPrototypes.end() && it->first.HasPrefix(primPath);
+         ++it)
+    {
+        removed.push_back(it->first);
+    }
+    for (const auto& instancer : removed)
+    {
+        removeInstancer(instancer);
+    }
+
+    auto indexRange = [this](const UsdPrimRange& range) {
+        for (const auto& prim : range)
+        {
+            if (prim.IsA<UsdGeomPointInstancer>())
+            {
+                SdfPathVector prototypes;
+                UsdGeomPointInstancer(prim).GetPrototypesRel().GetForwardedTargets(&prototypes);
+                for (const auto& prototype : prototypes)
+                {
+                    m_prototypeInstancers[prototype].insert(prim.GetPath());
+                }
+                m_instancerPrototypes[prim.GetPath()] = std::move(prototypes);
+            }
+        }
+    };
+
+    if (!m_stage)
+    {
+        return;
+    }
+
+    if (primPath.IsAbsoluteRootPath())
+    {
+        indexRange(m_stage->Traverse());
+        for (const auto& prototype : m_stage->GetPrototypes())
+        {
+            indexRange(UsdPrimRange(prototype));
+        }
+    }
+    else if (const UsdPrim prim = m_stage->GetPrimAtPath(primPath))
+    {
+        indexRange(UsdPrimRange(prim));
+    }
+}
+
+void BoundsCache::removeInstancer(const SdfPath& instancerPath)
+{
+    const auto it = m_instancerPrototypes.find(instancerPath);
+    if (it == m_instancerPrototypes.end())
+    {
+        return;
+    }
+
+    for (const auto& prototype : it->second)
+    {
+        const auto reverse = m_prototypeInstancers.find(prototype);
+        if (reverse != m_prototypeInstancers.end())
+        {
+            reverse->second.erase(instancerPath);
+            if (reverse->second.empty())
+            {
+                m_prototypeInstancers.erase(reverse);
+            }
+        }
+    }
+    m_instancerPrototypes.erase(it);
+}
+
+} // namespace TINKERUSD_NS
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "utils.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <pxr/base/gf/bbox3d.h>
+#include <pxr/base/gf/matrix4d.h>
+#include <pxr/base/tf/notice.h>
+#include <pxr/base/tf/weakBase.h>
+#include <pxr/usd/usd/notice.h>
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usdGeom/bboxCache.h>
+#include <pxr/usd/usdGeom/xformCache.h>
+#include <set>
+#include <vector>
+
+namespace TINKERUSD_NS
+{
+
+/*
+Long-lived world bounds and transforms of the prims of a stage, shared by the camera,
+the viewport and any tool that needs bounds.
+
+World bounds are kept per queried prim until a UsdNotice::ObjectsChanged names a change
+that can move them. Only the entries of the changed prim, its ancestors and its
+descendants are dropped then; edits to properties that do not contribute to bounds,
+e.g. primvars or material bindings, keep every entry. A change inside an instancing
+prototype also drops the entries of the instances sharing it, and a change to a point
+instancer prototype the entries of the instancers using it.
+
+UsdGeomBBoxCache cannot drop single entries. The stage is therefore split into subtrees
+rooted PARTITION_DEPTH levels below the pseudo-root, e.g. /World/Asset, each with a
+UsdGeomBBoxCache of its own. Bounds above them are combined from the bounds of their
+children. The caches hold bounds without the transform of the queried prim, which comes
+from a shared UsdGeomXformCache, so moving a subtree root only clears the transforms.
+An edit elsewhere clears the caches of the subtrees containing it or below it.
+
+There is one cache per stage, alive for as long as the stage is. The point instancers of
+the stage are indexed when the cache is created, i.e. by the worker thread of an
+asynchronous open or by the first query after a synchronous one.
+*/
+class BoundsCache : public PXR_NS::TfWeakBase
+{
+public:
+    static std::shared_ptr<BoundsCache> forStage(const PXR_NS::UsdStageRefPtr& stage);
+
+    DISALLOW_COPY_MOVE_ASSIGNMENT(BoundsCache);
+
+    ~BoundsCache();
+
+    // bounds are computed at this time, changing it drops every entry.
+    void                setTime(PXR_NS::UsdTimeCode time);
+    PXR_NS::UsdTimeCode time() const;
+
+    PXR_NS::GfBBox3d worldBound(const PXR_NS::UsdPrim& prim);
+
+    PXR_NS::GfMatrix4d localToWorldTransform(const PXR_NS::UsdPrim& prim);
+
+    // combined world bounds of the prims, descendants of a listed prim are skipped.
+    PXR_NS::GfBBox3d worldBound(const PXR_NS::SdfPathSet& paths);
+
+    // whether a change to the property can move the bounds of its prim.
+    static bool isAffectedBy(const PXR_NS::TfToken& propertyName);
+
+    // computes the bounds of the whole stage. The subtrees are computed in parallel, each
+    // UsdGeomBBoxCache caches every prim's bound along the way.
+    void warmUp();
+
+    void clear();
+
+    size_t hits() const;
+    size_t misses() const;
+
+private:
+    explicit BoundsCache(const PXR_NS::UsdStageRefPtr& stage);
+
+    void onObjectsChanged(const PXR_NS::UsdNotice::ObjectsChanged& notice, const PXR_NS::UsdStageWeakPtr& sender);
+
+    // drops the cached bounds of the prim, its ancestors and its descendants, and of the
+    // instances and point instancers depending on it. A change to the transform of the prim
+    // leaves the bounds computed in its own space and below it valid.
+    void invalidate(const PXR_NS::SdfPath& primPath, bool transformOnly);
+    void dropEntries(const PXR_NS::SdfPath& primPath);
+    void markBBoxCachesStale(const PXR_NS::SdfPath& primPath, bool transformOnly);
+
+    // records the prototypes of the point instancers at and below the prim.
+    void indexInstancers(const PXR_NS::SdfPath& primPath);
+    void removeInstancer(const PXR_NS::SdfPath& instancerPath);
+
+    // point instancers placing a prototype at, above or below the path.
+    void collectInstancers(const PXR_NS::SdfPath& path, std::vector<PXR_NS::SdfPath>& instancers) const;
+
+    PXR_NS::GfBBox3d   computeWorldBound(const PXR_NS::UsdPrim& prim);
+    PXR_NS::GfMatrix4d computeLocalToWorld(const PXR_NS::UsdPrim& prim);
+
+    // whether the bound of the prim is combined from its children rather than computed by
+    // the UsdGeomBBoxCache of its subtree.
+    bool isCombined(const PXR_NS::UsdPrim& prim) const;
+
+    // the cache of the subtree the prim belongs to, cleared first when an edit made it stale.
+    PXR_NS::UsdGeomBBoxCache& bboxCacheFor(const PXR_NS::SdfPath& primPath);
+
+    // the prims whose bounds come from a UsdGeomBBoxCache and that make up the bound of the prim.
+    void collectSubtrees(const PXR_NS::UsdPrim& prim, std::vector<PXR_NS::UsdPrim>& subtrees) const;
+
+    static constexpr size_t PARTITION_DEPTH { 2 };
+
+private:
+    mutable std::mutex                          m_mutex;
+    PXR_NS::UsdStageWeakPtr                     m_stage;
+    PXR_NS::UsdTimeCode                         m_time { PXR_NS::UsdTimeCode::Default() };
+    std::map<PXR_NS::SdfPath, PXR_NS::GfBBox3d> m_worldBounds;
+
+    // one cache per subtree root, see the class description
+    std::map<PXR_NS::SdfPath, std::unique_ptr<PXR_NS::UsdGeomBBoxCache>> m_bboxCaches;
+    std::set<PXR_NS::SdfPath>                                            m_staleBBoxCaches;
+
+    // UsdGeomXformCache cannot drop single entries either, it is cleared on the next query
+    // after a transform changed
+    PXR_NS::UsdGeomXformCache m_xformCache;
+    bool                      m_xformCacheStale { false };
+
+    // point instancers and their prototypes, these may live anywhere in the stage. The reverse
+    // map finds the instancers of a changed path without visiting every instancer.
+    std::map<PXR_NS::SdfPath, PXR_NS::SdfPathVector>     m_instancerPrototypes;
+    std::map<PXR_NS::SdfPath, std::set<PXR_NS::SdfPath>> m_prototypeInstancers;
+
+    size_t                                      m_hits { 0 };
+    size_t                                      m_misses { 0 };
+    PXR_NS::TfNotice::Key                       m_objectsChangedKey;
+};
+
+} // namespace TINKERUSD_NS
@@ -11,35 +11,147 @@ GlobalSelection& GlobalSelection::instance()
     return instance;
 }
 
+GlobalSelection::Block::Block() { ++GlobalSelection::instance().m_blockDepth; }
+
+GlobalSelection::Block::~Block()
+{
+    auto& selection = GlobalSelection::instance();
+    if (--selection.m_blockDepth == 0 && selection.m_changed)
+    {
+        selection.markChanged();
+    }
+}
+
 void GlobalSelection::setPrim(const UsdPrim& prim)
 {
-    if (prim == m_selectedPrim)
+    if (!prim.IsValid())
     {
+        clearSelection();
         return;
     }
 
-    m_selectedPrim = prim;
+    replace({ prim.GetPath() });
+}
 
-    // notify observers
-    emit selectionChanged(m_selectedPrim);
+void GlobalSelection::clearSelection()
+{
+    if (m_paths.empty())
+    {
+        return;
+    }
+
+    m_paths.clear();
+    m_leadPath = SdfPath();
+
+    markChanged();
+}
+
+void GlobalSelection::replace(const SdfPathVector& paths)
+{
+    SdfPathSet newPaths(paths.begin(), paths.end());
+    const SdfPath newLeadPath = paths.empty() ? SdfPath() : paths.back();
+    if (newPaths == m_paths && newLeadPath == m_leadPath)
+    {
+        return;
+    }
+
+    m_paths = std::move(newPaths);
+    m_leadPath = newLeadPath;
+
+    markChanged();
 }
 
-UsdPrim GlobalSelection::prim() const { return m_selectedPrim; }
+void GlobalSelection::add(const SdfPathVector& paths)
+{
+    bool changed = false;
+    for (const auto& path : paths)
+    {
+        changed |= m_paths.insert(path).second;
+    }
 
-SdfPath GlobalSelection::path() const { return m_selectedPrim ? m_selectedPrim.GetPath() : SdfPath(); }
+    if (!changed)
+    {
+        return;
+    }
 
-void GlobalSelection::clearSelection()
+    m_leadPath = paths.back();
+
+    markChanged();
+}
+
+void GlobalSelection::remove(const SdfPathVector& paths)
+{
+    bool changed = false;
+    for (const auto& path : paths)
+    {
+        changed |= m_paths.erase(path) > 0;
+    }
+
+    if (!changed)
+    {
+        return;
+    }
+
+    if (!m_paths.count(m_leadPath))
+    {
+        m_leadPath = m_paths.empty() ? SdfPath() : *m_paths.rbegin();
+    }
+
+    markChanged();
+}
+
+void GlobalSelection::toggle(const SdfPathVector& paths)
+{
+    if (paths.empty())
+    {
+        return;
+    }
+
+    for (const auto& path : paths)
+    {
+        if (m_paths.erase(path) == 0)
+        {
+            m_paths.insert(path);
+            m_leadPath = path;
+        }
+    }
+
+    if (!m_paths.count(m_leadPath))
+    {
+        m_leadPath = m_paths.empty() ? SdfPath() : *m_paths.rbegin();
+    }
+
+    markChanged();
+}
+
+const SdfPathSet& GlobalSelection::paths() const { return m_paths; }
+
+bool GlobalSelection::isSelected(const SdfPath& path) const { return m_paths.count(path) > 0; }
+
+bool GlobalSelection::isEmpty() const { return m_paths.empty(); }
+
+size_t GlobalSelection::size() const { return m_paths.size(); }
+
+UsdPrim GlobalSelection::prim() const
+{
+    const UsdStageRefPtr stage = currentStage();
+    return stage && !m_leadPath.IsEmpty() ? stage->GetPrimAtPath(m_leadPath) : UsdPrim();
+}
+
+SdfPath GlobalSelection::path() const { return m_leadPath; }
+
+void GlobalSelection::markChanged()
 {
-    if (!m_selectedPrim.IsValid())
+    if (m_blockDepth > 0)
     {
+        m_changed = true;
         return;
     }
 
-    // invalidate the prim
-    m_selectedPrim = UsdPrim();
+    m_changed = false;
 
     // notify observers
-    emit selectionChanged(m_selectedPrim);
+    emit selectionChanged(prim());
 }
 
 } // namespace TINKERUSD_NS
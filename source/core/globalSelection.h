@@ -1,5 +1,7 @@
 #pragma once
 
+#include "utils.h"
+
 #include <QObject>
 #include <pxr/usd/sdf/path.h>
 #include <pxr/usd/usd/prim.h>
@@ -7,25 +9,66 @@
 namespace TINKERUSD_NS
 {
 
+/*
+Set of selected prim paths of the current stage.
+
+Every operation notifies observers with a single selectionChanged, however many
+paths it touches. Operations made while a GlobalSelection::Block is alive are
+coalesced into one notification sent when the outermost block closes.
+
+The lead path is the most recently selected one, panels that show a single prim
+follow it.
+*/
 class GlobalSelection : public QObject
 {
     Q_OBJECT
 public:
     static GlobalSelection& instance();
 
+    DISALLOW_COPY_MOVE_ASSIGNMENT(GlobalSelection);
+
+    // collects the selection changes made during its lifetime into one notification.
+    class Block
+    {
+    public:
+        Block();
+        ~Block();
+
+        DISALLOW_COPY_MOVE_ASSIGNMENT(Block);
+    };
+
+    // replaces the selection with a single prim.
     void setPrim(const PXR_NS::UsdPrim& prim);
     void clearSelection();
 
+    void replace(const PXR_NS::SdfPathVector& paths);
+    void add(const PXR_NS::SdfPathVector& paths);
+    void remove(const PXR_NS::SdfPathVector& paths);
+    void toggle(const PXR_NS::SdfPathVector& paths);
+
+    const PXR_NS::SdfPathSet& paths() const;
+
+    bool   isSelected(const PXR_NS::SdfPath& path) const;
+    bool   isEmpty() const;
+    size_t size() const;
+
+    // lead prim and path.
     PXR_NS::UsdPrim prim() const;
     PXR_NS::SdfPath path() const;
 
 signals:
-    void selectionChanged(const PXR_NS::UsdPrim& selectedPrim);
+    void selectionChanged(const PXR_NS::UsdPrim& leadPrim);
 
 private:
     GlobalSelection() = default;
 
-    PXR_NS::UsdPrim m_selectedPrim;
+    void markChanged();
+
+private:
+    PXR_NS::SdfPathSet m_paths;
+    PXR_NS::SdfPath    m_leadPath;
+    int                m_blockDepth { 0 };
+    bool               m_changed { false };
 };
 
 } // namespace TINKERUSD_NS
@@ -0,0 +1,309 @@
+#include "layerSaver.h"
+
+#include "undo/usdUndoManager.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <pxr/base/tf/stringUtils.h>
+#include <pxr/base/work/loops.h>
+#include <pxr/usd/sdf/fileFormat.h>
+#include <pxr/usd/sdf/usdFileFormat.h>
+#include <pxr/usd/usdUtils/dependencies.h>
+
+namespace
+{
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// .usd layers are written in the format they were read in, unless the arguments say otherwise.
+PXR_NS::SdfLayer::FileFormatArguments writeArguments(const PXR_NS::SdfLayerHandle& layer)
+{
+    PXR_NS::SdfLayer::FileFormatArguments args = layer->GetFileFormatArguments();
+    if (layer->GetFileFormat()->GetFormatId() == PXR_NS::SdfUsdFileFormatTokens->Id && !args.count("format"))
+    {
+        args["format"] = PXR_NS::SdfUsdFileFormat::GetUnderlyingFormatForLayer(*layer).GetString();
+    }
+    return args;
+}
+
+// copies the layer content into an anonymous layer nobody else references.
+PXR_NS::SdfLayerRefPtr snapshotLayer(const PXR_NS::SdfLayerHandle& layer)
+{
+    PXR_NS::SdfLayerRefPtr snapshot
+        = PXR_NS::SdfLayer::CreateAnonymous("snapshot", layer->GetFileFormat(), layer->GetFileFormatArguments());
+    if (snapshot)
+    {
+        snapshot->TransferContent(layer);
+    }
+    return snapshot;
+}
+
+// rewrites the relative asset paths of a layer moving from one directory to another, so that
+// they still point at the same files. Relative paths that are neither ./ nor ../ are search
+// paths, they are only rewritten when a file exists next to the layer, like the resolver does.
+void reanchorAssetPaths(const PXR_NS::SdfLayerHandle& layer, const QString& fromDir, const QString& toDir)
+{
+    const QDir from(fromDir);
+    const QDir to(toDir);
+
+    PXR_NS::UsdUtilsModifyAssetPaths(layer, [&](const std::string& assetPath) {
+        const QString path = QString::fromStdString(assetPath);
+        if (path.isEmpty() || QDir::isAbsolutePath(path) || path.contains(':') || path.contains('`'))
+        {
+            return assetPath;
+        }
+
+        const bool    fileRelative = PXR_NS::TfStringStartsWith(assetPath, "./")
+            || PXR_NS::TfStringStartsWith(assetPath, "../");
+        const QString anchored = QDir::cleanPath(from.filePath(path));
+        if (!fileRelative && !QFileInfo::exists(anchored))
+        {
+            return assetPath;
+        }
+
+        const QString relative = to.relativeFilePath(anchored);
+        return (relative.startsWith("../") ? relative : "./" + relative).toStdString();
+    });
+}
+} // namespace
+
+namespace TINKERUSD_NS
+{
+
+LayerSaver::LayerSaver(QObject* parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<LayerSaveResult>();
+
+    PXR_NS::TfWeakPtr<LayerSaver> me(this);
+    m_layersChangedKey = PXR_NS::TfNotice::Register(me, &LayerSaver::onLayersChanged);
+}
+
+LayerSaver::~LayerSaver()
+{
+    // the layers must be written completely before the application goes away
+    waitForWorkers();
+
+    PXR_NS::TfNotice::Revoke(m_layersChangedKey);
+}
+
+int LayerSaver::saveDirtyLayers(const PXR_NS::UsdStageRefPtr& stage)
+{
+    if (!stage)
+    {
+        return 0;
+    }
+
+    if (isSaving())
+    {
+        qWarning() << "[LayerSaver] A save is already in progress.";
+        return -1;
+    }
+
+    std::vector<Job> jobs;
+    for (const auto& layer : stage->GetLayerStack(false))
+    {
+        if (!layer || !layer->IsDirty() || layer->IsAnonymous())
+        {
+            continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        Job job;
+        job.source = layer;
+        job.snapshot = snapshotLayer(layer);
+        job.filePath = layer->GetRealPath();
+        job.args = writeArguments(layer);
+        job.reloadSource = true;
+        job.result.identifier = QString::fromStdString(layer->GetIdentifier());
+        job.result.filePath = QString::fromStdString(job.filePath);
+        job.result.snapshotMs = elapsedMs(start);
+        jobs.push_back(std::move(job));
+    }
+
+    if (jobs.empty())
+    {
+        qDebug() << "[LayerSaver] No dirty layers to save.";
+        return 0;
+    }
+
+    const int count = static_cast<int>(jobs.size());
+    startJobs(std::move(jobs));
+    return count;
+}
+
+bool LayerSaver::saveRootLayerAs(
+    const PXR_NS::UsdStageRefPtr&                stage,
+    const QString&                               filePath,
+    const PXR_NS::SdfLayer::FileFormatArguments& args)
+{
+    if (!stage || filePath.isEmpty())
+    {
+        return false;
+    }
+
+    if (isSaving())
+    {
+        qWarning() << "[LayerSaver] A save is already in progress.";
+        return false;
+    }
+
+    const auto                   start = std::chrono::steady_clock::now();
+    const PXR_NS::SdfLayerHandle rootLayer = stage->GetRootLayer();
+
+    Job job;
+    job.source = rootLayer;
+    job.snapshot = snapshotLayer(rootLayer);
+    job.filePath = filePath.toStdString();
+    job.args = args;
+    job.reloadSource = false;
+
+    // the copy is written elsewhere, its relative asset paths follow it unless the layer was
+    // never saved, then they were anchored to nothing
+    const QString sourceDir = QFileInfo(QString::fromStdString(rootLayer->GetRealPath())).absolutePath();
+    const QString targetDir = QFileInfo(filePath).absolutePath();
+    if (!rootLayer->IsAnonymous() && QDir(sourceDir) != QDir(targetDir))
+    {
+        job.anchorDir = sourceDir;
+    }
+    job.result.identifier = QString::fromStdString(rootLayer->GetIdentifier());
+    job.result.filePath = filePath;
+    job.result.snapshotMs = elapsedMs(start);
+
+    std::vector<Job> jobs;
+    jobs.push_back(std::move(job));
+    startJobs(std::move(jobs));
+    return true;
+}
+
+bool LayerSaver::isSaving() const { return m_pendingJobs > 0; }
+
+void LayerSaver::startJobs(std::vector<Job> jobs)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& job : jobs)
+        {
+            if (job.reloadSource)
+            {
+                m_editedSinceSnapshot[get_pointer(job.source)] = false;
+            }
+        }
+    }
+
+    m_pendingJobs = static_cast<int>(jobs.size());
+    m_savedCount = 0;
+    m_failedCount = 0;
+    m_startTime = std::chrono::steady_clock::now();
+
+    qDebug() << "[LayerSaver] Saving" << m_pendingJobs << "layer(s) in the background.";
+
+    QThread* thread = QThread::create([this, jobs = std::move(jobs)]() mutable {
+        PXR_NS::WorkParallelForN(jobs.size(), [this, &jobs](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                Job& job = jobs[i];
+
+                const auto start = std::chrono::steady_clock::now();
+                if (job.snapshot && !job.anchorDir.isEmpty())
+                {
+                    const QString targetDir = QFileInfo(QString::fromStdString(job.filePath)).absolutePath();
+                    reanchorAssetPaths(job.snapshot, job.anchorDir, targetDir);
+                }
+                job.result.success = job.snapshot && job.snapshot->Export(job.filePath, std::string(), job.args);
+                job.result.writeMs = elapsedMs(start);
+
+                // the snapshot is released on this thread, not on the GUI thread
+                job.snapshot.Reset();
+
+                QMetaObject::invokeMethod(this, [this, job]() { onJobFinished(job); }, Qt::QueuedConnection);
+            }
+        });
+    });
+
+    // the thread is parented so that the destructor can wait for it
+    thread->setParent(this);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    thread->start();
+}
+
+void LayerSaver::onJobFinished(const Job& job)
+{
+    bool edited = false;
+    if (job.reloadSource)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto                        it = m_editedSinceSnapshot.find(get_pointer(job.source));
+        if (it != m_editedSinceSnapshot.end())
+        {
+            edited = it->second;
+            m_editedSinceSnapshot.erase(it);
+        }
+    }
+
+    if (job.result.success)
+    {
+        ++m_savedCount;
+
+        // the file now holds the content of a layer that was not edited in the meantime, it is
+        // clean. Only layers edited behind the undo system are reloaded from it, a layer edited
+        // in the meantime keeps its newer content and stays dirty.
+        if (job.reloadSource && job.source && !edited
+            && !UsdUndoManager::instance().markLayerClean(job.source))
+        {
+            job.source->Reload();
+        }
+
+        qDebug() << "[LayerSaver] Saved" << job.result.filePath << "in" << job.result.snapshotMs
+                 << "ms (snapshot) +" << job.result.writeMs << "ms (write)";
+        emit layerSaved(job.result);
+    }
+    else
+    {
+        ++m_failedCount;
+
+        qCritical() << "[LayerSaver] Failed to save" << job.result.identifier << "to" << job.result.filePath;
+        emit layerSaveFailed(job.result);
+    }
+
+    if (--m_pendingJobs == 0)
+    {
+        const double elapsed = elapsedMs(m_startTime);
+        qDebug() << "[LayerSaver] Save finished:" << m_savedCount << "saved," << m_failedCount << "failed in"
+                 << elapsed << "ms";
+        emit saveFinished(m_savedCount, m_failedCount, elapsed);
+    }
+}
+
+void LayerSaver::onLayersChanged(const PXR_NS::SdfNotice::LayersDidChangeSentPerLayer& notice)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_editedSinceSnapshot.empty())
+    {
+        return;
+    }
+
+    for (const auto& layer : notice.GetLayers())
+    {
+        auto it = m_editedSinceSnapshot.find(get_pointer(layer));
+        if (it != m_editedSinceSnapshot.end())
+        {
+            it->second = true;
+        }
+    }
+}
+
+void LayerSaver::waitForWorkers()
+{
+    for (QThread* thread : findChildren<QThread*>(Qt::FindDirectChildrenOnly))
+    {
+        thread->wait();
+    }
+}
+
+} // namespace TINKERUSD_NS
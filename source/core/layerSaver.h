@@ -0,0 +1,105 @@
+#pragma once
+
+#include "utils.h"
+
+#include <QObject>
+#include <QString>
+#include <chrono>
+#include <mutex>
+#include <pxr/base/tf/notice.h>
+#include <pxr/base/tf/weakBase.h>
+#include <pxr/usd/sdf/layer.h>
+#include <pxr/usd/sdf/notice.h>
+#include <pxr/usd/usd/stage.h>
+#include <unordered_map>
+
+namespace TINKERUSD_NS
+{
+
+// outcome of writing one layer.
+struct LayerSaveResult
+{
+    QString identifier;
+    QString filePath;
+    bool    success { false };
+    double  snapshotMs { 0.0 };
+    double  writeMs { 0.0 };
+};
+
+/*
+Saves layers without blocking the GUI thread.
+
+The content of every layer to save is copied into an anonymous snapshot on the
+calling thread. The snapshots are then serialized in parallel on worker threads,
+so edits made in the meantime neither race with the writers nor end up half
+written on disk.
+
+Once a snapshot is on disk the source layer is marked clean, without reading the
+file back. A layer edited while its snapshot was being written keeps its edits and
+stays dirty.
+*/
+class LayerSaver
+    : public QObject
+    , public PXR_NS::TfWeakBase
+{
+    Q_OBJECT
+public:
+    LayerSaver(QObject* parent = nullptr);
+    virtual ~LayerSaver();
+
+    DISALLOW_COPY_MOVE_ASSIGNMENT(LayerSaver);
+
+    // saves every dirty layer of the stage's layer stack. Returns the number of layers
+    // being saved, or -1 when a save is already in progress.
+    int saveDirtyLayers(const PXR_NS::UsdStageRefPtr& stage);
+
+    // writes the root layer of the stage to filePath, e.g. a .usdc file with format
+    // arguments. Relative asset paths are rewritten for the directory of filePath. The
+    // stage and its root layer are left as they are.
+    bool saveRootLayerAs(
+        const PXR_NS::UsdStageRefPtr&                stage,
+        const QString&                               filePath,
+        const PXR_NS::SdfLayer::FileFormatArguments& args);
+
+    bool isSaving() const;
+
+signals:
+    void layerSaved(const LayerSaveResult& result);
+    void layerSaveFailed(const LayerSaveResult& result);
+
+    // emitted once every layer of a save request has been written or has failed.
+    void saveFinished(int savedCount, int failedCount, double elapsedMs);
+
+private:
+    struct Job
+    {
+        PXR_NS::SdfLayerHandle                source;
+        PXR_NS::SdfLayerRefPtr                snapshot;
+        std::string                           filePath;
+        PXR_NS::SdfLayer::FileFormatArguments args;
+        bool                                  reloadSource;
+        QString                               anchorDir; // directory relative asset paths were anchored to
+        LayerSaveResult                       result;
+    };
+
+    void startJobs(std::vector<Job> jobs);
+    void onJobFinished(const Job& job);
+    void onLayersChanged(const PXR_NS::SdfNotice::LayersDidChangeSentPerLayer& notice);
+    void waitForWorkers();
+
+private:
+    // source layers being saved, and whether they were edited after their snapshot was taken.
+    // Guarded by m_mutex, the layer change notices are also sent from the writer threads.
+    std::mutex                                        m_mutex;
+    std::unordered_map<const PXR_NS::SdfLayer*, bool> m_editedSinceSnapshot;
+
+    PXR_NS::TfNotice::Key                 m_layersChangedKey;
+    int                                   m_pendingJobs { 0 };
+    int                                   m_savedCount { 0 };
+    int                                   m_failedCount { 0 };
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+} // namespace TINKERUSD_NS
+
+Q_DECLARE_METATYPE(TINKERUSD_NS::LayerSaveResult)
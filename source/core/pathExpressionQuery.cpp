@@ -0,0 +1,139 @@
+#include "pathExpressionQuery.h"
+
+#include <pxr/base/tf/errorMark.h>
+#include <pxr/base/work/loops.h>
+#include <pxr/base/work/threadLimits.h>
+#include <pxr/usd/sdf/pathExpression.h>
+#include <pxr/usd/usd/collectionMembershipQuery.h>
+#include <pxr/usd/usd/primRange.h>
+
+#include <vector>
+
+using namespace PXR_NS;
+
+namespace TINKERUSD_NS
+{
+
+namespace
+{
+// same prims as the outliner shows
+const Usd_PrimFlagsConjunction TRAVERSAL_PREDICATE = UsdPrimIsActive && UsdPrimIsDefined && !UsdPrimIsAbstract;
+
+// subtrees handed to each worker thread, so that uneven subtrees still balance out.
+constexpr size_t TASKS_PER_THREAD = 8;
+
+// the hierarchy is not split deeper than this many levels.
+constexpr int MAX_SPLIT_DEPTH = 4;
+
+// records prim when it matches, and returns whether its descendants still can.
+bool matchPrim(const UsdObjectCollectionExpressionEvaluator& evaluator, const UsdPrim& prim, SdfPathVector& matches)
+{
+    const SdfPredicateFunctionResult result = evaluator.Match(prim.GetPath());
+    if (result)
+    {
+        matches.push_back(prim.GetPath());
+    }
+
+    // a constant negative result holds for the whole subtree
+    return result || !result.IsConstant();
+}
+
+void matchSubtree(const UsdObjectCollectionExpressionEvaluator& evaluator, const UsdPrim& root, SdfPathVector& matches)
+{
+    UsdPrimRange range(root, TRAVERSAL_PREDICATE);
+    for (auto it = range.begin(); it != range.end(); ++it)
+    {
+        if (!matchPrim(evaluator, *it, matches))
+        {
+            it.PruneChildren();
+        }
+    }
+}
+} // namespace
+
+bool matchPathExpression(
+    const UsdStageRefPtr& stage,
+    const std::string&    expression,
+    SdfPathVector*        paths,
+    std::string*          error)
+{
+    if (!stage || !paths)
+    {
+        return false;
+    }
+
+    TfErrorMark       mark;
+    SdfPathExpression pathExpression(expression);
+    if (!mark.IsClean())
+    {
+        if (error)
+        {
+            *error = mark.GetBegin()->GetCommentary();
+        }
+        mark.Clear();
+        return false;
+    }
+
+    paths->clear();
+    if (pathExpression.IsEmpty())
+    {
+        return true;
+    }
+
+    const UsdObjectCollectionExpressionEvaluator evaluator(stage, pathExpression);
+
+    // split the hierarchy breadth first until there are enough subtrees to keep every thread busy
+    const size_t         minTasks = WorkGetConcurrencyLimit() * TASKS_PER_THREAD;
+    std::vector<UsdPrim> frontier;
+    for (const auto& prim : stage->GetPseudoRoot().GetFilteredChildren(TRAVERSAL_PREDICATE))
+    {
+        frontier.push_back(prim);
+    }
+
+    for (int depth = 0; depth < MAX_SPLIT_DEPTH && !frontier.empty() && frontier.size() < minTasks; ++depth)
+    {
+        std::vector<UsdPrim> next;
+        for (const auto& prim : frontier)
+        {
+            if (!matchPrim(evaluator, prim, *paths))
+            {
+                continue;
+            }
+
+            for (const auto& child : prim.GetFilteredChildren(TRAVERSAL_PREDICATE))
+            {
+                next.push_back(child);
+            }
+        }
+        frontier = std::move(next);
+    }
+
+    std::vector<SdfPathVector> subtreeMatches(frontier.size());
+    WorkParallelForN(frontier.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            matchSubtree(evaluator, frontier[i], subtreeMatches[i]);
+        }
+    });
+
+    size_t matchCount = paths->size();
+    for (const auto& matches : subtreeMatches)
+    {
+        matchCount += matches.size();
+    }
+
+    paths->reserve(matchCount);
+    for (const auto& matches : subtreeMatches)
+    {
+        paths->insert(paths->end(), matches.begin(), matches.end());
+    }
+
+    return true;
+}
+
+bool looksLikePathExpression(const std::string& text)
+{
+    return !text.empty() && (text.front() == '/' || text.find('{') != std::string::npos);
+}
+
+} // namespace TINKERUSD_NS
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <pxr/usd/sdf/path.h>
+#include <pxr/usd/usd/stage.h>
+#include <string>
+
+namespace TINKERUSD_NS
+{
+
+/*
+Prims of a stage matched by an SdfPathExpression, e.g. "/World//Tree_*{isa:Mesh}" or
+"//{kind:component}". Predicates are those of the USD collection predicate library
+(isa, hasAPI, kind, model, group, abstract, defined, specifier and variant).
+
+The hierarchy is split into subtrees that are traversed in parallel. Subtrees the
+expression can no longer match are pruned without being visited.
+*/
+
+// returns false and fills error when the expression cannot be parsed.
+bool matchPathExpression(
+    const PXR_NS::UsdStageRefPtr& stage,
+    const std::string&            expression,
+    PXR_NS::SdfPathVector*        paths,
+    std::string*                  error = nullptr);
+
+// whether text reads as a path expression rather than a plain name filter.
+bool looksLikePathExpression(const std::string& text);
+
+} // namespace TINKERUSD_NS
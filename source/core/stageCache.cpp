@@ -0,0 +1,245 @@
+#include "stageCache.h"
+
+#include "usdDocument.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <pxr/usd/sdf/layer.h>
+
+#include <algorithm>
+
+namespace TINKERUSD_NS
+{
+
+StageCache& StageCache::instance()
+{
+    static StageCache instance;
+    return instance;
+}
+
+QString StageCache::makeKey(const QString& path, const StageOpenOptions& options)
+{
+    QStringList parts { QFileInfo(path).absoluteFilePath() };
+    parts << QString::number(static_cast<int>(options.loadPolicy));
+    parts << options.populationMask.join(',');
+    parts << options.loadIncludePaths.join(',');
+    parts << options.loadExcludePaths.join(',');
+    return parts.join('|');
+}
+
+PXR_NS::UsdStageRefPtr StageCache::find(const QString& key, QDateTime* checkedAt)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->key != key)
+        {
+            continue;
+        }
+
+        PXR_NS::UsdStageRefPtr stage = m_cache.Find(it->id);
+        if (!stage)
+        {
+            release(*it);
+            m_entries.erase(it);
+            break;
+        }
+
+        if (checkedAt)
+        {
+            *checkedAt = it->checkedAt;
+        }
+
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        ++m_hits;
+
+        emit statisticsChanged();
+        return stage;
+    }
+
+    ++m_misses;
+
+    emit statisticsChanged();
+    return nullptr;
+}
+
+void StageCache::markChecked(const PXR_NS::UsdStageRefPtr& stage, const QDateTime& time)
+{
+    const PXR_NS::UsdStageCache::Id id = m_cache.GetId(stage);
+    for (auto& entry : m_entries)
+    {
+        if (entry.id == id)
+        {
+            entry.checkedAt = time;
+            break;
+        }
+    }
+}
+
+PXR_NS::SdfLayerRefPtrVector StageCache::modifiedLayers(const PXR_NS::UsdStageRefPtr& stage, const QDateTime& time)
+{
+    PXR_NS::SdfLayerRefPtrVector layers;
+    for (const auto& layer : stage->GetUsedLayers())
+    {
+        if (!layer || layer->IsAnonymous() || layer->IsDirty())
+        {
+            continue;
+        }
+
+        const QFileInfo info(QString::fromStdString(layer->GetRealPath()));
+        if (info.exists() && info.lastModified() > time)
+        {
+            layers.push_back(layer);
+        }
+    }
+    return layers;
+}
+
+bool StageCache::reloadLayers(const PXR_NS::SdfLayerRefPtrVector& layers)
+{
+    bool reloaded = false;
+    for (const auto& layer : layers)
+    {
+        qDebug() << "[StageCache] Reloading layer changed on disk:" << QString::fromStdString(layer->GetRealPath());
+        reloaded = layer->Reload() || reloaded;
+    }
+    return reloaded;
+}
+
+StageCache::LayerSizes StageCache::layerFileSizes(const PXR_NS::UsdStageRefPtr& stage)
+{
+    LayerSizes sizes;
+    for (const auto& layer : stage->GetUsedLayers())
+    {
+        if (layer && !layer->IsAnonymous())
+        {
+            sizes[layer->GetIdentifier()]
+                = static_cast<size_t>(QFileInfo(QString::fromStdString(layer->GetRealPath())).size());
+        }
+    }
+    return sizes;
+}
+
+void StageCache::charge(Entry& entry, const LayerSizes& layerSizes)
+{
+    m_memoryUsage += STAGE_BYTES;
+    for (const auto& [identifier, bytes] : layerSizes)
+    {
+        auto [it, inserted] = m_layers.emplace(identifier, SharedLayer { bytes, 0 });
+        if (inserted)
+        {
+            m_memoryUsage += bytes;
+        }
+        ++it->second.stages;
+        entry.layers.push_back(identifier);
+    }
+}
+
+void StageCache::release(const Entry& entry)
+{
+    m_memoryUsage -= STAGE_BYTES;
+    for (const std::string& identifier : entry.layers)
+    {
+        auto it = m_layers.find(identifier);
+        if (it != m_layers.end() && --it->second.stages == 0)
+        {
+            m_memoryUsage -= it->second.bytes;
+            m_layers.erase(it);
+        }
+    }
+}
+
+void StageCache::insert(const QString& key, const PXR_NS::UsdStageRefPtr& stage, const LayerSizes& layerSizes)
+{
+    if (!stage)
+    {
+        return;
+    }
+
+    // replace a stale entry for the same key
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->key == key)
+        {
+            m_cache.Erase(it->id);
+            release(*it);
+            m_entries.erase(it);
+            break;
+        }
+    }
+
+    m_entries.push_front({ key, m_cache.Insert(stage), {}, QDateTime::currentDateTime() });
+    charge(m_entries.front(), layerSizes);
+
+    evict();
+
+    emit statisticsChanged();
+}
+
+void StageCache::erase(const PXR_NS::UsdStageRefPtr& stage)
+{
+    const PXR_NS::UsdStageCache::Id id = m_cache.GetId(stage);
+    if (!id.IsValid())
+    {
+        return;
+    }
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->id == id)
+        {
+            qDebug() << "[StageCache] Forgetting stage:" << it->key;
+
+            m_cache.Erase(id);
+            release(*it);
+            m_entries.erase(it);
+            break;
+        }
+    }
+
+    emit statisticsChanged();
+}
+
+void StageCache::evict()
+{
+    while (m_memoryUsage > m_memoryBudget && m_entries.size() > 1)
+    {
+        const Entry& entry = m_entries.back();
+
+        qDebug() << "[StageCache] Evicting stage:" << entry.key;
+
+        m_cache.Erase(entry.id);
+        release(entry);
+        m_entries.pop_back();
+    }
+}
+
+void StageCache::clear()
+{
+    m_cache.Clear();
+    m_entries.clear();
+    m_layers.clear();
+    m_memoryUsage = 0;
+
+    emit statisticsChanged();
+}
+
+void StageCache::setMemoryBudget(size_t bytes)
+{
+    m_memoryBudget = bytes;
+
+    evict();
+
+    emit statisticsChanged();
+}
+
+size_t StageCache::memoryBudget() const { return m_memoryBudget; }
+
+size_t StageCache::memoryUsage() const { return m_memoryUsage; }
+
+size_t StageCache::hits() const { return m_hits; }
+
+size_t StageCache::misses() const { return m_misses; }
+
+size_t StageCache::size() const { return m_entries.size(); }
+
+} // namespace TINKERUSD_NS
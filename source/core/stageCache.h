@@ -0,0 +1,122 @@
+#pragma once
+
+#include "utils.h"
+
+#include <QDateTime>
+#include <QObject>
+#include <QString>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <pxr/usd/sdf/layer.h>
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usd/stageCache.h>
+
+namespace TINKERUSD_NS
+{
+
+struct StageOpenOptions;
+
+/*
+Keeps recently opened stages, and with them their whole layer graph, alive so
+that reopening a file or switching back to a previous shot does not pay the
+parse and composition cost again.
+
+The memory held by the cache is estimated from the file sizes of the layers
+the cached stages use, plus STAGE_BYTES per stage for its composition. A layer
+shared by several stages is counted once and only stops counting when the last
+of them leaves the cache. This is a file size estimate, not the resident size:
+parsed layers usually take more memory than their files, compressed crate
+files a lot more. Entries are evicted in least recently used order once the
+estimate exceeds the budget. The most recently used stage is never evicted.
+*/
+class StageCache : public QObject
+{
+    Q_OBJECT
+public:
+    static StageCache& instance();
+
+    DISALLOW_COPY_MOVE_ASSIGNMENT(StageCache);
+
+    // builds the cache key for a file opened with the given options.
+    static QString makeKey(const QString& path, const StageOpenOptions& options);
+
+    // returns the cached stage and marks it as most recently used, counts a hit or a miss.
+    // checkedAt is set to the time the layers of the stage were last compared with their
+    // files, see modifiedLayers and markChecked.
+    PXR_NS::UsdStageRefPtr find(const QString& key, QDateTime* checkedAt = nullptr);
+
+    // records that the layers of a cached stage match their files as of time.
+    void markChecked(const PXR_NS::UsdStageRefPtr& stage, const QDateTime& time);
+
+    // clean layers of the stage whose file was modified after the given time. Layers holding
+    // unsaved edits keep them and are not returned. Only reads file times, safe to call from
+    // any thread.
+    static PXR_NS::SdfLayerRefPtrVector modifiedLayers(const PXR_NS::UsdStageRefPtr& stage, const QDateTime& time);
+
+    // reads the layers again from their files. Returns true when a layer was reloaded.
+    static bool reloadLayers(const PXR_NS::SdfLayerRefPtrVector& layers);
+
+    // file size of every layer a stage uses, keyed by layer identifier.
+    using LayerSizes = std::map<std::string, size_t>;
+
+    // file sizes of the layers the stage uses. Reads file sizes, call it where the stage was
+    // opened rather than on the GUI thread.
+    static LayerSizes layerFileSizes(const PXR_NS::UsdStageRefPtr& stage);
+
+    // layerSizes are the file sizes of the layers of the stage as of its open, see layerFileSizes.
+    void insert(const QString& key, const PXR_NS::UsdStageRefPtr& stage, const LayerSizes& layerSizes);
+
+    // forgets a stage whose population or load state no longer matches its key. The stage
+    // itself stays alive as long as it is referenced elsewhere.
+    void erase(const PXR_NS::UsdStageRefPtr& stage);
+
+    void clear();
+
+    // budget and usage are file size estimates, see the class description.
+    void   setMemoryBudget(size_t bytes);
+    size_t memoryBudget() const;
+
+    size_t memoryUsage() const;
+    size_t hits() const;
+    size_t misses() const;
+    size_t size() const;
+
+signals:
+    void statisticsChanged();
+
+private:
+    StageCache() = default;
+
+    struct Entry
+    {
+        QString                   key;
+        PXR_NS::UsdStageCache::Id id;
+        std::vector<std::string>  layers;    // identifiers of the layers charged to the cache
+        QDateTime                 checkedAt; // layer files changed after this are reloaded
+    };
+
+    struct SharedLayer
+    {
+        size_t bytes;
+        int    stages;
+    };
+
+    void charge(Entry& entry, const LayerSizes& layerSizes);
+    void release(const Entry& entry);
+    void evict();
+
+    static constexpr size_t STAGE_BYTES { size_t(1) << 20 };
+
+private:
+    PXR_NS::UsdStageCache m_cache;
+    std::list<Entry>      m_entries; // most recently used first
+    std::map<std::string, SharedLayer> m_layers;
+    size_t                m_memoryBudget { size_t(4) << 30 };
+    size_t                m_memoryUsage { 0 };
+    size_t                m_hits { 0 };
+    size_t                m_misses { 0 };
+};
+
+} // namespace TINKERUSD_NS
@@ -0,0 +1,131 @@
+#include "timeSamplePrefetcher.h"
+
+#include <QThread>
+#include <pxr/base/work/loops.h>
+#include <pxr/usd/usd/primRange.h>
+
+namespace TINKERUSD_NS
+{
+
+TimeSamplePrefetcher::TimeSamplePrefetcher(QObject* parent)
+    : QObject(parent)
+    , m_queries(std::make_shared<AttributeQueries>())
+    , m_cancelled(std::make_shared<std::atomic<bool>>(false))
+    , m_collected(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+TimeSamplePrefetcher::~TimeSamplePrefetcher()
+{
+    PXR_NS::TfNotice::Revoke(m_objectsChangedKey);
+    stop();
+}
+
+void TimeSamplePrefetcher::setStage(const PXR_NS::UsdStageRefPtr& stage)
+{
+    stop();
+    PXR_NS::TfNotice::Revoke(m_objectsChangedKey);
+
+    m_stage = stage;
+    m_queries = std::make_shared<AttributeQueries>();
+    m_collected = std::make_shared<std::atomic<bool>>(false);
+
+    if (m_stage)
+    {
+        PXR_NS::TfWeakPtr<TimeSamplePrefetcher> me(this);
+        m_objectsChangedKey = PXR_NS::TfNotice::Register(
+            me, &TimeSamplePrefetcher::onObjectsChanged, PXR_NS::UsdStageWeakPtr(m_stage));
+    }
+}
+
+bool TimeSamplePrefetcher::prefetch(const std::vector<double>& times)
+{
+    if (!m_stage || times.empty() || isBusy())
+    {
+        return false;
+    }
+
+    // every request gets its own flag, a cancelled request must not stop the next one
+    m_cancelled = std::make_shared<std::atomic<bool>>(false);
+
+    PXR_NS::UsdStageRefPtr stage = m_stage;
+    auto                   queries = m_queries;
+    auto                   collected = m_collected;
+    auto                   cancelled = m_cancelled;
+
+    QThread* thread = QThread::create([stage, queries, collected, cancelled, times]() {
+        if (!*collected)
+        {
+            for (const auto& prim : PXR_NS::UsdPrimRange::Stage(stage))
+            {
+                if (*cancelled)
+                {
+                    return;
+                }
+
+                for (const auto& attribute : prim.GetAttributes())
+                {
+                    if (attribute.ValueMightBeTimeVarying())
+                    {
+                        queries->emplace_back(attribute);
+                    }
+                }
+            }
+            *collected = true;
+        }
+
+        for (double time : times)
+        {
+            if (*cancelled)
+            {
+                return;
+            }
+
+            PXR_NS::WorkParallelForN(queries->size(), [&](size_t begin, size_t end) {
+                PXR_NS::VtValue value;
+                for (size_t i = begin; i < end; ++i)
+                {
+                    (*queries)[i].Get(&value, time);
+                }
+            });
+        }
+    });
+
+    // the thread is parented so that the destructor can wait for it
+    thread->setParent(this);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    m_worker = thread;
+    thread->start();
+    return true;
+}
+
+void TimeSamplePrefetcher::cancel() { *m_cancelled = true; }
+
+void TimeSamplePrefetcher::stop()
+{
+    if (isBusy())
+    {
+        cancel();
+        waitForWorker();
+    }
+}
+
+bool TimeSamplePrefetcher::isBusy() const { return m_worker && m_worker->isRunning(); }
+
+void TimeSamplePrefetcher::waitForWorker()
+{
+    for (QThread* thread : findChildren<QThread*>(Qt::FindDirectChildrenOnly))
+    {
+        thread->wait();
+    }
+}
+
+void TimeSamplePrefetcher::onObjectsChanged(const PXR_NS::UsdNotice::ObjectsChanged&)
+{
+    // prims may be gone and attributes may have become animated, the attributes are collected again
+    stop();
+    m_queries = std::make_shared<AttributeQueries>();
+    m_collected = std::make_shared<std::atomic<bool>>(false);
+}
+
+} // namespace TINKERUSD_NS
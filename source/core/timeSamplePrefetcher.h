@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <atomic>
+#include <memory>
+#include <pxr/base/tf/notice.h>
+#include <pxr/base/tf/weakBase.h>
+#include <pxr/usd/usd/attributeQuery.h>
+#include <pxr/usd/usd/notice.h>
+#include <pxr/usd/usd/stage.h>
+#include <vector>
+
+class QThread;
+
+namespace TINKERUSD_NS
+{
+
+/*
+Reads the time samples of the animated attributes of a stage, transform operations
+included, for frames that are about to be shown. Reading them ahead pulls the data
+in from disk and the network, so that the frame itself only pays for cached reads.
+
+The animated attributes are collected on the first request, on the worker thread, and
+collected again after the stage changed. Samples are read in parallel across attributes,
+one frame after the other.
+
+USD does not support reading a stage while it is being authored: the prefetch must be
+stopped before any edit, see stop().
+*/
+class TimeSamplePrefetcher
+    : public QObject
+    , public PXR_NS::TfWeakBase
+{
+    Q_OBJECT
+public:
+    TimeSamplePrefetcher(QObject* parent = nullptr);
+    virtual ~TimeSamplePrefetcher();
+
+    // cancels the pending prefetch and forgets the attributes of the previous stage.
+    void setStage(const PXR_NS::UsdStageRefPtr& stage);
+
+    // starts reading the samples at the given times. Returns false while a previous
+    // request is still running.
+    bool prefetch(const std::vector<double>& times);
+
+    // asks the running request to stop after the frame it is reading.
+    void cancel();
+
+    // cancels the running request and waits for it to be over.
+    void stop();
+
+    bool isBusy() const;
+
+private:
+    void waitForWorker();
+    void onObjectsChanged(const PXR_NS::UsdNotice::ObjectsChanged& notice);
+
+private:
+    using AttributeQueries = std::vector<PXR_NS::UsdAttributeQuery>;
+
+    PXR_NS::UsdStageRefPtr             m_stage;
+    std::shared_ptr<AttributeQueries>  m_queries;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+    std::shared_ptr<std::atomic<bool>> m_collected;
+    QPointer<QThread>                  m_worker;
+    PXR_NS::TfNotice::Key              m_objectsChangedKey;
+};
+
+} // namespace TINKERUSD_NS
@@ -0,0 +1,229 @@
+#include "timeline.h"
+
+#include "timeSamplePrefetcher.h"
+#include "undo/usdUndoManager.h"
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+
+using namespace PXR_NS;
+
+namespace TINKERUSD_NS
+{
+
+namespace
+{
+// frames whose samples are read ahead of the current one during playback.
+constexpr int PREFETCH_FRAMES = 24;
+} // namespace
+
+Timeline& Timeline::instance()
+{
+    static Timeline instance;
+    return instance;
+}
+
+Timeline::Timeline()
+    : m_playbackTimer(new QTimer(this))
+    , m_prefetcher(new TimeSamplePrefetcher(this))
+{
+    m_playbackTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_playbackTimer, &QTimer::timeout, this, &Timeline::onTick);
+
+    // the stage must not be read while it is authored
+    UsdUndoManager::instance().setEditGuard([this]() { stopPrefetch(); });
+
+    // the prefetch reads the stage, it must be over before the stage goes away
+    if (QCoreApplication::instance())
+    {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+            pause();
+            m_prefetcher->setStage(nullptr);
+        });
+    }
+}
+
+Timeline::~Timeline() = default;
+
+void Timeline::setStage(const UsdStageRefPtr& stage)
+{
+    pause();
+    m_prefetcher->setStage(stage);
+
+    m_stage = stage;
+    m_hasTimeRange = stage && stage->HasAuthoredTimeCodeRange();
+    m_startTime = m_hasTimeRange ? stage->GetStartTimeCode() : 0.0;
+    m_endTime = m_hasTimeRange ? std::max(stage->GetEndTimeCode(), m_startTime) : 0.0;
+    m_timeCodesPerSecond = stage ? stage->GetTimeCodesPerSecond() : 24.0;
+    m_framesPerSecond = stage ? stage->GetFramesPerSecond() : 24.0;
+    if (m_framesPerSecond <= 0.0)
+    {
+        m_framesPerSecond = 24.0;
+    }
+    if (m_timeCodesPerSecond <= 0.0)
+    {
+        m_timeCodesPerSecond = m_framesPerSecond;
+    }
+
+    emit rangeChanged(m_startTime, m_endTime);
+
+    m_currentTime = m_startTime;
+    emit timeChanged(m_currentTime);
+}
+
+UsdTimeCode Timeline::initialTimeCode(const UsdStageRefPtr& stage)
+{
+    return stage && stage->HasAuthoredTimeCodeRange() ? UsdTimeCode(stage->GetStartTimeCode())
+                                                      : UsdTimeCode::Default();
+}
+
+bool Timeline::hasTimeRange() const { return m_hasTimeRange; }
+
+double Timeline::startTime() const { return m_startTime; }
+
+double Timeline::endTime() const { return m_endTime; }
+
+double Timeline::framesPerSecond() const { return m_framesPerSecond; }
+
+double Timeline::frameStep() const { return m_timeCodesPerSecond / m_framesPerSecond; }
+
+double Timeline::currentTime() const { return m_currentTime; }
+
+void Timeline::setCurrentTime(double time)
+{
+    time = std::clamp(time, m_startTime, m_endTime);
+    if (time == m_currentTime)
+    {
+        return;
+    }
+
+    m_currentTime = time;
+    emit timeChanged(m_currentTime);
+}
+
+UsdTimeCode Timeline::timeCode() const
+{
+    return m_hasTimeRange ? UsdTimeCode(m_currentTime) : UsdTimeCode::Default();
+}
+
+void Timeline::play()
+{
+    if (isPlaying() || !m_hasTimeRange || m_endTime <= m_startTime)
+    {
+        return;
+    }
+
+    // playing from the last frame starts over
+    if (m_currentTime >= m_endTime)
+    {
+        setCurrentTime(m_startTime);
+    }
+
+    m_droppedFrames = 0;
+    m_playbackStartTime = m_currentTime;
+    m_prefetchedUntil = m_currentTime;
+    m_playbackClock.start();
+
+    // ticks come twice per frame, so that a frame is never shown more than half a frame late
+    m_playbackTimer->start(std::max(1, static_cast<int>(500.0 / m_framesPerSecond)));
+    emit playbackChanged(true);
+
+    prefetchAhead();
+}
+
+void Timeline::pause()
+{
+    if (!isPlaying())
+    {
+        return;
+    }
+
+    m_playbackTimer->stop();
+    stopPrefetch();
+    emit playbackChanged(false);
+}
+
+void Timeline::togglePlayback()
+{
+    if (isPlaying())
+    {
+        pause();
+    }
+    else
+    {
+        play();
+    }
+}
+
+bool Timeline::isPlaying() const { return m_playbackTimer->isActive(); }
+
+void Timeline::setLooping(bool looping) { m_looping = looping; }
+
+bool Timeline::isLooping() const { return m_looping; }
+
+size_t Timeline::droppedFrames() const { return m_droppedFrames; }
+
+void Timeline::stopPrefetch()
+{
+    if (m_prefetcher->isBusy())
+    {
+        m_prefetcher->stop();
+        m_prefetchedUntil = m_currentTime;
+    }
+}
+
+void Timeline::onTick()
+{
+    const double step = frameStep();
+    const double frame = std::floor(m_playbackClock.elapsed() * m_framesPerSecond / 1000.0);
+    double       time = m_playbackStartTime + frame * step;
+
+    if (time > m_endTime)
+    {
+        if (!m_looping)
+        {
+            setCurrentTime(m_endTime);
+            pause();
+            return;
+        }
+
+        m_playbackStartTime = m_startTime;
+        m_prefetchedUntil = m_startTime;
+        m_playbackClock.start();
+        time = m_startTime;
+    }
+    else if (time <= m_currentTime)
+    {
+        // the frame that is due is already shown
+        return;
+    }
+    else
+    {
+        m_droppedFrames += static_cast<size_t>(std::max(0.0, std::round((time - m_currentTime) / step) - 1.0));
+    }
+
+    setCurrentTime(time);
+    prefetchAhead();
+}
+
+void Timeline::prefetchAhead()
+{
+    const double step = frameStep();
+    const double lastTime = std::min(m_endTime, m_currentTime + PREFETCH_FRAMES * step);
+
+    std::vector<double> times;
+    for (double time = std::max(m_prefetchedUntil, m_currentTime) + step; time <= lastTime; time += step)
+    {
+        times.push_back(time);
+    }
+
+    // a busy prefetcher gets the frames it missed with the next request
+    if (m_prefetcher->prefetch(times))
+    {
+        m_prefetchedUntil = times.back();
+    }
+}
+
+} // namespace TINKERUSD_NS
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "utils.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usd/timeCode.h>
+
+class QTimer;
+
+namespace TINKERUSD_NS
+{
+
+class TimeSamplePrefetcher;
+
+/*
+Current time of the stage, shared by the viewport, the bounds helpers and the property
+editor, and real-time playback over the stage's start and end time codes.
+
+Playback follows the wall clock: every tick shows the frame that is due, so frames that
+could not be drawn in time are dropped rather than slowing playback down. While playing,
+the samples of the upcoming frames are read ahead on worker threads, see stopPrefetch.
+*/
+class Timeline : public QObject
+{
+    Q_OBJECT
+public:
+    static Timeline& instance();
+
+    DISALLOW_COPY_MOVE_ASSIGNMENT(Timeline);
+
+    // reads the playback range and rate from the stage metadata, and rewinds to the start.
+    void setStage(const PXR_NS::UsdStageRefPtr& stage);
+
+    // the time a stage is first shown at, see timeCode.
+    static PXR_NS::UsdTimeCode initialTimeCode(const PXR_NS::UsdStageRefPtr& stage);
+
+    // whether the stage authors a time code range. Stages without one are shown at the default time.
+    bool hasTimeRange() const;
+
+    double startTime() const;
+    double endTime() const;
+    double framesPerSecond() const;
+
+    // time codes between two consecutive frames.
+    double frameStep() const;
+
+    double currentTime() const;
+    void   setCurrentTime(double time);
+
+    // the time values are read and authored at.
+    PXR_NS::UsdTimeCode timeCode() const;
+
+    void play();
+    void pause();
+    void togglePlayback();
+    bool isPlaying() const;
+
+    void setLooping(bool looping);
+    bool isLooping() const;
+
+    // frames skipped since playback started because the previous ones took too long to show.
+    size_t droppedFrames() const;
+
+    // waits for the samples being read ahead, the stage is about to be changed. Called before
+    // every undoable edit, the next frame starts reading ahead again.
+    void stopPrefetch();
+
+signals:
+    void timeChanged(double time);
+    void rangeChanged(double startTime, double endTime);
+    void playbackChanged(bool playing);
+
+private:
+    Timeline();
+    ~Timeline();
+
+    void onTick();
+    void prefetchAhead();
+
+private:
+    PXR_NS::UsdStageWeakPtr m_stage;
+    double                  m_startTime { 0.0 };
+    double                  m_endTime { 0.0 };
+    double                  m_framesPerSecond { 24.0 };
+    double                  m_timeCodesPerSecond { 24.0 };
+    double                  m_currentTime { 0.0 };
+    bool                    m_hasTimeRange { false };
+    bool                    m_looping { true };
+    QTimer*                 m_playbackTimer;
+    QElapsedTimer           m_playbackClock;
+    double                  m_playbackStartTime { 0.0 };
+    size_t                  m_droppedFrames { 0 };
+    TimeSamplePrefetcher*   m_prefetcher;
+    double                  m_prefetchedUntil { 0.0 };
+};
+
+} // namespace TINKERUSD_NS
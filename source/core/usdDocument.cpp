@@ -1,75 +1,1060 @@
 #include "UsdDocument.h"
 
+#include "boundsCache.h"
+#include "layerSaver.h"
+#include "stageCache.h"
+#include "timeline.h"
 #include "ui/undoManager.h"
+#include "utils.h"
+#include "undo/usdEditJournal.h"
 #include "undo/usdUndoManager.h"
 
 #include <QMessageBox>
+#include <QCryptographicHash>
 #include <QDebug>
+#include <QDir>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QUndoStack>
+#include <pxr/base/tf/envSetting.h>
+#include <pxr/base/tf/patternMatcher.h>
+#include <pxr/base/tf/stringUtils.h>
+#include <pxr/base/work/dispatcher.h>
+#include <pxr/usd/sdf/layerUtils.h>
+#include <pxr/usd/sdf/primSpec.h>
+#include <pxr/usd/usd/primRange.h>
+#include <pxr/usd/usd/stageLoadRules.h>
+#include <pxr/usd/usd/stagePopulationMask.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+TF_DEFINE_ENV_SETTING(
+    TINKERUSD_LAYER_OPEN_DELAY_MS,
+    0,
+    "Delay in milliseconds added to every layer opened before composing a stage.");
+
+namespace
+{
+
+// how many prims are traversed between two progress notifications
+constexpr int PRIM_PROGRESS_INTERVAL = 1000;
+
+// one journal per layer file, in the application data directory
+QString editJournalPath(const PXR_NS::SdfLayerHandle& layer)
+{
+    if (!layer || layer->IsAnonymous())
+    {
+        return QString();
+    }
+
+    const QByteArray hash
+        = QCryptographicHash::hash(QByteArray::fromStdString(layer->GetRealPath()), QCryptographicHash::Md5);
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/journals";
+    if (!QDir().mkpath(dir))
+    {
+        return QString();
+    }
+    return QString("%1/%2.journal").arg(dir, QString::fromLatin1(hash.toHex()));
+}
+
+// journals of previous sessions moved aside and not replayed or discarded yet, oldest first.
+QStringList recoveredJournalPaths(const QString& journalPath)
+{
+    if (journalPath.isEmpty())
+    {
+        return QStringList();
+    }
+
+    const QFileInfo   info(journalPath);
+    const QStringList names = info.dir().entryList(
+        QStringList() << info.fileName() + ".recovered*", QDir::Files, QDir::Name);
+
+    QStringList paths;
+    for (const auto& name : names)
+    {
+        paths.append(info.dir().filePath(name));
+    }
+    return paths;
+}
+
+// Artificial latency added to every layer the prefetch opens, used to emulate a network
+// file system when measuring the prefetch against a local directory tree.
+PXR_NS::SdfLayerRefPtr openLayer(const std::string& path)
+{
+    if (const int delay = PXR_NS::TfGetEnvSetting(TINKERUSD_LAYER_OPEN_DELAY_MS); delay > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+    }
+    return PXR_NS::SdfLayer::FindOrOpen(path);
+}
+
+// resolved paths of the layers the given layer brings into composition.
+std::vector<std::string> layerDependencies(const PXR_NS::SdfLayerRefPtr& layer, bool rootLayerStackOnly)
+{
+    std::vector<std::string> dependencies;
+    if (rootLayerStackOnly)
+    {
+        dependencies = layer->GetSubLayerPaths();
+    }
+    else
+    {
+        const auto assetDependencies = layer->GetCompositionAssetDependencies();
+        dependencies.assign(assetDependencies.begin(), assetDependencies.end());
+    }
+
+    for (std::string& assetPath : dependencies)
+    {
+        assetPath = PXR_NS::SdfComputeAssetPathRelativeToLayer(layer, assetPath);
+    }
+    return dependencies;
+}
+
+// Opens the root layer and every layer it transitively depends on through sublayers,
+// references and payloads. The layers are kept alive in "layers" so that composition
+// finds them in the layer registry instead of opening them again. When "rootLayerStackOnly"
+// is set only the root layer stack is opened: masked opens and opens that defer payloads
+// would otherwise read layers composition never asks for.
+// With "parallel" set the layers are opened concurrently, each opened layer schedules its
+// own dependencies as soon as it has been read.
+PXR_NS::SdfLayerRefPtr resolveLayers(
+    const std::string&                   path,
+    bool                                 rootLayerStackOnly,
+    bool                                 parallel,
+    const std::atomic<bool>&             cancelled,
+    std::vector<PXR_NS::SdfLayerRefPtr>& layers,
+    const std::function<void(int)>&      progress)
+{
+    PXR_NS::SdfLayerRefPtr rootLayer = openLayer(path);
+    if (!rootLayer)
+    {
+        return nullptr;
+    }
+
+    std::mutex                      mutex;
+    std::unordered_set<std::string> visited { rootLayer->GetIdentifier() };
+
+    // returns the layer count once the layer is recorded
+    auto addLayer = [&](const PXR_NS::SdfLayerRefPtr& layer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        layers.push_back(layer);
+        return static_cast<int>(layers.size());
+    };
+
+    auto markVisited = [&](const std::string& resolvedPath) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !resolvedPath.empty() && visited.insert(resolvedPath).second;
+    };
+
+    progress(addLayer(rootLayer));
+
+    if (!parallel)
+    {
+        std::vector<PXR_NS::SdfLayerRefPtr> pending { rootLayer };
+        while (!pending.empty() && !cancelled)
+        {
+            PXR_NS::SdfLayerRefPtr layer = pending.back();
+            pending.pop_back();
+
+            for (const std::string& resolvedPath : layerDependencies(layer, rootLayerStackOnly))
+            {
+                // missing layers are reported by composition later on
+                if (!markVisited(resolvedPath) || cancelled)
+                {
+                    continue;
+                }
+                if (auto dependency = openLayer(resolvedPath))
+                {
+                    progress(addLayer(dependency));
+                    pending.push_back(dependency);
+                }
+            }
+        }
+        return rootLayer;
+    }
+
+    PXR_NS::WorkDispatcher dispatcher;
+
+    std::function<void(const PXR_NS::SdfLayerRefPtr&)> scheduleDependencies;
+    scheduleDependencies = [&](const PXR_NS::SdfLayerRefPtr& layer) {
+        for (const std::string& resolvedPath : layerDependencies(layer, rootLayerStackOnly))
+        {
+            if (!markVisited(resolvedPath))
+            {
+                continue;
+            }
+            dispatcher.Run([&, resolvedPath]() {
+                if (cancelled)
+                {
+                    return;
+                }
+                // missing layers are reported by composition later on
+                if (auto dependency = openLayer(resolvedPath))
+                {
+                    progress(addLayer(dependency));
+                    scheduleDependencies(dependency);
+                }
+            });
+        }
+    };
+
+    scheduleDependencies(rootLayer);
+    dispatcher.Wait();
+
+    return rootLayer;
+}
+
+bool hasWildcard(const std::string& pattern) { return pattern.find_first_of("*?[") != std::string::npos; }
+
+// Builds a population mask from absolute prim paths and glob patterns. Wildcard components
+// are matched against the prim names authored in the given layer stack, names that are only
+// introduced by references or payloads below the root layer stack are not expanded.
+PXR_NS::UsdStagePopulationMask
+buildPopulationMask(const PXR_NS::SdfLayerHandleVector& layerStack, const QStringList& patterns)
+{
+    PXR_NS::UsdStagePopulationMask mask;
+
+    for (const QString& entry : patterns)
+    {
+        const std::string pattern = entry.trimmed().toStdString();
+        if (pattern.empty())
+        {
+            continue;
+        }
+
+        if (pattern.front() != '/')
+        {
+            qWarning() << "[UsdDocument] Ignoring relative population mask entry:" << entry;
+            continue;
+        }
+
+        // an invalid entry is skipped as a whole, the prefix resolved so far would widen the mask
+        bool                  entryValid = true;
+        PXR_NS::SdfPathVector candidates { PXR_NS::SdfPath::AbsoluteRootPath() };
+        for (const std::string& component : PXR_NS::TfStringTokenize(pattern, "/"))
+        {
+            PXR_NS::SdfPathVector next;
+            if (!hasWildcard(component))
+            {
+                if (!PXR_NS::SdfPath::IsValidIdentifier(component))
+                {
+                    qWarning() << "[UsdDocument] Invalid population mask entry:" << entry;
+                    entryValid = false;
+                    break;
+                }
+                for (const auto& candidate : candidates)
+                {
+                    next.push_back(candidate.AppendChild(PXR_NS::TfToken(component)));
+                }
+            }
+            else
+            {
+                const PXR_NS::TfPatternMatcher matcher(component, true, true);
+                for (const auto& candidate : candidates)
+                {
+                    std::set<PXR_NS::TfToken> names;
+                    for (const auto& layer : layerStack)
+                    {
+                        auto spec = candidate.IsAbsoluteRootPath() ? layer->GetPseudoRoot()
+                                                                   : layer->GetPrimAtPath(candidate);
+                        if (!spec)
+                        {
+                            continue;
+                        }
+                        for (const auto& child : spec->GetNameChildren())
+                        {
+                            names.insert(child->GetNameToken());
+                        }
+                    }
+                    for (const auto& name : names)
+                    {
+                        if (matcher.Match(name.GetString()))
+                        {
+                            next.push_back(candidate.AppendChild(name));
+                        }
+                    }
+                }
+            }
+            candidates.swap(next);
+        }
+
+        if (!entryValid)
+        {
+            continue;
+        }
+
+        if (candidates.empty())
+        {
+            qWarning() << "[UsdDocument] Population mask entry matched no prims:" << entry;
+        }
+
+        for (const auto& path : candidates)
+        {
+            if (!path.IsAbsoluteRootPath())
+            {
+                mask.Add(path);
+            }
+        }
+    }
+
+    return mask;
+}
+
+PXR_NS::SdfLayerHandleVector toHandles(const std::vector<PXR_NS::SdfLayerRefPtr>& layers)
+{
+    return PXR_NS::SdfLayerHandleVector(layers.begin(), layers.end());
+}
+
+bool needsFullPrefetch(const TINKERUSD_NS::StageOpenOptions& options)
+{
+    return options.populationMask.isEmpty()
+        && options.loadPolicy == TINKERUSD_NS::StageOpenOptions::LoadPolicy::LOAD_ALL;
+}
+
+// Opens the root layer and the layers the open options need before composition, composition
+// opens everything else itself. Wildcards of the population mask are expanded against the root
+// layer stack, the parallel prefetch of all dependencies is opt-in. The emulated open latency
+// only applies to layers opened here, so with it set the serial prefetch opens the same layers
+// as the parallel one and both can be measured against each other.
+PXR_NS::SdfLayerRefPtr prefetchLayers(
+    const std::string&                    path,
+    const TINKERUSD_NS::StageOpenOptions& options,
+    const std::atomic<bool>&              cancelled,
+    std::vector<PXR_NS::SdfLayerRefPtr>&  layers,
+    const std::function<void(int)>&       progress)
+{
+    const bool emulatedLatency = PXR_NS::TfGetEnvSetting(TINKERUSD_LAYER_OPEN_DELAY_MS) > 0;
+    const bool maskWildcards = std::any_of(
+        options.populationMask.begin(), options.populationMask.end(), [](const QString& entry) {
+            return hasWildcard(entry.toStdString());
+        });
+
+    if (!options.parallelPrefetch && !emulatedLatency && !maskWildcards)
+    {
+        PXR_NS::SdfLayerRefPtr rootLayer = openLayer(path);
+        if (rootLayer)
+        {
+            layers.push_back(rootLayer);
+            progress(static_cast<int>(layers.size()));
+        }
+        return rootLayer;
+    }
+
+    const bool fullPrefetch = needsFullPrefetch(options) && (options.parallelPrefetch || emulatedLatency);
+    return resolveLayers(path, !fullPrefetch, options.parallelPrefetch, cancelled, layers, progress);
+}
+
+PXR_NS::UsdStageLoadRules buildLoadRules(const TINKERUSD_NS::StageOpenOptions& options)
+{
+    auto addRules = [](PXR_NS::UsdStageLoadRules& rules, const QStringList& paths, auto rule) {
+        for (const QString& entry : paths)
+        {
+            const std::string path = entry.trimmed().toStdString();
+            if (path.empty())
+            {
+                continue;
+            }
+            if (!PXR_NS::SdfPath::IsValidPathString(path) || path.front() != '/')
+            {
+                qWarning() << "[UsdDocument] Ignoring invalid load rule path:" << entry;
+                continue;
+            }
+            rules.AddRule(PXR_NS::SdfPath(path), rule);
+        }
+    };
+
+    PXR_NS::UsdStageLoadRules rules = PXR_NS::UsdStageLoadRules::LoadNone();
+    addRules(rules, options.loadIncludePaths, PXR_NS::UsdStageLoadRules::AllRule);
+    addRules(rules, options.loadExcludePaths, PXR_NS::UsdStageLoadRules::NoneRule);
+    rules.Minimize();
+
+    return rules;
+}
+
+// composes the stage from an already opened root layer according to the open options.
+PXR_NS::UsdStageRefPtr composeStage(
+    const PXR_NS::SdfLayerRefPtr&              rootLayer,
+    const std::vector<PXR_NS::SdfLayerRefPtr>& layers,
+    const TINKERUSD_NS::StageOpenOptions&      options)
+{
+    using LoadPolicy = TINKERUSD_NS::StageOpenOptions::LoadPolicy;
+
+    // load rules are applied once the stage exists, so payloads are never pulled in twice
+    const auto initialLoadSet = options.loadPolicy == LoadPolicy::LOAD_ALL ? PXR_NS::UsdStage::LoadAll
+                                                                           : PXR_NS::UsdStage::LoadNone;
+
+    PXR_NS::UsdStageRefPtr stage;
+    if (options.populationMask.isEmpty())
+    {
+        stage = PXR_NS::UsdStage::Open(rootLayer, initialLoadSet);
+    }
+    else
+    {
+        const auto mask = buildPopulationMask(toHandles(layers), options.populationMask);
+        qDebug() << "[UsdDocument] Using population mask:" << QString::fromStdString(PXR_NS::TfStringify(mask));
+        stage = PXR_NS::UsdStage::OpenMasked(rootLayer, mask, initialLoadSet);
+    }
+
+    if (stage && options.loadPolicy == LoadPolicy::LOAD_BY_RULES)
+    {
+        const auto rules = buildLoadRules(options);
+        qDebug() << "[UsdDocument] Using load rules:" << QString::fromStdString(PXR_NS::TfStringify(rules));
+        stage->SetLoadRules(rules);
+    }
+
+    return stage;
+}
+
+} // namespace
 
 namespace TINKERUSD_NS
 {
 
 UsdDocument::UsdDocument(QObject* parent)
     : QObject(parent)
+    , m_layerSaver(new LayerSaver(this))
 {
+    setActiveDocument(this);
+
+    connect(m_layerSaver, &LayerSaver::saveFinished, this, &UsdDocument::onSaveFinished);
+
     qDebug() << "[UsdDocument] Created.";
 }
 
+UsdDocument::~UsdDocument()
+{
+    cancelOpenStage();
+    waitForPendingOpen();
+
+    // the application is closing normally, the journals are not needed anymore
+    UsdEditJournal::instance().stopAll(true);
+    m_editJournals.clear();
+
+    // the inverse edits of the stacks refer to layers released with the stages
+    UndoManager::instance().setActiveStack(nullptr);
+    m_undoStacks.clear();
+
+    // release cached stages while the USD registries are still alive
+    StageCache::instance().clear();
+
+    if (activeDocument() == this)
+    {
+        setActiveDocument(nullptr);
+    }
+}
+
 PXR_NS::UsdStageRefPtr UsdDocument::createNewStageInMemory()
 {
     qDebug() << "[UsdDocument] Creating new in-memory stage...";
 
-    m_stage = PXR_NS::UsdStage::CreateInMemory();
+    cancelOpenStage();
 
-    if (m_stage)
+    auto stage = PXR_NS::UsdStage::CreateInMemory();
+
+    if (stage)
     {
         qDebug() << "[UsdDocument] New stage created successfully.";
-        emit stageOpened("untitled");
+        setCurrentStage(stage, "untitled");
+    }
+    else
+    {
+        qCritical() << "[UsdDocument] Failed to create in-memory stage.";
+        return nullptr;
+    }
 
-        // clear undo stack
-        UndoManager::instance().undoStack()->clear();
+    return m_stage;
+}
 
-        auto targetLayer = m_stage->GetEditTarget().GetLayer();
-        UsdUndoManager::instance().trackLayerStates(targetLayer);
+PXR_NS::UsdStageRefPtr UsdDocument::openStage(const QString& path, const StageOpenOptions& options)
+{
+    qDebug() << "[UsdDocument] Opening stage from file:" << path;
 
-        qDebug() << "[UsdDocument] Undo stack cleared and tracking layer:"
-                 << QString::fromStdString(targetLayer->GetIdentifier());
+    cancelOpenStage();
+
+    const QString cacheKey = StageCache::makeKey(path, options);
+    if (openCachedStage(cacheKey, path))
+    {
+        return m_stage;
+    }
+
+    const std::atomic<bool>             cancelled { false };
+    std::vector<PXR_NS::SdfLayerRefPtr> layers;
+    PXR_NS::UsdStageRefPtr              stage;
+    if (auto rootLayer = prefetchLayers(path.toStdString(), options, cancelled, layers, [](int) {}))
+    {
+        stage = composeStage(rootLayer, layers, options);
+    }
+
+    if (stage)
+    {
+        qDebug() << "[UsdDocument] Stage opened successfully.";
+        StageCache::instance().insert(cacheKey, stage, StageCache::layerFileSizes(stage));
+        setCurrentStage(stage, path);
     }
     else
     {
-        qCritical() << "[UsdDocument] Failed to create in-memory stage.";
+        qCritical() << "[UsdDocument] Failed to open stage:" << path;
         return nullptr;
     }
 
     return m_stage;
 }
 
-PXR_NS::UsdStageRefPtr UsdDocument::openStage(const QString& path)
+void UsdDocument::openStageAsync(const QString& path, const StageOpenOptions& options)
 {
-    qDebug() << "[UsdDocument] Opening stage from file:" << path;
+    qDebug() << "[UsdDocument] Opening stage asynchronously from file:" << path;
+
+    // only the most recent request is allowed to replace the current stage
+    cancelOpenStage();
+
+    QDateTime checkedAt;
+    if (auto stage = StageCache::instance().find(StageCache::makeKey(path, options), &checkedAt))
+    {
+        openCachedStageAsync(stage, path, checkedAt);
+        return;
+    }
+
+    auto           cancelled = std::make_shared<std::atomic<bool>>(false);
+    const uint64_t generation = ++m_openGeneration;
+    m_openCancelled = cancelled;
+
+    QThread* thread = QThread::create([this, path, options, cancelled, generation]() {
+        // the progress callback runs on the prefetch workers when the prefetch is parallel
+        std::vector<PXR_NS::SdfLayerRefPtr> layers;
+        PXR_NS::SdfLayerRefPtr              rootLayer
+            = prefetchLayers(path.toStdString(), options, *cancelled, layers, [&](int count) {
+                  emit stageOpenProgress(path, count, 0);
+              });
+        const int layersResolved = static_cast<int>(layers.size());
+
+        PXR_NS::UsdStageRefPtr stage;
+        if (rootLayer && !*cancelled)
+        {
+            // composition itself cannot be interrupted, cancellation is honored right after it
+            stage = composeStage(rootLayer, layers, options);
+        }
+
+        if (stage && !*cancelled)
+        {
+            int primsComposed = 0;
+            for (const auto& prim : PXR_NS::UsdPrimRange::Stage(stage, PXR_NS::UsdPrimAllPrimsPredicate))
+            {
+                (void)prim;
+                if (++primsComposed % PRIM_PROGRESS_INTERVAL == 0)
+                {
+                    if (*cancelled)
+                    {
+                        break;
+                    }
+                    emit stageOpenProgress(path, layersResolved, primsComposed);
+                }
+            }
+            emit stageOpenProgress(path, layersResolved, primsComposed);
+        }
+
+        if (stage && !*cancelled)
+        {
+            // the camera frames the stage bounds as soon as it is shown
+            auto boundsCache = BoundsCache::forStage(stage);
+            boundsCache->setTime(Timeline::initialTimeCode(stage));
+            boundsCache->warmUp();
+        }
+
+        if (*cancelled)
+        {
+            // release the partially composed stage here rather than on the GUI thread
+            stage.Reset();
+        }
+
+        const StageCache::LayerSizes layerSizes = stage ? StageCache::layerFileSizes(stage) : StageCache::LayerSizes();
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, stage, path, options, layerSizes]() {
+                onAsyncOpenFinished(generation, stage, path, options, layerSizes);
+            },
+            Qt::QueuedConnection);
+    });
 
-    m_stage = PXR_NS::UsdStage::Open(path.toStdString(), PXR_NS::UsdStage::LoadAll);
+    // the thread is parented so that the destructor can wait for it
+    thread->setParent(this);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    thread->start();
+}
+
+void UsdDocument::openCachedStageAsync(
+    const PXR_NS::UsdStageRefPtr& stage,
+    const QString&                path,
+    const QDateTime&              checkedAt)
+{
+    qDebug() << "[UsdDocument] Stage found in cache, checking its layers on disk.";
 
+    auto           cancelled = std::make_shared<std::atomic<bool>>(false);
+    const uint64_t generation = ++m_openGeneration;
+    m_openCancelled = cancelled;
+
+    // layers the current stage reads as well are reloaded on the GUI thread, where it is read
+    std::unordered_set<const PXR_NS::SdfLayer*> currentLayers;
     if (m_stage)
     {
-        qDebug() << "[UsdDocument] Stage opened successfully.";
-        emit stageOpened(path);
+        for (const auto& layer : m_stage->GetUsedLayers())
+        {
+            currentLayers.insert(get_pointer(layer));
+        }
+    }
+
+    QThread* thread = QThread::create([this, stage, path, checkedAt, cancelled, generation, currentLayers]() {
+        const QDateTime              now = QDateTime::currentDateTime();
+        PXR_NS::SdfLayerRefPtrVector ownLayers;
+        PXR_NS::SdfLayerRefPtrVector sharedLayers;
+        for (const auto& layer : StageCache::modifiedLayers(stage, checkedAt))
+        {
+            (currentLayers.count(get_pointer(layer)) ? sharedLayers : ownLayers).push_back(layer);
+        }
+
+        const bool reloaded = !*cancelled && StageCache::reloadLayers(ownLayers);
+
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, stage, path, now, sharedLayers, reloaded]() {
+                onCachedOpenFinished(generation, stage, path, now, sharedLayers, reloaded);
+            },
+            Qt::QueuedConnection);
+    });
+
+    thread->setParent(this);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    thread->start();
+}
+
+void UsdDocument::cancelOpenStage()
+{
+    if (!m_openCancelled)
+    {
+        return;
+    }
+
+    if (!m_openCancelled->exchange(true))
+    {
+        qDebug() << "[UsdDocument] Cancelling pending stage open.";
+    }
+
+    m_openCancelled.reset();
+}
+
+bool UsdDocument::expandPopulationMask(const QStringList& paths)
+{
+    if (!m_stage)
+    {
+        return false;
+    }
+
+    const PXR_NS::UsdStagePopulationMask currentMask = m_stage->GetPopulationMask();
+    if (currentMask.IncludesSubtree(PXR_NS::SdfPath::AbsoluteRootPath()))
+    {
+        qDebug() << "[UsdDocument] Stage is fully populated, nothing to expand.";
+        return false;
+    }
+
+    const auto addedMask = buildPopulationMask(m_stage->GetLayerStack(false), paths);
+    if (addedMask.IsEmpty())
+    {
+        return false;
+    }
+
+    const auto newMask = currentMask.GetUnion(addedMask);
+    if (newMask == currentMask)
+    {
+        return false;
+    }
+
+    qDebug() << "[UsdDocument] Expanding population mask to:" << QString::fromStdString(PXR_NS::TfStringify(newMask));
+
+    Timeline::instance().stopPrefetch();
+    m_stage->SetPopulationMask(newMask);
+
+    // the stage no longer is what its cache key describes
+    StageCache::instance().erase(m_stage);
+
+    emit stagePopulationChanged();
+
+    return true;
+}
+
+void UsdDocument::loadPayloads(const PXR_NS::SdfPathSet& paths)
+{
+    if (!m_stage || paths.empty())
+    {
+        return;
+    }
+
+    Timeline::instance().stopPrefetch();
+    m_stage->LoadAndUnload(paths, PXR_NS::SdfPathSet());
+    StageCache::instance().erase(m_stage);
+
+    emit stagePopulationChanged();
+}
+
+void UsdDocument::unloadPayloads(const PXR_NS::SdfPathSet& paths)
+{
+    if (!m_stage || paths.empty())
+    {
+        return;
+    }
+
+    Timeline::instance().stopPrefetch();
+    m_stage->LoadAndUnload(PXR_NS::SdfPathSet(), paths);
+    StageCache::instance().erase(m_stage);
+
+    emit stagePopulationChanged();
+}
+
+bool UsdDocument::isOpeningStage() const { return m_openCancelled != nullptr; }
+
+void UsdDocument::waitForPendingOpen()
+{
+    for (QThread* thread : findChildren<QThread*>(Qt::FindDirectChildrenOnly))
+    {
+        thread->wait();
+    }
+}
+
+void UsdDocument::onAsyncOpenFinished(
+    uint64_t                      generation,
+    PXR_NS::UsdStageRefPtr        stage,
+    const QString&                path,
+    const StageOpenOptions&       options,
+    const StageCache::LayerSizes& layerSizes)
+{
+    // a newer request (or a synchronous open) superseded this one. The progress of a
+    // newer request still running stays on screen.
+    if (generation != m_openGeneration || !m_openCancelled)
+    {
+        qDebug() << "[UsdDocument] Discarding cancelled stage open:" << path;
+        if (!m_openCancelled)
+        {
+            emit stageOpenCancelled(path);
+        }
+        return;
+    }
+
+    m_openCancelled.reset();
 
+    if (!stage)
+    {
+        qCritical() << "[UsdDocument] Failed to open stage:" << path;
+        emit stageOpenFailed(path);
+        return;
+    }
+
+    qDebug() << "[UsdDocument] Stage opened successfully.";
+    StageCache::instance().insert(StageCache::makeKey(path, options), stage, layerSizes);
+    setCurrentStage(stage, path);
+}
+
+void UsdDocument::onCachedOpenFinished(
+    uint64_t                            generation,
+    PXR_NS::UsdStageRefPtr              stage,
+    const QString&                      path,
+    const QDateTime&                    checkedAt,
+    const PXR_NS::SdfLayerRefPtrVector& sharedLayers,
+    bool                                reloaded)
+{
+    // the layers left unchecked are checked again by the next open
+    if (generation != m_openGeneration || !m_openCancelled)
+    {
+        qDebug() << "[UsdDocument] Discarding cancelled stage open:" << path;
+        if (!m_openCancelled)
+        {
+            emit stageOpenCancelled(path);
+        }
+        return;
+    }
+
+    m_openCancelled.reset();
+
+    StageCache::instance().markChecked(stage, checkedAt);
+    activateCachedStage(stage, path, sharedLayers, reloaded);
+}
+
+bool UsdDocument::openCachedStage(const QString& cacheKey, const QString& path)
+{
+    QDateTime checkedAt;
+    auto      stage = StageCache::instance().find(cacheKey, &checkedAt);
+    if (!stage)
+    {
+        return false;
+    }
+
+    qDebug() << "[UsdDocument] Stage found in cache.";
+
+    const QDateTime now = QDateTime::currentDateTime();
+    const auto      modifiedLayers = StageCache::modifiedLayers(stage, checkedAt);
+    StageCache::instance().markChecked(stage, now);
+    activateCachedStage(stage, path, modifiedLayers, false);
+    return true;
+}
+
+void UsdDocument::activateCachedStage(
+    const PXR_NS::UsdStageRefPtr&       stage,
+    const QString&                      path,
+    const PXR_NS::SdfLayerRefPtrVector& modifiedLayers,
+    bool                                reloaded)
+{
+    if (!modifiedLayers.empty())
+    {
+        // the stage must not be read while its layers are read again
+        Timeline::instance().stopPrefetch();
+        reloaded = StageCache::reloadLayers(modifiedLayers) || reloaded;
+    }
+
+    setCurrentStage(stage, path);
+
+    // the history of the stage does not apply to the content read again
+    if (reloaded)
+    {
         UndoManager::instance().undoStack()->clear();
+    }
+}
+
+QUndoStack* UsdDocument::undoStackFor(const PXR_NS::UsdStageRefPtr& stage)
+{
+    // the stacks of released stages go with them, the layers their edits refer to are gone
+    m_undoStacks.erase(
+        std::remove_if(
+            m_undoStacks.begin(), m_undoStacks.end(), [](const auto& entry) { return !entry.first; }),
+        m_undoStacks.end());
+
+    for (const auto& entry : m_undoStacks)
+    {
+        if (entry.first == stage)
+        {
+            return entry.second.get();
+        }
+    }
+
+    m_undoStacks.emplace_back(stage, std::make_unique<QUndoStack>());
+    return m_undoStacks.back().second.get();
+}
+
+void UsdDocument::setCurrentStage(const PXR_NS::UsdStageRefPtr& stage, const QString& displayPath)
+{
+    m_stage = stage;
+
+    // observers of stageOpened read the stage at its start time
+    Timeline::instance().setStage(m_stage);
+
+    emit stageOpened(displayPath);
+
+    UndoManager::instance().setActiveStack(undoStackFor(m_stage));
+
+    auto targetLayer = m_stage->GetEditTarget().GetLayer();
+    UsdUndoManager::instance().trackLayerStates(targetLayer);
+
+    qDebug() << "[UsdDocument] Undo stack of the stage activated and tracking layer:"
+             << QString::fromStdString(targetLayer->GetIdentifier());
 
-        auto targetLayer = m_stage->GetEditTarget().GetLayer();
-        UsdUndoManager::instance().trackLayerStates(targetLayer);
+    // layers of stages released since, e.g. evicted from the stage cache, do not need their
+    // journal anymore. Layers of cached stages keep theirs until they are saved.
+    releaseEditJournals();
 
-        qDebug() << "[UsdDocument] Undo stack cleared and tracking layer:"
-                 << QString::fromStdString(targetLayer->GetIdentifier());
+    // the edit target is journaled, and any layer of the stack a previous session left edits for
+    for (const auto& layer : m_stage->GetLayerStack(false))
+    {
+        const QString journalPath = editJournalPath(layer);
+        if (layer == targetLayer
+            || (!journalPath.isEmpty()
+                && (QFile::exists(journalPath) || !recoveredJournalPaths(journalPath).isEmpty())))
+        {
+            startEditJournal(layer);
+        }
+    }
+}
+
+void UsdDocument::setEditJournalEnabled(bool enabled)
+{
+    m_editJournalEnabled = enabled;
+    if (!enabled)
+    {
+        UsdEditJournal::instance().stopAll(true);
+        m_editJournals.clear();
+    }
+}
+
+void UsdDocument::startEditJournal(const PXR_NS::SdfLayerHandle& layer)
+{
+    auto& journal = UsdEditJournal::instance();
+    if (!m_editJournalEnabled || !layer || journal.isRecording(layer))
+    {
+        return;
+    }
+
+    const QString journalPath = editJournalPath(layer);
+    if (journalPath.isEmpty())
+    {
+        return;
+    }
+
+    // another session editing the same layer owns its journal, only age is not a reason to
+    // take the lock over
+    auto lock = std::make_unique<QLockFile>(journalPath + ".lock");
+    lock->setStaleLockTime(0);
+    if (!lock->tryLock(0))
+    {
+        qWarning() << "[UsdDocument] Edit journal used by another session, edits are not journaled:"
+                   << QString::fromStdString(layer->GetIdentifier());
+        return;
+    }
+
+    // the journal records the edits reported by the undo state delegate
+    UsdUndoManager::instance().trackLayerStates(layer);
+
+    // a journal left behind means a previous session did not end normally. It is moved
+    // aside so that it can be replayed while this session records into a fresh one. Journals
+    // moved aside earlier and never replayed nor discarded are kept, each under its own name.
+    if (UsdEditJournal::containsEdits(journalPath.toStdString()))
+    {
+        const QString recoveredPath = QString("%1.recovered.%2")
+                                          .arg(journalPath)
+                                          .arg(QDateTime::currentDateTimeUtc().toString("yyyyMMddhhmmsszzz"));
+        if (!QFile::rename(journalPath, recoveredPath))
+        {
+            qWarning() << "[UsdDocument] Failed to move edit journal aside:" << journalPath;
+        }
+    }
+
+    if (journal.start(layer, journalPath.toStdString()))
+    {
+        qDebug() << "[UsdDocument] Journaling edits to:" << journalPath;
+        m_editJournals.push_back({ layer, layer->GetIdentifier(), std::move(lock) });
+    }
+
+    // every pending journal is offered, until it is replayed or discarded
+    for (const auto& recoveredPath : recoveredJournalPaths(journalPath))
+    {
+        qWarning() << "[UsdDocument] Found unsaved edits from a previous session:" << recoveredPath;
+        emit editJournalFound(QString::fromStdString(layer->GetRealPath()), recoveredPath);
+    }
+}
+
+void UsdDocument::releaseEditJournals()
+{
+    for (auto it = m_editJournals.begin(); it != m_editJournals.end();)
+    {
+        if (it->layer)
+        {
+            ++it;
+            continue;
+        }
+
+        // the journal file is removed before its lock is released
+        UsdEditJournal::instance().stop(it->identifier, true);
+        it = m_editJournals.erase(it);
+    }
+}
+
+bool UsdDocument::recoverEdits(const QString& journalPath)
+{
+    if (!m_stage)
+    {
+        return false;
+    }
+
+    // the layer of the journal is tracked and journaled already, its replayed edits are
+    // journaled again
+    UsdEditJournal::ReplayStats stats;
+    const bool                  replayed = UsdEditJournal::replay(journalPath.toStdString(), &stats);
+    if (replayed)
+    {
+        qDebug() << "[UsdDocument] Recovered" << stats.records << "edits in" << stats.milliseconds << "ms,"
+                 << stats.skipped << "skipped.";
+        if (stats.incomplete)
+        {
+            qWarning() << "[UsdDocument] Only the edits journaled before an edit that could not be journaled were"
+                       << "recovered from:" << journalPath;
+        }
+        QFile::remove(journalPath);
     }
     else
     {
-        qCritical() << "[UsdDocument] Failed to open stage:" << path;
-        return nullptr;
+        qCritical() << "[UsdDocument] Failed to recover edits from:" << journalPath;
     }
 
-    return m_stage;
+    return replayed;
+}
+
+void UsdDocument::discardRecoveredEdits(const QString& journalPath)
+{
+    qDebug() << "[UsdDocument] Discarding edits from a previous session:" << journalPath;
+
+    QFile::remove(journalPath);
+}
+
+void UsdDocument::onSaveFinished(int savedCount, int failedCount)
+{
+    // layers edited while they were being saved are still dirty and keep their journal
+    for (const auto& entry : m_editJournals)
+    {
+        if (entry.layer && !entry.layer->IsDirty())
+        {
+            UsdEditJournal::instance().reset(entry.layer);
+        }
+    }
+
+    const QString saveAsPath = std::exchange(m_saveAsPath, QString());
+    if (!saveAsPath.isEmpty() && savedCount > 0 && failedCount == 0)
+    {
+        openSavedStage(saveAsPath);
+    }
+}
+
+void UsdDocument::openSavedStage(const QString& filePath)
+{
+    if (!m_stage)
+    {
+        return;
+    }
+
+    // a layer already open from that file is stale now
+    const std::string            path = filePath.toStdString();
+    const bool                   wasOpen = PXR_NS::SdfLayer::Find(path) != nullptr;
+    const PXR_NS::SdfLayerRefPtr rootLayer = PXR_NS::SdfLayer::FindOrOpen(path);
+    if (rootLayer && wasOpen)
+    {
+        rootLayer->Reload();
+    }
+
+    // the document goes on with the saved file, populated and loaded like the stage it was saved
+    // from. The session layer and the sublayers are the same in memory, unsaved edits included.
+    PXR_NS::UsdStageRefPtr stage;
+    if (rootLayer)
+    {
+        stage = PXR_NS::UsdStage::OpenMasked(
+            rootLayer, m_stage->GetSessionLayer(), m_stage->GetPopulationMask(), PXR_NS::UsdStage::LoadNone);
+    }
+    if (!stage)
+    {
+        qCritical() << "[UsdDocument] Failed to open the saved stage:" << filePath;
+        return;
+    }
+    stage->SetLoadRules(m_stage->GetLoadRules());
+
+    const PXR_NS::SdfLayerHandle editLayer = m_stage->GetEditTarget().GetLayer();
+    if (editLayer != m_stage->GetRootLayer() && stage->HasLocalLayer(editLayer))
+    {
+        stage->SetEditTarget(PXR_NS::UsdEditTarget(editLayer));
+    }
+
+    setCurrentStage(stage, filePath);
 }
 
 PXR_NS::UsdStageRefPtr UsdDocument::getCurrentStage() const
@@ -82,12 +1067,36 @@ PXR_NS::SdfLayerRefPtr UsdDocument::getRootLayer() const
     return m_stage->GetRootLayer();
 }
 
+int UsdDocument::saveDirtyLayers()
+{
+    qDebug() << "[UsdDocument] Saving dirty layers...";
+
+    return m_layerSaver->saveDirtyLayers(m_stage);
+}
+
+bool UsdDocument::saveStageAs(const QString& filePath, const PXR_NS::SdfLayer::FileFormatArguments& args)
+{
+    qDebug() << "[UsdDocument] Saving stage as:" << filePath;
+
+    if (!m_layerSaver->saveRootLayerAs(m_stage, filePath, args))
+    {
+        return false;
+    }
+    m_saveAsPath = filePath;
+    return true;
+}
+
+LayerSaver* UsdDocument::layerSaver() const { return m_layerSaver; }
+
 void UsdDocument::setEditTargetLayer(PXR_NS::SdfLayerHandle layer)
 {
     qDebug() << "[UsdDocument] Setting new edit target layer:"
              << QString::fromStdString(layer->GetIdentifier());
 
     m_stage->SetEditTarget(PXR_NS::UsdEditTarget(layer));
+
+    UsdUndoManager::instance().trackLayerStates(layer);
+    startEditJournal(layer);
 }
 
 } // namespace TINKERUSD_NS
@@ -1,22 +1,99 @@
 #pragma once
 
+#include "stageCache.h"
+
 #include <QObject>
+#include <QStringList>
+#include <atomic>
+#include <memory>
 #include <pxr/usd/sdf/layer.h>
+#include <pxr/usd/sdf/path.h>
 #include <pxr/usd/usd/stage.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class QDateTime;
+class QLockFile;
+class QUndoStack;
 
 namespace TINKERUSD_NS
 {
 
+class LayerSaver;
+
+// options controlling how a stage is opened.
+struct StageOpenOptions
+{
+    enum class LoadPolicy
+    {
+        LOAD_ALL,
+        LOAD_NONE,
+        LOAD_BY_RULES
+    };
+
+    // absolute prim paths or per-component glob patterns (e.g. /World/Sets/Tree_*) the stage
+    // population is restricted to. The whole stage is populated when empty.
+    QStringList populationMask;
+
+    // which payloads are loaded when the stage is opened.
+    LoadPolicy loadPolicy { LoadPolicy::LOAD_ALL };
+
+    // with LOAD_BY_RULES, payloads under loadIncludePaths are loaded except for
+    // the ones under loadExcludePaths. Everything else is left unloaded.
+    QStringList loadIncludePaths;
+    QStringList loadExcludePaths;
+
+    // open the layers the stage depends on concurrently before composing it. Pays off on high
+    // latency file systems. Otherwise composition opens them one after the other.
+    bool parallelPrefetch { false };
+};
+
 class UsdDocument : public QObject
 {
     Q_OBJECT
 public:
     UsdDocument(QObject* parent = nullptr);
-    virtual ~UsdDocument() = default;
+    virtual ~UsdDocument();
 
     PXR_NS::UsdStageRefPtr createNewStageInMemory();
 
-    PXR_NS::UsdStageRefPtr openStage(const QString& path);
+    PXR_NS::UsdStageRefPtr openStage(const QString& path, const StageOpenOptions& options = {});
+
+    // composes the stage on a worker thread. The current stage stays active until
+    // the new one is ready, at which point stageOpened is emitted.
+    void openStageAsync(const QString& path, const StageOpenOptions& options = {});
+
+    // widens the population mask of the current stage without reopening it.
+    bool expandPopulationMask(const QStringList& paths);
+
+    // loads or unloads the payloads at and below the given prims of the current stage.
+    void loadPayloads(const PXR_NS::SdfPathSet& paths);
+    void unloadPayloads(const PXR_NS::SdfPathSet& paths);
+
+    // request cancellation of a pending asynchronous open.
+    void cancelOpenStage();
+
+    bool isOpeningStage() const;
+
+    // saves every dirty layer of the current stage's layer stack in the background.
+    // Progress is reported by layerSaver().
+    int saveDirtyLayers();
+
+    // writes the root layer of the current stage to another file, in the background. Once
+    // written the file is opened in place of the current stage, see stageOpened.
+    bool saveStageAs(const QString& filePath, const PXR_NS::SdfLayer::FileFormatArguments& args = {});
+
+    LayerSaver* layerSaver() const;
+
+    // replays the edits journaled by a previous session on top of the current stage,
+    // then removes the journal. See editJournalFound.
+    bool recoverEdits(const QString& journalPath);
+    void discardRecoveredEdits(const QString& journalPath);
+
+    // edits are journaled for crash recovery unless disabled, e.g. for headless runs that
+    // must not touch the journals of an interactive session.
+    void setEditJournalEnabled(bool enabled);
 
     void setEditTargetLayer(PXR_NS::SdfLayerHandle layer);
 
@@ -27,8 +104,66 @@ public:
 signals:
     void stageOpened(const QString& filePath);
 
+    // emitted from the worker thread while an asynchronous open is in flight.
+    void stageOpenProgress(const QString& filePath, int layersResolved, int primsComposed);
+    void stageOpenCancelled(const QString& filePath);
+    void stageOpenFailed(const QString& filePath);
+
+    // the set of populated or loaded prims changed without the stage being replaced.
+    void stagePopulationChanged();
+
+    // a previous session ended without saving its edits to a layer of the stage that was just opened.
+    // The journal is kept and offered again on later opens until it is recovered or discarded.
+    void editJournalFound(const QString& filePath, const QString& journalPath);
+
+private:
+    void setCurrentStage(const PXR_NS::UsdStageRefPtr& stage, const QString& displayPath);
+    void onAsyncOpenFinished(
+        uint64_t                      generation,
+        PXR_NS::UsdStageRefPtr        stage,
+        const QString&                path,
+        const StageOpenOptions&       options,
+        const StageCache::LayerSizes& layerSizes);
+    bool        openCachedStage(const QString& cacheKey, const QString& path);
+    void openCachedStageAsync(const PXR_NS::UsdStageRefPtr& stage, const QString& path, const QDateTime& checkedAt);
+    void onCachedOpenFinished(
+        uint64_t                            generation,
+        PXR_NS::UsdStageRefPtr              stage,
+        const QString&                      path,
+        const QDateTime&                    checkedAt,
+        const PXR_NS::SdfLayerRefPtrVector& sharedLayers,
+        bool                                reloaded);
+    void activateCachedStage(
+        const PXR_NS::UsdStageRefPtr&       stage,
+        const QString&                      path,
+        const PXR_NS::SdfLayerRefPtrVector& modifiedLayers,
+        bool                                reloaded);
+    QUndoStack* undoStackFor(const PXR_NS::UsdStageRefPtr& stage);
+    void waitForPendingOpen();
+    void startEditJournal(const PXR_NS::SdfLayerHandle& layer);
+    void releaseEditJournals();
+    void onSaveFinished(int savedCount, int failedCount);
+    void openSavedStage(const QString& filePath);
+
 private:
-    PXR_NS::UsdStageRefPtr m_stage;
+    PXR_NS::UsdStageRefPtr             m_stage;
+    LayerSaver*                        m_layerSaver;
+    std::shared_ptr<std::atomic<bool>> m_openCancelled;
+    uint64_t                           m_openGeneration { 0 };
+    QString                            m_saveAsPath; // file of the Save As in progress
+
+    // a layer journaled by this session, the lock keeps other sessions away from its journal
+    struct EditJournal
+    {
+        PXR_NS::SdfLayerHandle     layer;
+        std::string                identifier;
+        std::unique_ptr<QLockFile> lock;
+    };
+    std::vector<EditJournal> m_editJournals;
+    bool                     m_editJournalEnabled { true };
+
+    // every stage keeps its own history, a cached stage comes back with its edits undoable
+    std::vector<std::pair<PXR_NS::UsdStageWeakPtr, std::unique_ptr<QUndoStack>>> m_undoStacks;
 };
 
-} // namespace TINKERUSD_NS
\ No newline at end of file
+} // namespace TINKERUSD_NS
@@ -1,36 +1,191 @@
 #include "utils.h"
 
+#include "boundsCache.h"
 #include "globalSelection.h"
+#include "pathExpressionQuery.h"
+#include "stageCache.h"
+#include "timeline.h"
+#include "usdDocument.h"
 
+#include <QDebug>
 #include <pxr/base/gf/bbox3d.h>
-#include <pxr/usd/usdGeom/bboxCache.h>
 #include <pxr/usdImaging/usdImaging/delegate.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#include <cstdio>
+#endif
+
 namespace TINKERUSD_NS
 {
 
+namespace
+{
+UsdDocument* s_activeDocument = nullptr;
+
+QStringList toQStringList(const std::vector<std::string>& strings)
+{
+    QStringList result;
+    for (const auto& str : strings)
+    {
+        result.append(QString::fromStdString(str));
+    }
+    return result;
+}
+} // namespace
+
+UsdDocument* activeDocument() { return s_activeDocument; }
+
+void setActiveDocument(UsdDocument* document) { s_activeDocument = document; }
+
+PXR_NS::UsdStageRefPtr currentStage() { return s_activeDocument ? s_activeDocument->getCurrentStage() : nullptr; }
+
+PXR_NS::UsdStageRefPtr openDocumentStage(const std::string& path, const std::vector<std::string>& populationMask)
+{
+    if (!s_activeDocument)
+    {
+        return nullptr;
+    }
+
+    StageOpenOptions options;
+    options.populationMask = toQStringList(populationMask);
+    return s_activeDocument->openStage(QString::fromStdString(path), options);
+}
+
+bool expandDocumentPopulationMask(const std::vector<std::string>& paths)
+{
+    return s_activeDocument ? s_activeDocument->expandPopulationMask(toQStringList(paths)) : false;
+}
+
+size_t stageCacheHits() { return StageCache::instance().hits(); }
+
+size_t stageCacheMisses() { return StageCache::instance().misses(); }
+
+size_t stageCacheMemoryUsage() { return StageCache::instance().memoryUsage(); }
+
+size_t stageCacheSize() { return StageCache::instance().size(); }
+
+void setStageCacheMemoryBudget(size_t bytes) { StageCache::instance().setMemoryBudget(bytes); }
+
+void clearStageCache() { StageCache::instance().clear(); }
+
 PXR_NS::UsdPrim selectedPrim() { return GlobalSelection::instance().prim(); }
 
 PXR_NS::SdfPath selectedPrimPath() { return GlobalSelection::instance().path(); }
 
+PXR_NS::SdfPathVector selectedPrimPaths()
+{
+    const auto& paths = GlobalSelection::instance().paths();
+    return PXR_NS::SdfPathVector(paths.begin(), paths.end());
+}
+
+void setSelectedPrimPaths(const PXR_NS::SdfPathVector& paths) { GlobalSelection::instance().replace(paths); }
+
+PXR_NS::SdfPathVector matchPrimPaths(const std::string& expression, bool* valid)
+{
+    PXR_NS::SdfPathVector paths;
+    std::string           error;
+    const bool            matched = matchPathExpression(currentStage(), expression, &paths, &error);
+    if (!matched)
+    {
+        qWarning().noquote() << "Invalid path expression" << QString::fromStdString(expression) << ":"
+                             << QString::fromStdString(error);
+    }
+    if (valid)
+    {
+        *valid = matched;
+    }
+    return paths;
+}
+
+int selectPrimPaths(const std::string& expression)
+{
+    bool                        valid = false;
+    const PXR_NS::SdfPathVector paths = matchPrimPaths(expression, &valid);
+    if (!valid)
+    {
+        return -1;
+    }
+
+    GlobalSelection::instance().replace(paths);
+    return static_cast<int>(paths.size());
+}
+
 GfBBox3d stageBbox(const PXR_NS::UsdStageRefPtr& stage)
 {
-    UsdGeomBBoxCache bboxCache(UsdTimeCode::Default(), UsdGeomImageable::GetOrderedPurposeTokens());
-    return bboxCache.ComputeWorldBound(stage->GetPseudoRoot());
+    auto boundsCache = BoundsCache::forStage(stage);
+    if (!boundsCache)
+    {
+        return GfBBox3d();
+    }
+
+    boundsCache->setTime(Timeline::instance().timeCode());
+    return boundsCache->worldBound(stage->GetPseudoRoot());
 }
 
 GfBBox3d globalSelectionBbox(const PXR_NS::UsdStageRefPtr& stage)
 {
-    UsdGeomBBoxCache bboxCache(UsdTimeCode::Default(), UsdGeomImageable::GetOrderedPurposeTokens());
-    auto selectedPrim = stage->GetPrimAtPath(GlobalSelection::instance().path());
-    if (!selectedPrim.IsValid())
+    auto boundsCache = BoundsCache::forStage(stage);
+    if (!boundsCache)
     {
         return GfBBox3d();
     }
 
-    GfBBox3d worldbbox = bboxCache.ComputeWorldBound(selectedPrim);
-    GfBBox3d bbox;
-    return GfBBox3d::Combine(bbox, worldbbox);
+    boundsCache->setTime(Timeline::instance().timeCode());
+    return boundsCache->worldBound(GlobalSelection::instance().paths());
+}
+
+double currentTime() { return Timeline::instance().currentTime(); }
+
+void setCurrentTime(double time) { Timeline::instance().setCurrentTime(time); }
+
+size_t boundsCacheHits()
+{
+    auto boundsCache = BoundsCache::forStage(currentStage());
+    return boundsCache ? boundsCache->hits() : 0;
+}
+
+size_t boundsCacheMisses()
+{
+    auto boundsCache = BoundsCache::forStage(currentStage());
+    return boundsCache ? boundsCache->misses() : 0;
+}
+
+double residentMemoryMb()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.WorkingSetSize / (1024.0 * 1024.0);
+    }
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count)
+        == KERN_SUCCESS)
+    {
+        return info.resident_size / (1024.0 * 1024.0);
+    }
+#else
+    if (std::FILE* file = std::fopen("/proc/self/statm", "r"))
+    {
+        long size = 0;
+        long resident = 0;
+        const int read = std::fscanf(file, "%ld %ld", &size, &resident);
+        std::fclose(file);
+        if (read == 2)
+        {
+            return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+        }
+    }
+#endif
+    return -1.0;
 }
 
-} // namespace TINKERUSD_NS
\ No newline at end of file
+} // namespace TINKERUSD_NS
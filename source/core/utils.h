@@ -10,20 +10,94 @@ PXR_NAMESPACE_USING_DIRECTIVE
 namespace TINKERUSD_NS
 {
 
+class UsdDocument;
+
+// document the application and the Python API operate on.
+UsdDocument* activeDocument();
+void         setActiveDocument(UsdDocument* document);
+
+// stage of the active document.
+TINKERUSD_PUBLIC
+PXR_NS::UsdStageRefPtr currentStage();
+
 TINKERUSD_PUBLIC
 PXR_NS::UsdPrim selectedPrim();
 
 TINKERUSD_PUBLIC
 PXR_NS::SdfPath selectedPrimPath();
 
+// every selected prim path, in path order.
+TINKERUSD_PUBLIC
+PXR_NS::SdfPathVector selectedPrimPaths();
+
+// replaces the selection, the last path becomes the lead one.
+TINKERUSD_PUBLIC
+void setSelectedPrimPaths(const PXR_NS::SdfPathVector& paths);
+
+// prims of the current stage matched by a path expression, see matchPathExpression.
+// valid is set to false when the expression is invalid, a warning is printed then.
+TINKERUSD_PUBLIC
+PXR_NS::SdfPathVector matchPrimPaths(const std::string& expression, bool* valid = nullptr);
+
+// replaces the selection with the prims matched by a path expression. Returns the number
+// of selected prims, or -1 when the expression is invalid.
+TINKERUSD_PUBLIC
+int selectPrimPaths(const std::string& expression);
+
 #define DISALLOW_COPY_MOVE_ASSIGNMENT(ClassName)     \
     ClassName(const ClassName&) = delete;            \
     ClassName& operator=(const ClassName&) = delete; \
     ClassName(const ClassName&&) = delete;           \
     ClassName&& operator=(const ClassName&&) = delete;
 
+// opens a stage in the active document. An empty population mask opens the whole stage.
+TINKERUSD_PUBLIC
+PXR_NS::UsdStageRefPtr openDocumentStage(const std::string& path, const std::vector<std::string>& populationMask);
+
+// widens the population mask of the active document's stage.
+TINKERUSD_PUBLIC
+bool expandDocumentPopulationMask(const std::vector<std::string>& paths);
+
+// stage cache statistics and configuration, see StageCache. Memory usage and budget are
+// estimated from layer file sizes.
+TINKERUSD_PUBLIC
+size_t stageCacheHits();
+
+TINKERUSD_PUBLIC
+size_t stageCacheMisses();
+
+TINKERUSD_PUBLIC
+size_t stageCacheMemoryUsage();
+
+TINKERUSD_PUBLIC
+size_t stageCacheSize();
+
+TINKERUSD_PUBLIC
+void setStageCacheMemoryBudget(size_t bytes);
+
+TINKERUSD_PUBLIC
+void clearStageCache();
+
+// world bounds served by the BoundsCache of the stage.
 GfBBox3d stageBbox(const PXR_NS::UsdStageRefPtr& stage);
 
 GfBBox3d globalSelectionBbox(const PXR_NS::UsdStageRefPtr& stage);
 
+// current time of the stage, see Timeline.
+TINKERUSD_PUBLIC
+double currentTime();
+
+TINKERUSD_PUBLIC
+void setCurrentTime(double time);
+
+// BoundsCache statistics of the current stage.
+TINKERUSD_PUBLIC
+size_t boundsCacheHits();
+
+TINKERUSD_PUBLIC
+size_t boundsCacheMisses();
+
+// resident memory of the process in megabytes, or a negative value when it cannot be queried.
+double residentMemoryMb();
+
 } // namespace TINKERUSD_NS
\ No newline at end of file
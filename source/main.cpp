@@ -1,7 +1,9 @@
+#include "batch/batchRunner.h"
 #include "ui/mainWindow.h"
 #include "ui/logger/loggerWidget.h"
 
 #include <QApplication>
+#include <QCoreApplication>
 #include <QFile>
 #include <QGuiApplication>
 
@@ -9,6 +11,13 @@ using namespace TINKERUSD_NS;
 
 int main(int argc, char** argv)
 {
+    // headless mode never touches the GUI modules
+    if (isBatchMode(argc, argv))
+    {
+        QCoreApplication app(argc, argv);
+        return runBatch(app);
+    }
+
     QGuiApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 
     QApplication app(argc, argv);
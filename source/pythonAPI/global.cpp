@@ -5,15 +5,53 @@
 namespace TINKERUSD_NS
 {
 
-PXR_NS::UsdStageRefPtr stage() { return selectedPrim().GetStage(); }
+PXR_NS::UsdStageRefPtr stage() { return currentStage(); }
 
 PXR_NS::SdfPath primSelPath() { return selectedPrimPath(); }
 
 PXR_NS::UsdPrim primSel()  { return selectedPrim(); }
 
+PXR_NS::SdfPathVector primSelPaths() { return selectedPrimPaths(); }
+
+void setPrimSelPaths(const PXR_NS::SdfPathVector& paths) { setSelectedPrimPaths(paths); }
+
+PXR_NS::SdfPathVector matchPaths(const std::string& expression) { return matchPrimPaths(expression); }
+
+int selectPaths(const std::string& expression) { return selectPrimPaths(expression); }
+
 PXR_NS::SdfLayerHandle editTargetLayer()
 {
 	return stage()->GetEditTarget().GetLayer();
 }
 
+PXR_NS::UsdStageRefPtr openStage(const std::string& path, const std::vector<std::string>& populationMask)
+{
+	return openDocumentStage(path, populationMask);
+}
+
+bool expandPopulationMask(const std::vector<std::string>& paths)
+{
+	return expandDocumentPopulationMask(paths);
+}
+
+size_t cacheHits() { return stageCacheHits(); }
+
+size_t cacheMisses() { return stageCacheMisses(); }
+
+size_t cacheMemoryUsage() { return stageCacheMemoryUsage(); }
+
+size_t cacheSize() { return stageCacheSize(); }
+
+void setCacheMemoryBudget(size_t bytes) { setStageCacheMemoryBudget(bytes); }
+
+void clearCache() { clearStageCache(); }
+
+double time() { return currentTime(); }
+
+void setTime(double time) { setCurrentTime(time); }
+
+size_t boundsHits() { return boundsCacheHits(); }
+
+size_t boundsMisses() { return boundsCacheMisses(); }
+
 } // namespace TINKERUSD_NS
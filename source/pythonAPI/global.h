@@ -6,6 +6,9 @@
 #include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/usd/prim.h>
 
+#include <string>
+#include <vector>
+
 namespace TINKERUSD_NS
 {
 
@@ -18,7 +21,56 @@ PXR_NS::SdfPath primSelPath();
 TINKERUSD_API_PUBLIC
 PXR_NS::UsdPrim primSel();
 
+TINKERUSD_API_PUBLIC
+PXR_NS::SdfPathVector primSelPaths();
+
+TINKERUSD_API_PUBLIC
+void setPrimSelPaths(const PXR_NS::SdfPathVector& paths);
+
+TINKERUSD_API_PUBLIC
+PXR_NS::SdfPathVector matchPaths(const std::string& expression);
+
+TINKERUSD_API_PUBLIC
+int selectPaths(const std::string& expression);
+
 TINKERUSD_API_PUBLIC
 PXR_NS::SdfLayerHandle editTargetLayer();
 
+TINKERUSD_API_PUBLIC
+PXR_NS::UsdStageRefPtr openStage(const std::string& path, const std::vector<std::string>& populationMask);
+
+TINKERUSD_API_PUBLIC
+bool expandPopulationMask(const std::vector<std::string>& paths);
+
+TINKERUSD_API_PUBLIC
+size_t cacheHits();
+
+TINKERUSD_API_PUBLIC
+size_t cacheMisses();
+
+// estimated from the file sizes of the cached layers, shared layers are counted once.
+TINKERUSD_API_PUBLIC
+size_t cacheMemoryUsage();
+
+TINKERUSD_API_PUBLIC
+size_t cacheSize();
+
+TINKERUSD_API_PUBLIC
+void setCacheMemoryBudget(size_t bytes);
+
+TINKERUSD_API_PUBLIC
+void clearCache();
+
+TINKERUSD_API_PUBLIC
+double time();
+
+TINKERUSD_API_PUBLIC
+void setTime(double time);
+
+TINKERUSD_API_PUBLIC
+size_t boundsHits();
+
+TINKERUSD_API_PUBLIC
+size_t boundsMisses();
+
 } // namespace TINKERUSD_NS
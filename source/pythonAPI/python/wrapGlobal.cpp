@@ -11,4 +11,21 @@ void wrapGlobal()
 	def("editTargetLayer", TINKERUSD_NS::editTargetLayer);
 	def("primSel", TINKERUSD_NS::primSel);
 	def("primSelPath", TINKERUSD_NS::primSelPath);
+	def("primSelPaths", TINKERUSD_NS::primSelPaths);
+	def("setPrimSelPaths", TINKERUSD_NS::setPrimSelPaths, arg("paths"));
+	def("matchPaths", TINKERUSD_NS::matchPaths, arg("expression"));
+	def("selectPaths", TINKERUSD_NS::selectPaths, arg("expression"));
+	def("openStage", TINKERUSD_NS::openStage,
+		(arg("path"), arg("populationMask") = std::vector<std::string>()));
+	def("expandPopulationMask", TINKERUSD_NS::expandPopulationMask, arg("paths"));
+	def("stageCacheHits", TINKERUSD_NS::cacheHits);
+	def("stageCacheMisses", TINKERUSD_NS::cacheMisses);
+	def("stageCacheMemoryUsage", TINKERUSD_NS::cacheMemoryUsage);
+	def("stageCacheSize", TINKERUSD_NS::cacheSize);
+	def("setStageCacheMemoryBudget", TINKERUSD_NS::setCacheMemoryBudget, arg("bytes"));
+	def("clearStageCache", TINKERUSD_NS::clearCache);
+	def("time", TINKERUSD_NS::time);
+	def("setTime", TINKERUSD_NS::setTime, arg("time"));
+	def("boundsCacheHits", TINKERUSD_NS::boundsHits);
+	def("boundsCacheMisses", TINKERUSD_NS::boundsMisses);
 }
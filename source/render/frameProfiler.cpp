@@ -0,0 +1,420 @@
+#include "frameProfiler.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+#include <algorithm>
+
+namespace TINKERUSD_NS
+{
+
+namespace
+{
+
+// keys used for the pass columns of the exported files.
+const char* passKey(FrameProfiler::Pass pass)
+{
+    switch (pass)
+    {
+    case FrameProfiler::Pass::FRAME: return "frame";
+    case FrameProfiler::Pass::HYDRA_RENDER: return "hydra_render";
+    case FrameProfiler::Pass::GRID: return "grid";
+    case FrameProfiler::Pass::FBO_BLIT: return "fbo_blit";
+    case FrameProfiler::Pass::HUD: return "hud";
+    default: return "";
+    }
+}
+
+// average and 95th percentile of the non negative values.
+void rollingStats(std::vector<double>& values, double* avg, double* p95)
+{
+    if (values.empty())
+    {
+        return;
+    }
+
+    double sum = 0.0;
+    for (double value : values)
+    {
+        sum += value;
+    }
+    *avg = sum / values.size();
+
+    const size_t rank = std::min(values.size() - 1, static_cast<size_t>(values.size() * 0.95));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    *p95 = values[rank];
+}
+
+QString formatMs(double value)
+{
+    return value < 0.0 ? QStringLiteral("n/a") : QString::number(value, 'f', 2);
+}
+
+} // namespace
+
+FrameProfiler::FrameProfiler()
+    : m_history(HISTORY_SIZE)
+{
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    destroyGL();
+}
+
+const char* FrameProfiler::passName(Pass pass)
+{
+    switch (pass)
+    {
+    case Pass::FRAME: return "Frame";
+    case Pass::HYDRA_RENDER: return "Hydra render";
+    case Pass::GRID: return "Grid";
+    case Pass::FBO_BLIT: return "FBO blit";
+    case Pass::HUD: return "HUD";
+    default: return "";
+    }
+}
+
+void FrameProfiler::destroyGL()
+{
+    if (!m_glFunctionCore)
+    {
+        return;
+    }
+    for (QuerySet& set : m_queries)
+    {
+        if (set.begin[0])
+        {
+            m_glFunctionCore->glDeleteQueries(PASS_COUNT, set.begin.data());
+            m_glFunctionCore->glDeleteQueries(PASS_COUNT, set.end.data());
+        }
+        set = QuerySet();
+    }
+    m_gpuTimers = false;
+}
+
+void FrameProfiler::init(QOpenGLFunctions_4_5_Core* f)
+{
+    if (m_glFunctionCore)
+    {
+        return;
+    }
+    m_glFunctionCore = f;
+
+    // a counter without any bits means the implementation cannot time the GPU.
+    GLint bits = 0;
+    m_glFunctionCore->glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+    if (m_glFunctionCore->glGetError() != GL_NO_ERROR || bits == 0)
+    {
+        qWarning() << "FrameProfiler: GL timer queries are not available, only CPU times are recorded.";
+        return;
+    }
+
+    for (QuerySet& set : m_queries)
+    {
+        m_glFunctionCore->glGenQueries(PASS_COUNT, set.begin.data());
+        m_glFunctionCore->glGenQueries(PASS_COUNT, set.end.data());
+    }
+    m_gpuTimers = true;
+}
+
+FrameProfiler::FrameSample& FrameProfiler::currentSample()
+{
+    return m_history[m_frame % HISTORY_SIZE];
+}
+
+void FrameProfiler::collectGpuResults()
+{
+    for (QuerySet& set : m_queries)
+    {
+        if (!set.pending)
+        {
+            continue;
+        }
+
+        // the frame end timestamp is issued last, once it is available all the others are too.
+        GLint available = 0;
+        const GLuint frameEnd = set.end[static_cast<int>(Pass::FRAME)];
+        m_glFunctionCore->glGetQueryObjectiv(frameEnd, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            continue;
+        }
+        set.pending = false;
+
+        // the sample was overwritten by a newer frame.
+        FrameSample& sample = m_history[set.frame % HISTORY_SIZE];
+        if (sample.frame != set.frame)
+        {
+            continue;
+        }
+
+        for (int i = 0; i < PASS_COUNT; ++i)
+        {
+            if (!set.issued[i])
+            {
+                continue;
+            }
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            m_glFunctionCore->glGetQueryObjectui64v(set.begin[i], GL_QUERY_RESULT, &begin);
+            m_glFunctionCore->glGetQueryObjectui64v(set.end[i], GL_QUERY_RESULT, &end);
+            sample.gpuMs[i] = end >= begin ? (end - begin) / 1.0e6 : -1.0;
+        }
+        if (sample.gpuMs[static_cast<int>(Pass::FRAME)] >= 0.0 && set.frame > m_latestGpuFrame)
+        {
+            m_latestGpuFrameMs = sample.gpuMs[static_cast<int>(Pass::FRAME)];
+            m_latestGpuFrame = set.frame;
+        }
+    }
+}
+
+void FrameProfiler::beginFrame()
+{
+    if (m_gpuTimers)
+    {
+        collectGpuResults();
+    }
+
+    ++m_frame;
+    FrameSample& sample = currentSample();
+    sample.frame = m_frame;
+    sample.cpuMs.fill(-1.0);
+    sample.gpuMs.fill(-1.0);
+
+    // the GPU is more than QUERY_LATENCY frames behind: skip GPU timing rather than waiting.
+    QuerySet& set = m_queries[m_frame % QUERY_LATENCY];
+    m_gpuThisFrame = m_gpuTimers && !set.pending;
+    if (m_gpuThisFrame)
+    {
+        set.frame = m_frame;
+        set.issued.fill(false);
+    }
+
+    m_inFrame = true;
+    beginPass(Pass::FRAME);
+}
+
+void FrameProfiler::endFrame()
+{
+    if (!m_inFrame)
+    {
+        return;
+    }
+    endPass(Pass::FRAME);
+    m_inFrame = false;
+
+    if (m_gpuThisFrame)
+    {
+        m_queries[m_frame % QUERY_LATENCY].pending = true;
+    }
+}
+
+void FrameProfiler::beginPass(Pass pass)
+{
+    if (!m_inFrame)
+    {
+        return;
+    }
+    const int index = static_cast<int>(pass);
+    if (m_gpuThisFrame)
+    {
+        m_glFunctionCore->glQueryCounter(m_queries[m_frame % QUERY_LATENCY].begin[index], GL_TIMESTAMP);
+    }
+    m_cpuBegin[index] = Clock::now();
+}
+
+void FrameProfiler::endPass(Pass pass)
+{
+    if (!m_inFrame)
+    {
+        return;
+    }
+    const int index = static_cast<int>(pass);
+    const std::chrono::duration<double, std::milli> elapsed = Clock::now() - m_cpuBegin[index];
+    currentSample().cpuMs[index] = elapsed.count();
+
+    if (m_gpuThisFrame)
+    {
+        QuerySet& set = m_queries[m_frame % QUERY_LATENCY];
+        m_glFunctionCore->glQueryCounter(set.end[index], GL_TIMESTAMP);
+        set.issued[index] = true;
+    }
+}
+
+size_t FrameProfiler::frameCount() const
+{
+    return std::min<uint64_t>(m_frame, HISTORY_SIZE);
+}
+
+double FrameProfiler::latestFrameMs() const
+{
+    // the current sample is still being recorded while inside a frame
+    const uint64_t frame = m_inFrame ? m_frame - 1 : m_frame;
+    if (frame == 0)
+    {
+        return -1.0;
+    }
+    const double cpuMs = m_history[frame % HISTORY_SIZE].cpuMs[static_cast<int>(Pass::FRAME)];
+    return std::max(cpuMs, m_latestGpuFrameMs);
+}
+
+std::vector<const FrameProfiler::FrameSample*> FrameProfiler::orderedSamples() const
+{
+    std::vector<const FrameSample*> samples;
+    samples.reserve(frameCount());
+
+    const uint64_t first = m_frame - frameCount() + 1;
+    for (uint64_t frame = first; frame <= m_frame; ++frame)
+    {
+        samples.push_back(&m_history[frame % HISTORY_SIZE]);
+    }
+    return samples;
+}
+
+FrameProfiler::Stats FrameProfiler::stats(Pass pass) const
+{
+    const int index = static_cast<int>(pass);
+
+    std::vector<double> cpu;
+    std::vector<double> gpu;
+    cpu.reserve(frameCount());
+    gpu.reserve(frameCount());
+    for (const FrameSample* sample : orderedSamples())
+    {
+        if (sample->cpuMs[index] >= 0.0)
+        {
+            cpu.push_back(sample->cpuMs[index]);
+        }
+        if (sample->gpuMs[index] >= 0.0)
+        {
+            gpu.push_back(sample->gpuMs[index]);
+        }
+    }
+
+    Stats result;
+    rollingStats(cpu, &result.cpuAvgMs, &result.cpuP95Ms);
+    rollingStats(gpu, &result.gpuAvgMs, &result.gpuP95Ms);
+    return result;
+}
+
+QStringList FrameProfiler::hudLines() const
+{
+    QStringList lines;
+    lines << QStringLiteral("Frame profile, avg / p95 ms over %1 frames%2")
+                 .arg(frameCount())
+                 .arg(m_gpuTimers ? "" : " (no GPU timers)");
+
+    for (int i = 0; i < PASS_COUNT; ++i)
+    {
+        const Pass  pass = static_cast<Pass>(i);
+        const Stats passStats = stats(pass);
+        lines << QStringLiteral("%1: cpu %2 / %3  gpu %4 / %5")
+                     .arg(passName(pass))
+                     .arg(formatMs(passStats.cpuAvgMs))
+                     .arg(formatMs(passStats.cpuP95Ms))
+                     .arg(formatMs(passStats.gpuAvgMs))
+                     .arg(formatMs(passStats.gpuP95Ms));
+    }
+    return lines;
+}
+
+QString FrameProfiler::toCsv() const
+{
+    QString     csv;
+    QTextStream stream(&csv);
+
+    stream << "frame";
+    for (int i = 0; i < PASS_COUNT; ++i)
+    {
+        const char* key = passKey(static_cast<Pass>(i));
+        stream << ',' << key << "_cpu_ms," << key << "_gpu_ms";
+    }
+    stream << '\n';
+
+    // passes that did not run, or have no GPU result, are left empty.
+    for (const FrameSample* sample : orderedSamples())
+    {
+        stream << sample->frame;
+        for (int i = 0; i < PASS_COUNT; ++i)
+        {
+            stream << ',';
+            if (sample->cpuMs[i] >= 0.0)
+            {
+                stream << QString::number(sample->cpuMs[i], 'f', 4);
+            }
+            stream << ',';
+            if (sample->gpuMs[i] >= 0.0)
+            {
+                stream << QString::number(sample->gpuMs[i], 'f', 4);
+            }
+        }
+        stream << '\n';
+    }
+    return csv;
+}
+
+QString FrameProfiler::toJson() const
+{
+    QJsonObject summary;
+    for (int i = 0; i < PASS_COUNT; ++i)
+    {
+        const Stats passStats = stats(static_cast<Pass>(i));
+
+        QJsonObject passSummary;
+        passSummary["cpu_avg_ms"] = passStats.cpuAvgMs;
+        passSummary["cpu_p95_ms"] = passStats.cpuP95Ms;
+        passSummary["gpu_avg_ms"] = passStats.gpuAvgMs;
+        passSummary["gpu_p95_ms"] = passStats.gpuP95Ms;
+        summary[passKey(static_cast<Pass>(i))] = passSummary;
+    }
+
+    QJsonArray frames;
+    for (const FrameSample* sample : orderedSamples())
+    {
+        QJsonObject frame;
+        frame["frame"] = static_cast<qint64>(sample->frame);
+        for (int i = 0; i < PASS_COUNT; ++i)
+        {
+            if (sample->cpuMs[i] < 0.0)
+            {
+                continue;
+            }
+            QJsonObject pass;
+            pass["cpu_ms"] = sample->cpuMs[i];
+            if (sample->gpuMs[i] >= 0.0)
+            {
+                pass["gpu_ms"] = sample->gpuMs[i];
+            }
+            frame[passKey(static_cast<Pass>(i))] = pass;
+        }
+        frames.append(frame);
+    }
+
+    QJsonObject root;
+    root["gpu_timers"] = m_gpuTimers;
+    root["summary"] = summary;
+    root["frames"] = frames;
+    return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Indented));
+}
+
+bool FrameProfiler::exportToFile(const QString& filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        qWarning() << "FrameProfiler: could not write" << filePath;
+        return false;
+    }
+
+    const bool json = QFileInfo(filePath).suffix().compare("json", Qt::CaseInsensitive) == 0;
+    file.write((json ? toJson() : toCsv()).toUtf8());
+    return true;
+}
+
+} // namespace TINKERUSD_NS
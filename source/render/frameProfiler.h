@@ -0,0 +1,148 @@
+#pragma once
+
+#include <QOpenGLFunctions_4_5_Core>
+#include <QString>
+#include <QStringList>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace TINKERUSD_NS
+{
+
+// per-pass CPU and GPU timings of the viewport frames.
+// CPU time is measured with a steady clock around each pass. GPU time comes from GL_TIMESTAMP
+// queries issued before and after each pass. Query results are read back a few frames later, and
+// only once the driver reports them available, so profiling never waits on the GPU. Frames whose
+// results are not back by the time their query objects are due for reuse simply have no GPU time.
+// When the context has no timer queries (e.g. some software GL implementations) only CPU times
+// are recorded.
+class FrameProfiler final
+{
+public:
+    enum class Pass
+    {
+        FRAME,
+        HYDRA_RENDER,
+        GRID,
+        FBO_BLIT,
+        HUD,
+        COUNT
+    };
+
+    // rolling statistics over the recorded frames, in milliseconds. Negative when there is no sample.
+    struct Stats
+    {
+        double cpuAvgMs { -1.0 };
+        double cpuP95Ms { -1.0 };
+        double gpuAvgMs { -1.0 };
+        double gpuP95Ms { -1.0 };
+    };
+
+    // times the enclosing block as the given pass.
+    class Scope
+    {
+    public:
+        Scope(FrameProfiler& profiler, Pass pass)
+            : m_profiler(profiler)
+            , m_pass(pass)
+        {
+            m_profiler.beginPass(m_pass);
+        }
+        ~Scope() { m_profiler.endPass(m_pass); }
+
+    private:
+        FrameProfiler& m_profiler;
+        Pass           m_pass;
+    };
+
+    FrameProfiler();
+    ~FrameProfiler();
+
+    // initialize GL resources (call after a valid GL context is current).
+    void init(QOpenGLFunctions_4_5_Core* f);
+
+    // release GL resources (call while the context they were created in is current).
+    void destroyGL();
+
+    bool hasGpuTimers() const { return m_gpuTimers; }
+
+    void beginFrame();
+    void endFrame();
+
+    void beginPass(Pass pass);
+    void endPass(Pass pass);
+
+    Stats  stats(Pass pass) const;
+    size_t frameCount() const;
+
+    // the longer of the CPU time of the last frame and the most recent GPU frame time, which
+    // lags a few frames behind. Negative before the first frame.
+    double latestFrameMs() const;
+
+    // number of the frame being recorded, or of the last one outside of a frame.
+    uint64_t frame() const { return m_frame; }
+
+    // whether the GPU time latestFrameMs uses was measured on the given frame or a later one.
+    // Always true without GPU timers.
+    bool hasGpuTimeSince(uint64_t frame) const { return !m_gpuTimers || m_latestGpuFrame >= frame; }
+
+    // one line per pass, for the viewport HUD.
+    QStringList hudLines() const;
+
+    // writes the recorded frames and their statistics. The format follows the file suffix:
+    // .json, anything else is written as CSV.
+    bool exportToFile(const QString& filePath) const;
+
+    static const char* passName(Pass pass);
+
+private:
+    static constexpr int PASS_COUNT = static_cast<int>(Pass::COUNT);
+
+    // number of frames kept for the rolling statistics and the export.
+    static constexpr int HISTORY_SIZE = 240;
+
+    // number of frames in flight before their query objects are reused.
+    static constexpr int QUERY_LATENCY = 4;
+
+    struct FrameSample
+    {
+        uint64_t                       frame { 0 };
+        std::array<double, PASS_COUNT> cpuMs;
+        std::array<double, PASS_COUNT> gpuMs;
+    };
+
+    struct QuerySet
+    {
+        std::array<GLuint, PASS_COUNT> begin {};
+        std::array<GLuint, PASS_COUNT> end {};
+        std::array<bool, PASS_COUNT>   issued {};
+        uint64_t                       frame { 0 };
+        bool                           pending { false };
+    };
+
+    void                            collectGpuResults();
+    FrameSample&                    currentSample();
+    std::vector<const FrameSample*> orderedSamples() const;
+    QString                         toCsv() const;
+    QString                         toJson() const;
+
+private:
+    QOpenGLFunctions_4_5_Core* m_glFunctionCore { nullptr };
+
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<FrameSample>                  m_history;
+    std::array<QuerySet, QUERY_LATENCY>       m_queries;
+    std::array<Clock::time_point, PASS_COUNT> m_cpuBegin;
+    uint64_t                                  m_frame { 0 };
+    double                                    m_latestGpuFrameMs { -1.0 };
+    uint64_t                                  m_latestGpuFrame { 0 }; // frame m_latestGpuFrameMs was measured on
+    bool                                      m_inFrame { false };
+    bool                                      m_gpuTimers { false };
+    bool                                      m_gpuThisFrame { false };
+};
+
+} // namespace TINKERUSD_NS
@@ -2,27 +2,83 @@
 
 #include "camera/usdCamera.h"
 
-#include <QOpenGLShaderProgram>
+#include <pxr/base/gf/matrix4d.h>
 #include <pxr/base/gf/matrix4f.h>
+#include <pxr/base/gf/vec3f.h>
 
 namespace
 {
+// a single triangle covering the screen, positions come from the vertex index
 const char* vertexShaderSrc = R"(
         #version 450 core
-        layout(location = 0) in vec3 aPos;
-        uniform mat4 uViewMatrix;
-        uniform mat4 uProjectionMatrix;
+        out vec2 vNdc;
         void main() {
-            gl_Position = uProjectionMatrix * uViewMatrix * vec4(aPos, 1.0);
+            vNdc = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+            gl_Position = vec4(vNdc, 0.0, 1.0);
         }
     )";
 
 const char* fragmentShaderSrc = R"(
         #version 450 core
-        uniform vec4 uColor;
+        in vec2 vNdc;
+        uniform mat4  uViewProjection;
+        uniform mat4  uInverseViewProjection;
+        uniform vec3  uCameraPosition;
+        uniform int   uUpAxis;
+        uniform float uCellSize;
+        uniform float uFadeCells;
+        uniform vec3  uBaseColor;
+        uniform vec3  uMajorColor;
         out vec4 FragColor;
+
+        vec3 unproject(float z) {
+            vec4 point = uInverseViewProjection * vec4(vNdc, z, 1.0);
+            return point.xyz / point.w;
+        }
+
+        // coverage of the lines every cellSize, about a pixel wide at any distance
+        float gridLines(vec2 coord, float cellSize) {
+            vec2 cell = coord / cellSize;
+            vec2 lines = abs(fract(cell - 0.5) - 0.5) / max(fwidth(cell), vec2(1e-6));
+            return 1.0 - min(min(lines.x, lines.y), 1.0);
+        }
+
         void main() {
-            FragColor = uColor;
+            // ground plane through the origin, across the up axis
+            vec3  nearPoint = unproject(-1.0);
+            vec3  ray = unproject(1.0) - nearPoint;
+            float t = abs(ray[uUpAxis]) > 1e-9 ? -nearPoint[uUpAxis] / ray[uUpAxis] : -1.0;
+            vec3  position = nearPoint + max(t, 0.0) * ray;
+            vec2  coord = uUpAxis == 0 ? position.yz : (uUpAxis == 1 ? position.xz : position.xy);
+
+            // ten cells of the current level span about the camera height
+            float height = max(abs(uCameraPosition[uUpAxis]), uCellSize);
+            float lod = max(0.0, log(height / (uCellSize * 10.0)) / log(10.0));
+            float level = floor(lod);
+            float blend = lod - level;
+            float cellSize = uCellSize * pow(10.0, level);
+
+            // minor lines fade out as the next level takes over, whose major lines become minor
+            float minor = gridLines(coord, cellSize) * (1.0 - blend);
+            float middle = gridLines(coord, cellSize * 10.0);
+            float major = gridLines(coord, cellSize * 100.0);
+
+            vec4 color = vec4(uBaseColor, minor);
+            color = mix(color, vec4(mix(uMajorColor, uBaseColor, blend), 1.0), middle);
+            color = mix(color, vec4(uMajorColor, 1.0), major);
+
+            float fadeDistance = uFadeCells * uCellSize * pow(10.0, lod);
+            float cameraDistance = distance(position, uCameraPosition);
+            color.a *= 1.0 - smoothstep(0.5 * fadeDistance, fadeDistance, cameraDistance);
+
+            // derivatives above need the whole quad, fragments off the plane are dropped last
+            if (t <= 0.0 || color.a < 1.0 / 255.0) {
+                discard;
+            }
+
+            vec4 clip = uViewProjection * vec4(position, 1.0);
+            gl_FragDepth = clamp(clip.z / clip.w * 0.5 + 0.5, 0.0, 1.0);
+            FragColor = color;
         }
     )";
 } // namespace
@@ -32,7 +88,6 @@ namespace TINKERUSD_NS
 
 Grid::Grid()
     : m_vao(0)
-    , m_vbo(0)
     , m_shaderProgram(0)
     , m_size(30.0f)
     , m_cellCount(30)
@@ -47,10 +102,6 @@ Grid::~Grid()
     {
         glDeleteVertexArrays(1, &m_vao);
     }
-    if (m_vbo)
-    {
-        glDeleteBuffers(1, &m_vbo);
-    }
     if (m_shaderProgram)
     {
         glDeleteProgram(m_shaderProgram);
@@ -62,8 +113,8 @@ void Grid::initialize()
     initializeOpenGLFunctions();
     setupShader();
 
+    // the core profile needs a vertex array bound even without attributes
     glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_vbo);
 }
 
 void Grid::setupShader()
@@ -83,6 +134,15 @@ void Grid::setupShader()
 
     glDeleteShader(vert);
     glDeleteShader(frag);
+
+    m_uniforms.viewProjection = glGetUniformLocation(m_shaderProgram, "uViewProjection");
+    m_uniforms.inverseViewProjection = glGetUniformLocation(m_shaderProgram, "uInverseViewProjection");
+    m_uniforms.cameraPosition = glGetUniformLocation(m_shaderProgram, "uCameraPosition");
+    m_uniforms.upAxis = glGetUniformLocation(m_shaderProgram, "uUpAxis");
+    m_uniforms.cellSize = glGetUniformLocation(m_shaderProgram, "uCellSize");
+    m_uniforms.fadeCells = glGetUniformLocation(m_shaderProgram, "uFadeCells");
+    m_uniforms.baseColor = glGetUniformLocation(m_shaderProgram, "uBaseColor");
+    m_uniforms.majorColor = glGetUniformLocation(m_shaderProgram, "uMajorColor");
 }
 
 void Grid::draw(const UsdCamera* camera, const TfToken& upAxis)
@@ -92,74 +152,51 @@ void Grid::draw(const UsdCamera* camera, const TfToken& upAxis)
         return;
     }
 
-    std::vector<GLfloat> baseLines;
-    std::vector<GLfloat> majorLines;
-
-    const float extent = m_size * m_cellCount;
-    const bool  yUp = (upAxis == TfToken("Y"));
-    const bool  zUp = (upAxis == TfToken("Z"));
-    const bool  xUp = (upAxis == TfToken("X"));
+    const GfMatrix4d viewMatrix = camera->getViewMatrix();
+    const GfMatrix4d viewProjection = viewMatrix * camera->getProjectionMatrix();
+    const GfMatrix4f viewProjectionF(viewProjection);
+    const GfMatrix4f inverseViewProjectionF(viewProjection.GetInverse());
+    const GfVec3f    cameraPosition(viewMatrix.GetInverse().ExtractTranslation());
 
-    for (auto i = -m_cellCount; i <= m_cellCount; ++i)
+    int upAxisIndex = 1;
+    if (upAxis == TfToken("Z"))
     {
-        float pos = i * m_size;
-        // TODO: hight every 10th row for now
-        bool isHighlight = (i % 10 == 0);
-
-        auto& target = isHighlight ? majorLines : baseLines;
-
-        if (yUp)
-        {
-            target.insert(
-                target.end(),
-                { pos, 0.0f, -extent, pos, 0.0f, extent, -extent, 0.0f, pos, extent, 0.0f, pos });
-        }
-        else if (zUp)
-        {
-            target.insert(
-                target.end(),
-                { pos, -extent, 0.0f, pos, extent, 0.0f, -extent, pos, 0.0f, extent, pos, 0.0f });
-        }
-        else if (xUp)
-        {
-            target.insert(
-                target.end(),
-                { 0.0f, pos, -extent, 0.0f, pos, extent, 0.0f, -extent, pos, 0.0f, extent, pos });
-        }
+        upAxisIndex = 2;
+    }
+    else if (upAxis == TfToken("X"))
+    {
+        upAxisIndex = 0;
     }
 
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-
-    auto drawLines = [this, camera](const std::vector<GLfloat>& lines, const QColor& color) {
-        glBufferData(GL_ARRAY_BUFFER, lines.size() * sizeof(float), lines.data(), GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-        glEnableVertexAttribArray(0);
-
-        glUseProgram(m_shaderProgram);
-
-        GfMatrix4f viewMatrix(camera->getViewMatrix());
-        GfMatrix4f projMatrix(camera->getProjectionMatrix());
-
-        glUniformMatrix4fv(
-            glGetUniformLocation(m_shaderProgram, "uViewMatrix"), 1, GL_FALSE, viewMatrix.data());
-        glUniformMatrix4fv(
-            glGetUniformLocation(m_shaderProgram, "uProjectionMatrix"), 1, GL_FALSE, projMatrix.data());
-
-        glUniform4f(
-            glGetUniformLocation(m_shaderProgram, "uColor"),
-            color.redF(),
-            color.greenF(),
-            color.blueF(),
-            1.0f);
+    glUseProgram(m_shaderProgram);
 
-        glDrawArrays(GL_LINES, 0, lines.size() / 3);
+    glUniformMatrix4fv(m_uniforms.viewProjection, 1, GL_FALSE, viewProjectionF.data());
+    glUniformMatrix4fv(m_uniforms.inverseViewProjection, 1, GL_FALSE, inverseViewProjectionF.data());
+    glUniform3fv(m_uniforms.cameraPosition, 1, cameraPosition.data());
+    glUniform1i(m_uniforms.upAxis, upAxisIndex);
+    glUniform1f(m_uniforms.cellSize, m_size);
+    glUniform1f(m_uniforms.fadeCells, static_cast<float>(m_cellCount));
+    const auto setColor = [this](GLint location, const QColor& color) {
+        glUniform3f(location, color.redF(), color.greenF(), color.blueF());
     };
+    setColor(m_uniforms.baseColor, m_baseLinesColor);
+    setColor(m_uniforms.majorColor, m_majorLinesColor);
 
-    drawLines(baseLines, m_baseLinesColor);
-    drawLines(majorLines, m_majorLinesColor);
+    // the grid is blended over the scene and depth tested against it, without hiding anything
+    const GLboolean blendEnabled = glIsEnabled(GL_BLEND);
+    glEnable(GL_BLEND);
+    glDepthMask(GL_FALSE);
 
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
     glBindVertexArray(0);
+
+    glDepthMask(GL_TRUE);
+    if (!blendEnabled)
+    {
+        glDisable(GL_BLEND);
+    }
+
     glUseProgram(0);
 }
 
@@ -11,6 +11,11 @@ namespace TINKERUSD_NS
 {
 
 class UsdCamera;
+
+// ground grid drawn by a fragment shader over a full screen triangle. Each pixel intersects its
+// camera ray with the ground plane, so the grid has no extent and nothing is uploaded per frame.
+// The cell size steps by powers of ten with the camera height, blending between levels, and the
+// grid fades out with the distance to the camera.
 class Grid : public QOpenGLFunctions_4_5_Core
 {
 public:
@@ -20,7 +25,9 @@ public:
     void initialize();
     void draw(const UsdCamera* camera, const TfToken& upAxis);
 
+    // size of the finest cells, used while the camera is close to the ground.
     void setSize(float size);
+    // distance in cells at which the grid has faded out.
     void setCellCount(int count);
     void setBaseLinesColor(const QColor& color);
     void setMajorLinesColor(const QColor& color);
@@ -29,13 +36,25 @@ private:
     void setupShader();
 
 private:
-    GLuint m_vao;
-    GLuint m_vbo;
-    GLuint m_shaderProgram;
-    float  m_size;
-    int    m_cellCount;
-    QColor m_baseLinesColor;
-    QColor m_majorLinesColor;
+    struct Uniforms
+    {
+        GLint viewProjection { -1 };
+        GLint inverseViewProjection { -1 };
+        GLint cameraPosition { -1 };
+        GLint upAxis { -1 };
+        GLint cellSize { -1 };
+        GLint fadeCells { -1 };
+        GLint baseColor { -1 };
+        GLint majorColor { -1 };
+    };
+
+    GLuint   m_vao;
+    GLuint   m_shaderProgram;
+    Uniforms m_uniforms;
+    float    m_size;
+    int      m_cellCount;
+    QColor   m_baseLinesColor;
+    QColor   m_majorLinesColor;
 };
 
-} // namespace TINKERUSD_NS
\ No newline at end of file
+} // namespace TINKERUSD_NS
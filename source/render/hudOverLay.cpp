@@ -1,14 +1,28 @@
 #include "hudOverlay.h"
 
 #include <QPainter>
-#include <QFont>
 #include <QFontMetrics>
 #include <QColor>
-#include <QRect>
 
-#ifndef GL_BGRA
-#define GL_BGRA 0x80E1
-#endif
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+// the atlas grows in height only, rows of glyphs are added at the bottom
+constexpr int ATLAS_WIDTH = 512;
+constexpr int ATLAS_INITIAL_HEIGHT = 128;
+constexpr int ATLAS_MAX_HEIGHT = 4096;
+
+// texels kept empty around each glyph, so neighbours never bleed into each other
+constexpr int GLYPH_PADDING = 2;
+
+// opaque block at the atlas origin, sampled by untextured quads such as the background
+constexpr int   WHITE_BLOCK_SIZE = 4;
+constexpr float WHITE_TEXEL = 2.0f;
+} // namespace
 
 namespace TINKERUSD_NS
 {
@@ -25,8 +39,10 @@ void HudOverlay::destroyGL()
     }
     if (m_tex)  { m_glFunctionCore->glDeleteTextures(1, &m_tex);  m_tex  = 0; }
     if (m_vbo)  { m_glFunctionCore->glDeleteBuffers(1,  &m_vbo);  m_vbo  = 0; }
+    if (m_instanceVbo) { m_glFunctionCore->glDeleteBuffers(1, &m_instanceVbo); m_instanceVbo = 0; }
     if (m_vao)  { m_glFunctionCore->glDeleteVertexArrays(1, &m_vao); m_vao = 0; }
     if (m_prog) { m_glFunctionCore->glDeleteProgram(m_prog); m_prog = 0; }
+    m_instanceCapacity = 0;
     m_inited = false;
 }
 
@@ -35,130 +51,318 @@ void HudOverlay::init(QOpenGLFunctions_4_5_Core* f)
     m_glFunctionCore = f;
     if (m_inited || !m_glFunctionCore) return;
 
-    // quad (0,0)-(1,1)
+    // quad (0,0)-(1,1), stretched over each instance rectangle
     float verts[] = {
-        // pos   // uv
-        0.f, 0.f, 0.f, 0.f,
-        1.f, 0.f, 1.f, 0.f,
-        0.f, 1.f, 0.f, 1.f,
-        1.f, 1.f, 1.f, 1.f
+        0.f, 0.f,
+        1.f, 0.f,
+        0.f, 1.f,
+        1.f, 1.f
     };
 
     m_glFunctionCore->glGenVertexArrays(1, &m_vao);
     m_glFunctionCore->glGenBuffers(1, &m_vbo);
+    m_glFunctionCore->glGenBuffers(1, &m_instanceVbo);
     m_glFunctionCore->glBindVertexArray(m_vao);
+
     m_glFunctionCore->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
     m_glFunctionCore->glBufferData(GL_ARRAY_BUFFER, sizeof(verts), verts, GL_STATIC_DRAW);
     m_glFunctionCore->glEnableVertexAttribArray(0);
-    m_glFunctionCore->glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    m_glFunctionCore->glEnableVertexAttribArray(1);
-    m_glFunctionCore->glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    m_glFunctionCore->glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+    // per glyph attributes
+    m_glFunctionCore->glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    const auto instanceAttribute = [this](GLuint index, size_t offset) {
+        m_glFunctionCore->glEnableVertexAttribArray(index);
+        const GLsizei stride = sizeof(Instance);
+        m_glFunctionCore->glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+        m_glFunctionCore->glVertexAttribDivisor(index, 1);
+    };
+    instanceAttribute(1, offsetof(Instance, rect));
+    instanceAttribute(2, offsetof(Instance, uv));
+    instanceAttribute(3, offsetof(Instance, color));
+
     m_glFunctionCore->glBindBuffer(GL_ARRAY_BUFFER, 0);
     m_glFunctionCore->glBindVertexArray(0);
 
     const char* vs = R"(
-        #version 140
+        #version 330 core
         in vec2 aPos;
-        in vec2 aUV;
+        in vec4 aRect;  // x, y, w, h in device pixels from the HUD origin
+        in vec4 aUV;    // atlas texels
+        in vec4 aColor;
         out vec2 vUV;
-        uniform vec4 uRect; // x, y, w, h in NDC
+        out vec4 vColor;
+        uniform vec2 uViewport;  // device pixels
+        uniform vec2 uOrigin;    // top-left of the HUD, device pixels
+        uniform vec2 uAtlasSize;
         void main() {
-            vec2 ndc = vec2(uRect.x + aPos.x * uRect.z,
-                            uRect.y + aPos.y * uRect.w);
-            gl_Position = vec4(ndc, 0.0, 1.0);
-            vUV = vec2(aUV.x, 1.0 - aUV.y);
+            vec2 px = uOrigin + aRect.xy + aPos * aRect.zw;
+            gl_Position = vec4(px.x / uViewport.x * 2.0 - 1.0, 1.0 - px.y / uViewport.y * 2.0, 0.0, 1.0);
+            vUV = mix(aUV.xy, aUV.zw, aPos) / uAtlasSize;
+            vColor = aColor;
         }
     )";
     const char* fs = R"(
-        #version 140
+        #version 330 core
         in vec2 vUV;
+        in vec4 vColor;
         out vec4 fragColor;
         uniform sampler2D uTex;
         void main() {
-            fragColor = texture(uTex, vUV);
+            fragColor = vec4(vColor.rgb, vColor.a * texture(uTex, vUV).r);
         }
     )";
     m_prog = createProgram(vs, fs);
-    m_uRect = m_glFunctionCore->glGetUniformLocation(m_prog, "uRect");
-    m_uTex  = m_glFunctionCore->glGetUniformLocation(m_prog,  "uTex");
+    m_uViewport  = m_glFunctionCore->glGetUniformLocation(m_prog, "uViewport");
+    m_uOrigin    = m_glFunctionCore->glGetUniformLocation(m_prog, "uOrigin");
+    m_uAtlasSize = m_glFunctionCore->glGetUniformLocation(m_prog, "uAtlasSize");
+    m_uTex       = m_glFunctionCore->glGetUniformLocation(m_prog, "uTex");
 
+    // glyphs are drawn texel for texel, no filtering needed
     m_glFunctionCore->glGenTextures(1, &m_tex);
     m_glFunctionCore->glBindTexture(GL_TEXTURE_2D, m_tex);
-    m_glFunctionCore->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    m_glFunctionCore->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    m_glFunctionCore->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    m_glFunctionCore->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     m_glFunctionCore->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     m_glFunctionCore->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     m_glFunctionCore->glBindTexture(GL_TEXTURE_2D, 0);
 
+    // a context created again starts from an empty texture and buffer
+    m_atlasResized = true;
+    markDirty(0, m_instances.size());
+
     m_inited = true;
 }
 
-void HudOverlay::updateText(const QString& text, float dpr, int basePx)
+void HudOverlay::setFont(float dpr, int basePx)
+{
+    if (dpr == m_dpr && basePx == m_basePx) {
+        return;
+    }
+    m_dpr = dpr;
+    m_basePx = basePx;
+
+    m_font = QFont();
+    m_font.setPixelSize(int(basePx * std::max(1.f, dpr)));
+
+    QFontMetrics fm(m_font);
+    m_lineHeight = fm.height();
+    m_ascent = fm.ascent();
+    m_margin = int(6 * dpr);
+
+    // glyphs of another size, every line is laid out again
+    resetAtlas();
+    m_lines.clear();
+    m_instances.clear();
+}
+
+void HudOverlay::resetAtlas()
 {
-    QFont font;
-    font.setPixelSize(int(basePx * std::max(1.f, dpr)));
+    m_atlas = QImage(ATLAS_WIDTH, ATLAS_INITIAL_HEIGHT, QImage::Format_Grayscale8);
+    m_atlas.fill(0);
 
-    QFontMetrics fm(font);
-    const int margin = int(6 * dpr);
+    QPainter p(&m_atlas);
+    p.fillRect(QRect(0, 0, WHITE_BLOCK_SIZE, WHITE_BLOCK_SIZE), Qt::white);
+    p.end();
 
-    // multi-line text
-    const QStringList lines = text.split('\n');
-    int maxW = 0;
-    for (const QString& line : lines) {
-        maxW = qMax(maxW, fm.horizontalAdvance(line));
+    m_glyphs.clear();
+    m_atlasCursor = QPoint(WHITE_BLOCK_SIZE + GLYPH_PADDING, 0);
+    m_atlasDirtyRect = QRect();
+    m_atlasResized = true;
+}
+
+const HudOverlay::Glyph& HudOverlay::glyph(QChar c)
+{
+    auto it = m_glyphs.find(c.unicode());
+    if (it != m_glyphs.end()) {
+        return it.value();
     }
-    const int lineH = fm.height();
-    const int textW = maxW;
-    const int textH = lineH * qMax(1, int(lines.size()));
 
-    const int W = textW + 2 * margin;
-    const int H = textH + 2 * margin;
+    QFontMetrics fm(m_font);
+    const QRect  bounds = fm.boundingRect(c);
 
-    QImage img(W, H, QImage::Format_ARGB32_Premultiplied);
-    img.fill(Qt::transparent);
+    Glyph glyph;
+    glyph.advance = fm.horizontalAdvance(c);
+    glyph.offsetX = std::min(0, bounds.left());
+    const int w = std::max(1, std::max(glyph.advance, bounds.right() + 1) - glyph.offsetX);
+    const int h = m_lineHeight;
 
-    QPainter p(&img);
-    p.setRenderHint(QPainter::TextAntialiasing, true);
+    // next row when this one is full, a taller atlas when the rows are
+    if (m_atlasCursor.x() + w > m_atlas.width()) {
+        m_atlasCursor = QPoint(0, m_atlasCursor.y() + h + GLYPH_PADDING);
+    }
+    if (m_atlasCursor.y() + h > m_atlas.height()) {
+        int height = m_atlas.height();
+        while (m_atlasCursor.y() + h > height) {
+            height *= 2;
+        }
+        if (height > ATLAS_MAX_HEIGHT) {
+            // no room left, the character is drawn as an empty advance
+            return m_glyphs.insert(c.unicode(), glyph).value();
+        }
 
-    // background
-    p.setPen(Qt::NoPen);
-    p.setBrush(QColor(0, 0, 0, 160));
-    p.drawRoundedRect(QRect(0, 0, W, H), int(2 * dpr), int(2 * dpr));
+        QImage atlas(m_atlas.width(), height, QImage::Format_Grayscale8);
+        atlas.fill(0);
+        for (int y = 0; y < m_atlas.height(); ++y) {
+            std::memcpy(atlas.scanLine(y), m_atlas.constScanLine(y), m_atlas.width());
+        }
+        m_atlas = std::move(atlas);
+        m_atlasResized = true;
+    }
 
-    // text
+    glyph.atlasRect = QRect(m_atlasCursor, QSize(w, h));
+
+    QPainter p(&m_atlas);
+    p.setRenderHint(QPainter::TextAntialiasing, true);
+    p.setClipRect(glyph.atlasRect);
     p.setPen(Qt::white);
-    p.setFont(font);
+    p.setFont(m_font);
+    p.drawText(glyph.atlasRect.left() - glyph.offsetX, glyph.atlasRect.top() + m_ascent, QString(c));
+    p.end();
+
+    m_atlasDirtyRect |= glyph.atlasRect;
+    m_atlasCursor.rx() += w + GLYPH_PADDING;
+
+    return m_glyphs.insert(c.unicode(), glyph).value();
+}
+
+void HudOverlay::layoutLine(int index, Line* line)
+{
+    line->instances.clear();
+
+    const float y = float(m_margin + index * m_lineHeight);
+    int         penX = m_margin;
+    for (const QChar c : line->text) {
+        const Glyph& g = glyph(c);
+        if (!c.isSpace() && g.atlasRect.isValid()) {
+            const QRect& r = g.atlasRect;
+            line->instances.push_back({
+                { float(penX + g.offsetX), y, float(r.width()), float(r.height()) },
+                { float(r.left()), float(r.top()), float(r.right() + 1), float(r.bottom() + 1) },
+                { 1.f, 1.f, 1.f, 1.f },
+            });
+        }
+        penX += g.advance;
+    }
+    line->width = penX - m_margin;
+}
+
+void HudOverlay::markDirty(size_t begin, size_t end)
+{
+    if (begin >= end) {
+        return;
+    }
+    if (m_dirtyBegin == m_dirtyEnd) {
+        m_dirtyBegin = begin;
+        m_dirtyEnd = end;
+        return;
+    }
+    m_dirtyBegin = std::min(m_dirtyBegin, begin);
+    m_dirtyEnd = std::max(m_dirtyEnd, end);
+}
+
+void HudOverlay::updateText(const QString& text, float dpr, int basePx)
+{
+    updateLines(text.split('\n'), dpr, basePx);
+}
+
+void HudOverlay::updateLines(const QStringList& lines, float dpr, int basePx)
+{
+    setFont(dpr, basePx);
+
+    if (m_instances.empty()) {
+        m_instances.resize(1);
+    }
 
-    int y = margin + fm.ascent();
-    for (const QString& line : lines) {
-        p.drawText(margin, y, line);
-        y += lineH;
+    // lay out the changed lines only; the instances of a line move when a line above it
+    // changed its glyph count, everything from there on is uploaded again
+    const int count = int(lines.size());
+    m_lines.resize(count);
+
+    size_t offset = 1;
+    bool   shifted = false;
+    int    maxWidth = 0;
+    for (int i = 0; i < count; ++i) {
+        Line&        line = m_lines[i];
+        const size_t previousSize = line.instances.size();
+        const bool   changed = line.text != lines[i];
+        if (changed) {
+            line.text = lines[i];
+            layoutLine(i, &line);
+        }
+
+        const size_t size = line.instances.size();
+        shifted = shifted || (changed && size != previousSize);
+        if (changed || shifted) {
+            if (m_instances.size() < offset + size) {
+                m_instances.resize(offset + size);
+            }
+            if (size > 0) {
+                std::memcpy(&m_instances[offset], line.instances.data(), size * sizeof(Instance));
+            }
+            markDirty(offset, offset + size);
+        }
+
+        offset += size;
+        maxWidth = std::max(maxWidth, line.width);
     }
+    m_instances.resize(offset);
 
-    m_img = std::move(img);
-    m_needsUpload = true;
+    // background behind all lines
+    const Instance background {
+        { 0.f, 0.f, float(maxWidth + 2 * m_margin), float(count * m_lineHeight + 2 * m_margin) },
+        { WHITE_TEXEL, WHITE_TEXEL, WHITE_TEXEL, WHITE_TEXEL },
+        { 0.f, 0.f, 0.f, 160.f / 255.f },
+    };
+    if (std::memcmp(&m_instances[0], &background, sizeof(Instance)) != 0) {
+        m_instances[0] = background;
+        markDirty(0, 1);
+    }
 }
 
 void HudOverlay::draw(int widgetW, int widgetH, float dpr)
 {
-    if (!m_inited || widgetW <= 0 || widgetH <= 0) {
-        return;  
-    } 
+    if (!m_inited || widgetW <= 0 || widgetH <= 0 || m_lines.empty()) {
+        return;
+    }
 
-    // upload only when text changed
-    if (m_needsUpload && !m_img.isNull()) {
-        // ensure row length is default (usdview does this too)
-        m_glFunctionCore->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    // upload new glyphs, the whole atlas only when it grew
+    if (m_atlasResized || m_atlasDirtyRect.isValid()) {
+        const QRect rect = m_atlasResized ? m_atlas.rect() : m_atlasDirtyRect;
+        m_glFunctionCore->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        m_glFunctionCore->glPixelStorei(GL_UNPACK_ROW_LENGTH, int(m_atlas.bytesPerLine()));
         m_glFunctionCore->glBindTexture(GL_TEXTURE_2D, m_tex);
-        m_glFunctionCore->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
-                          m_img.width(), m_img.height(),
-                          0, GL_BGRA, GL_UNSIGNED_BYTE, m_img.constBits());
+        const uchar* data = m_atlas.constScanLine(rect.top()) + rect.left();
+        if (m_atlasResized) {
+            m_glFunctionCore->glTexImage2D(GL_TEXTURE_2D, 0, GL_R8,
+                              m_atlas.width(), m_atlas.height(),
+                              0, GL_RED, GL_UNSIGNED_BYTE, data);
+        } else {
+            m_glFunctionCore->glTexSubImage2D(GL_TEXTURE_2D, 0, rect.left(), rect.top(),
+                                 rect.width(), rect.height(), GL_RED, GL_UNSIGNED_BYTE, data);
+        }
         m_glFunctionCore->glBindTexture(GL_TEXTURE_2D, 0);
-        m_needsUpload = false;
+        m_glFunctionCore->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        m_glFunctionCore->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        m_atlasResized = false;
+        m_atlasDirtyRect = QRect();
     }
-    if (m_img.isNull()) {
-        return;
+
+    // upload the instances of the changed lines
+    m_glFunctionCore->glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    if (m_instances.size() > m_instanceCapacity) {
+        m_instanceCapacity = m_instances.size() * 2;
+        m_glFunctionCore->glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(Instance),
+                          nullptr, GL_DYNAMIC_DRAW);
+        markDirty(0, m_instances.size());
     }
+    m_dirtyEnd = std::min(m_dirtyEnd, m_instances.size());
+    if (m_dirtyBegin < m_dirtyEnd) {
+        m_glFunctionCore->glBufferSubData(GL_ARRAY_BUFFER, m_dirtyBegin * sizeof(Instance),
+                             (m_dirtyEnd - m_dirtyBegin) * sizeof(Instance), &m_instances[m_dirtyBegin]);
+    }
+    m_dirtyBegin = m_dirtyEnd = 0;
+    m_glFunctionCore->glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     // setup state for 2D overlay
     m_glFunctionCore->glDisable(GL_DEPTH_TEST);
@@ -168,31 +372,23 @@ void HudOverlay::draw(int widgetW, int widgetH, float dpr)
     m_glFunctionCore->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
                              GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
-    // compute NDC rect
-    const float W = float(widgetW);
-    const float H = float(widgetH);
-
-    // position in device pixels (UI in window coords)
-    const float xPx = float(m_posX);
-    const float yPx = float(m_posY);
-    const float rectW = float(m_img.width())  / dpr;
-    const float rectH = float(m_img.height()) / dpr;
-
-    // convert to NDC ([-1,1], origin at bottom-left for Y math)
-    const float xNdc =  2.0f * (xPx / W) - 1.0f;
-    const float yNdc =  1.0f - 2.0f * ((yPx + rectH) / H);
-    const float wNdc =  2.0f * (rectW / W);
-    const float hNdc =  2.0f * (rectH / H);
+    // device pixels, the origin is rounded so that glyphs land on whole pixels
+    const float viewportW = float(widgetW) * dpr;
+    const float viewportH = float(widgetH) * dpr;
+    const float originX = std::round(float(m_posX) * dpr);
+    const float originY = std::round(float(m_posY) * dpr);
 
     m_glFunctionCore->glUseProgram(m_prog);
-    m_glFunctionCore->glUniform4f(m_uRect, xNdc, yNdc, wNdc, hNdc);
+    m_glFunctionCore->glUniform2f(m_uViewport, viewportW, viewportH);
+    m_glFunctionCore->glUniform2f(m_uOrigin, originX, originY);
+    m_glFunctionCore->glUniform2f(m_uAtlasSize, float(m_atlas.width()), float(m_atlas.height()));
     m_glFunctionCore->glUniform1i(m_uTex, 0);
 
     m_glFunctionCore->glActiveTexture(GL_TEXTURE0);
     m_glFunctionCore->glBindTexture(GL_TEXTURE_2D, m_tex);
 
     m_glFunctionCore->glBindVertexArray(m_vao);
-    m_glFunctionCore->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    m_glFunctionCore->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, GLsizei(m_instances.size()));
     m_glFunctionCore->glBindVertexArray(0);
 
     m_glFunctionCore->glBindTexture(GL_TEXTURE_2D, 0);
@@ -211,7 +407,9 @@ GLuint HudOverlay::createProgram(const char* vs, const char* fs)
     m_glFunctionCore->glAttachShader(p, v);
     m_glFunctionCore->glAttachShader(p, f);
     m_glFunctionCore->glBindAttribLocation(p, 0, "aPos");
-    m_glFunctionCore->glBindAttribLocation(p, 1, "aUV");
+    m_glFunctionCore->glBindAttribLocation(p, 1, "aRect");
+    m_glFunctionCore->glBindAttribLocation(p, 2, "aUV");
+    m_glFunctionCore->glBindAttribLocation(p, 3, "aColor");
     m_glFunctionCore->glLinkProgram(p);
     m_glFunctionCore->glDeleteShader(v);
     m_glFunctionCore->glDeleteShader(f);
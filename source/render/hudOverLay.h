@@ -1,15 +1,22 @@
 #pragma once
 
 #include <QOpenGLFunctions_4_5_Core>
+#include <QFont>
+#include <QHash>
 #include <QImage>
+#include <QRect>
 #include <QString>
+#include <QStringList>
+
+#include <vector>
 
 namespace TINKERUSD_NS
 {
 
-// HUD text renderer for the USD viewport. Mimicking most of the HUD renderer logic from Usdview here. 
-// The text is first rendered into a QImage using QPainter, then uploaded as an
-// OpenGL texture and drawn as a screen-space quad in normalized device coordinates.
+// HUD text renderer for the USD viewport. Mimicking most of the HUD renderer logic from Usdview here.
+// Glyphs are rasterized once with QPainter into an atlas texture, and text is drawn as one
+// instanced quad per glyph on top of the GL widget. Only the lines whose text changed are laid
+// out again and uploaded, so a HUD refreshed every frame costs next to nothing.
 // This approach bypasses the drawing of text directly with QPainter on top of the GL widget.
 // https://forum.aousd.org/t/usdrenderenginegl-leaves-gl-state-that-breaks-qpainter-overlays-in-qopenglwidget/2639
 
@@ -22,32 +29,82 @@ public:
     // initialize GL resources (call after a valid GL context is current).
     void init(QOpenGLFunctions_4_5_Core* f);
 
-    // update the text image; call when the HUD string changes.
+    // release GL resources (call while the context they were created in is current).
+    void destroyGL();
+
+    // update the HUD lines; unchanged lines keep their layout.
     // dpr = devicePixelRatioF(); basePx = base pixel size (logical).
+    void updateLines(const QStringList& lines, float dpr, int basePx = 14);
     void updateText(const QString& text, float dpr, int basePx = 14);
 
     // draw the HUD at top-left. widgetW/H are widget logical size (width(), height()).
     void draw(int widgetW, int widgetH, float dpr);
 
-    //change position in device pixels
+    //change position in logical pixels
     void setPositionPx(int x, int y) { m_posX = x; m_posY = y; }
 
 private:
-    GLuint createProgram(const char* vs, const char* fs);
-    void   destroyGL();
+    // placement of a glyph in the atlas, in texels
+    struct Glyph
+    {
+        QRect atlasRect;
+        int   offsetX { 0 }; // left bearing past the pen position
+        int   advance { 0 };
+    };
 
-private:
-    QImage m_img;
+    // one quad, in device pixels from the top-left of the HUD
+    struct Instance
+    {
+        float rect[4];  // x, y, w, h
+        float uv[4];    // atlas texels, top-left and bottom-right
+        float color[4];
+    };
+
+    struct Line
+    {
+        QString               text;
+        std::vector<Instance> instances;
+        int                   width { 0 };
+    };
+
+    GLuint       createProgram(const char* vs, const char* fs);
+    void         setFont(float dpr, int basePx);
+    void         resetAtlas();
+    const Glyph& glyph(QChar c);
+    void         layoutLine(int index, Line* line);
+    void         markDirty(size_t begin, size_t end);
 
+private:
     QOpenGLFunctions_4_5_Core* m_glFunctionCore{nullptr};
 
+    QFont                 m_font;
+    float                 m_dpr{0.0f};
+    int                   m_basePx{0};
+    int                   m_lineHeight{0};
+    int                   m_ascent{0};
+    int                   m_margin{0};
+
+    QImage                m_atlas; // CPU copy, glyphs are added while the atlas grows
+    QHash<ushort, Glyph>  m_glyphs;
+    QPoint                m_atlasCursor;
+    QRect                 m_atlasDirtyRect;
+    bool                  m_atlasResized{false};
+
+    std::vector<Line>     m_lines;
+    std::vector<Instance> m_instances; // background first, then the lines in order
+    size_t                m_dirtyBegin{0};
+    size_t                m_dirtyEnd{0};
+    size_t                m_instanceCapacity{0};
+
     bool   m_inited{false};
-    bool   m_needsUpload{false};
     GLuint m_vao{ 0 };
     GLuint m_vbo{ 0 };
+    GLuint m_instanceVbo{ 0 };
     GLuint m_prog{ 0 };
     GLuint m_tex{ 0 };
-    GLint  m_uRect{ -1 };
+    GLint  m_uViewport{ -1 };
+    GLint  m_uOrigin{ -1 };
+    GLint  m_uAtlasSize{ -1 };
     GLint  m_uTex{ 0 };
     int    m_posX{ 8 };
     int    m_posY{ 8 };
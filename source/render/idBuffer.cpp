@@ -0,0 +1,241 @@
+#include "idBuffer.h"
+
+#include <pxr/imaging/hd/renderBuffer.h>
+#include <pxr/imaging/hgi/texture.h>
+#include <pxr/imaging/hgiGL/texture.h>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace TINKERUSD_NS
+{
+
+IdBuffer::IdBuffer()
+{
+    initializeOpenGLFunctions();
+
+    glGenBuffers(2, m_pbos);
+}
+
+IdBuffer::~IdBuffer()
+{
+    if (m_fence)
+    {
+        glDeleteSync(m_fence);
+    }
+    glDeleteBuffers(2, m_pbos);
+}
+
+void IdBuffer::invalidate()
+{
+    if (m_fence)
+    {
+        glDeleteSync(m_fence);
+        m_fence = nullptr;
+    }
+    m_primIds.clear();
+    m_instanceIds.clear();
+    m_width = 0;
+    m_height = 0;
+}
+
+bool IdBuffer::readTexture(GLuint texture, GLuint pbo, size_t size)
+{
+    if (texture == 0)
+    {
+        return false;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glGetTextureImage(texture, 0, GL_RED_INTEGER, GL_INT, static_cast<GLsizei>(size), nullptr);
+    return true;
+}
+
+bool IdBuffer::requestReadback(HdRenderBuffer* primIds, HdRenderBuffer* instanceIds)
+{
+    if (!primIds || !instanceIds || primIds->GetFormat() != HdFormatInt32
+        || instanceIds->GetFormat() != HdFormatInt32)
+    {
+        return false;
+    }
+
+    const int width = static_cast<int>(primIds->GetWidth());
+    const int height = static_cast<int>(primIds->GetHeight());
+    if (width == 0 || height == 0 || static_cast<int>(instanceIds->GetWidth()) != width
+        || static_cast<int>(instanceIds->GetHeight()) != height)
+    {
+        return false;
+    }
+
+    primIds->Resolve();
+    instanceIds->Resolve();
+
+    // a newer frame supersedes a readback still in flight
+    if (m_fence)
+    {
+        glDeleteSync(m_fence);
+        m_fence = nullptr;
+    }
+
+    const size_t  count = static_cast<size_t>(width) * height;
+    const VtValue primResource = primIds->GetResource(false);
+    const VtValue instanceResource = instanceIds->GetResource(false);
+    if (primResource.IsHolding<HgiTextureHandle>() && instanceResource.IsHolding<HgiTextureHandle>())
+    {
+        auto primTexture = dynamic_cast<HgiGLTexture*>(primResource.UncheckedGet<HgiTextureHandle>().Get());
+        auto instanceTexture
+            = dynamic_cast<HgiGLTexture*>(instanceResource.UncheckedGet<HgiTextureHandle>().Get());
+        if (!primTexture || !instanceTexture)
+        {
+            return false;
+        }
+
+        // pixel buffers only grow, resizing the viewport back and forth does not reallocate them
+        const size_t size = count * sizeof(int32_t);
+        if (size > m_pboSize)
+        {
+            for (GLuint pbo : m_pbos)
+            {
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+                glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+            }
+            m_pboSize = size;
+        }
+
+        const bool queued = readTexture(primTexture->GetTextureId(), m_pbos[0], size)
+            && readTexture(instanceTexture->GetTextureId(), m_pbos[1], size);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (!queued)
+        {
+            return false;
+        }
+
+        m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_pendingWidth = width;
+        m_pendingHeight = height;
+        return true;
+    }
+
+    // CPU renderers keep their AOVs in host memory
+    const void* primData = primIds->Map();
+    const void* instanceData = instanceIds->Map();
+    const bool  mapped = primData && instanceData;
+    if (mapped)
+    {
+        const int32_t* primIdData = static_cast<const int32_t*>(primData);
+        const int32_t* instanceIdData = static_cast<const int32_t*>(instanceData);
+        m_primIds.assign(primIdData, primIdData + count);
+        m_instanceIds.assign(instanceIdData, instanceIdData + count);
+        m_width = width;
+        m_height = height;
+    }
+    if (primData)
+    {
+        primIds->Unmap();
+    }
+    if (instanceData)
+    {
+        instanceIds->Unmap();
+    }
+    return mapped;
+}
+
+bool IdBuffer::update()
+{
+    if (!m_fence)
+    {
+        return false;
+    }
+
+    const GLenum status = glClientWaitSync(m_fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED)
+    {
+        return false;
+    }
+    glDeleteSync(m_fence);
+    m_fence = nullptr;
+    if (status == GL_WAIT_FAILED)
+    {
+        return false;
+    }
+
+    const size_t count = static_cast<size_t>(m_pendingWidth) * m_pendingHeight;
+    auto         copyBuffer = [this, count](GLuint pbo, std::vector<int32_t>* ids) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        const size_t size = count * sizeof(int32_t);
+        const void*  data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        if (data)
+        {
+            ids->resize(count);
+            std::memcpy(ids->data(), data, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        return data != nullptr;
+    };
+
+    const bool copied = copyBuffer(m_pbos[0], &m_primIds) && copyBuffer(m_pbos[1], &m_instanceIds);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!copied)
+    {
+        invalidate();
+        return false;
+    }
+
+    m_width = m_pendingWidth;
+    m_height = m_pendingHeight;
+    return true;
+}
+
+IdBuffer::Ids IdBuffer::idsAt(int x, int y) const
+{
+    if (!isValid() || x < 0 || y < 0 || x >= m_width || y >= m_height)
+    {
+        return Ids();
+    }
+
+    // rows are stored from the bottom of the image
+    const size_t index = static_cast<size_t>(m_height - 1 - y) * m_width + x;
+    return { m_primIds[index], m_instanceIds[index] };
+}
+
+std::vector<IdBuffer::Ids> IdBuffer::idsIn(const QRect& rect) const
+{
+    std::vector<Ids> result;
+
+    const QRect area = rect.normalized().intersected(QRect(0, 0, m_width, m_height));
+    if (!isValid() || area.isEmpty())
+    {
+        return result;
+    }
+
+    std::unordered_set<uint64_t> seen;
+    for (int y = area.top(); y <= area.bottom(); ++y)
+    {
+        const size_t row = static_cast<size_t>(m_height - 1 - y) * m_width;
+
+        // neighbouring pixels mostly belong to the same prim, only id changes are looked up
+        Ids previous;
+        for (int x = area.left(); x <= area.right(); ++x)
+        {
+            const Ids ids { m_primIds[row + x], m_instanceIds[row + x] };
+            if (ids.primId < 0 || ids == previous)
+            {
+                continue;
+            }
+            previous = ids;
+
+            const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(ids.primId)) << 32)
+                | static_cast<uint32_t>(ids.instanceId);
+            if (seen.insert(key).second)
+            {
+                result.push_back(ids);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace TINKERUSD_NS
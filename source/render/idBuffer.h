@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QOpenGLFunctions_4_5_Core>
+#include <QRect>
+
+#include <cstdint>
+#include <vector>
+
+PXR_NAMESPACE_OPEN_SCOPE
+class HdRenderBuffer;
+PXR_NAMESPACE_CLOSE_SCOPE
+
+namespace TINKERUSD_NS
+{
+
+// CPU copy of the prim id and instance id AOVs of a rendered frame, answering picking queries
+// without rendering again. Renderers keeping the AOVs in GL textures are read back through pixel
+// buffer objects: the copy is queued after the frame and collected once its fence has signaled,
+// so neither the render nor the queries wait on the GPU. AOVs in host memory are copied at once.
+class IdBuffer final : protected QOpenGLFunctions_4_5_Core
+{
+public:
+    struct Ids
+    {
+        int32_t primId { -1 };
+        int32_t instanceId { -1 };
+
+        bool operator==(const Ids& other) const
+        {
+            return primId == other.primId && instanceId == other.instanceId;
+        }
+    };
+
+    IdBuffer();
+    ~IdBuffer();
+
+    // starts copying the AOVs of the last render. Returns false when the renderer does not
+    // provide them as 32 bit integers.
+    bool requestReadback(PXR_NS::HdRenderBuffer* primIds, PXR_NS::HdRenderBuffer* instanceIds);
+
+    // collects a pending readback if the GPU has finished it. Returns true when new ids arrived.
+    bool update();
+
+    bool isPending() const { return m_fence != nullptr; }
+    bool isValid() const { return !m_primIds.empty(); }
+    void invalidate();
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    // ids at a pixel, in buffer coordinates with the first row at the top.
+    Ids idsAt(int x, int y) const;
+
+    // distinct ids covered by a rectangle in buffer coordinates, background excluded.
+    std::vector<Ids> idsIn(const QRect& rect) const;
+
+private:
+    bool readTexture(GLuint texture, GLuint pbo, size_t size);
+
+private:
+    GLuint               m_pbos[2] { 0, 0 };
+    size_t               m_pboSize { 0 };
+    GLsync               m_fence { nullptr };
+    int                  m_pendingWidth { 0 };
+    int                  m_pendingHeight { 0 };
+    std::vector<int32_t> m_primIds;
+    std::vector<int32_t> m_instanceIds;
+    int                  m_width { 0 };
+    int                  m_height { 0 };
+};
+
+} // namespace TINKERUSD_NS
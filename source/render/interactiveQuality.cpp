@@ -0,0 +1,92 @@
+#include "interactiveQuality.h"
+
+#include <algorithm>
+
+namespace
+{
+// frames rendered at a level before it is judged, so that the average reflects the level.
+constexpr int SETTLE_FRAMES = 3;
+
+// weight of the newest frame in the running average.
+constexpr double AVERAGE_WEIGHT = 0.3;
+
+// quality goes down above the budget, and back up only with a wide margin below it, so the
+// level does not oscillate between two neighbours.
+constexpr double DEGRADE_RATIO = 1.1;
+constexpr double REFINE_RATIO = 0.5;
+} // namespace
+
+namespace TINKERUSD_NS
+{
+
+InteractiveQuality::InteractiveQuality()
+    : m_levels {
+        { 1.0f, true, true, false },
+        { 0.75f, true, true, false },
+        { 0.5f, true, true, false },
+        { 0.5f, false, false, false },
+        { 0.35f, false, false, true },
+        { 0.25f, false, false, true },
+    }
+{
+}
+
+void InteractiveQuality::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled)
+    {
+        m_interactiveLevel = 0;
+    }
+}
+
+void InteractiveQuality::setFrameBudgetMs(double budgetMs)
+{
+    m_budgetMs = std::max(1.0, budgetMs);
+    m_framesAtLevel = 0;
+}
+
+void InteractiveQuality::beginInteraction()
+{
+    if (m_interacting)
+    {
+        return;
+    }
+    m_interacting = true;
+    m_framesAtLevel = 0;
+    m_averageMs = 0.0;
+}
+
+void InteractiveQuality::endInteraction() { m_interacting = false; }
+
+void InteractiveQuality::addFrameTime(double frameMs, bool measuredAtLevel)
+{
+    if (!m_enabled || !m_interacting || frameMs < 0.0 || !measuredAtLevel)
+    {
+        return;
+    }
+
+    m_averageMs = m_framesAtLevel == 0 ? frameMs : m_averageMs + AVERAGE_WEIGHT * (frameMs - m_averageMs);
+    if (++m_framesAtLevel < SETTLE_FRAMES)
+    {
+        return;
+    }
+
+    const int lastLevel = static_cast<int>(m_levels.size()) - 1;
+    if (m_averageMs > m_budgetMs * DEGRADE_RATIO && m_interactiveLevel < lastLevel)
+    {
+        ++m_interactiveLevel;
+        m_framesAtLevel = 0;
+    }
+    else if (m_averageMs < m_budgetMs * REFINE_RATIO && m_interactiveLevel > 0)
+    {
+        --m_interactiveLevel;
+        m_framesAtLevel = 0;
+    }
+}
+
+const InteractiveQuality::Level& InteractiveQuality::level() const { return m_levels[levelIndex()]; }
+
+int InteractiveQuality::levelIndex() const { return m_enabled && m_interacting ? m_interactiveLevel : 0; }
+
+} // namespace TINKERUSD_NS
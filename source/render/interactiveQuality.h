@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+namespace TINKERUSD_NS
+{
+
+// picks how much image quality the viewport gives up while the camera is being moved.
+// Frame times measured during an interaction move the quality down a ladder of levels until
+// the frame budget is met, and back up when there is headroom. Once the interaction ends the
+// viewport returns to full quality. The level reached is kept for the next interaction, which
+// starts where the previous one settled.
+class InteractiveQuality final
+{
+public:
+    struct Level
+    {
+        float resolutionScale { 1.0f }; // of the render buffer, the image is upscaled on screen
+        bool  sceneMaterials { true };
+        bool  sceneLights { true };
+        bool  proxyOnly { false }; // draws the proxy purpose instead of the render purpose
+    };
+
+    InteractiveQuality();
+
+    void   setEnabled(bool enabled);
+    bool   isEnabled() const { return m_enabled; }
+    void   setFrameBudgetMs(double budgetMs);
+    double frameBudgetMs() const { return m_budgetMs; }
+
+    void beginInteraction();
+    void endInteraction();
+    bool isInteracting() const { return m_interacting; }
+
+    // feeds the time of the frame just rendered. Only frames rendered during an interaction count.
+    // A level is judged by frames measured at that level only: measuredAtLevel is false while the
+    // time still reflects frames rendered at another level, e.g. GPU times arriving late.
+    void addFrameTime(double frameMs, bool measuredAtLevel = true);
+
+    // the level to render with, full quality outside of interactions.
+    const Level& level() const;
+    int          levelIndex() const;
+    double       averageFrameMs() const { return m_averageMs; }
+
+private:
+    std::vector<Level> m_levels;
+    double             m_budgetMs { 33.0 };
+    double             m_averageMs { 0.0 };
+    int                m_interactiveLevel { 0 };
+    int                m_framesAtLevel { 0 };
+    bool               m_enabled { true };
+    bool               m_interacting { false };
+};
+
+} // namespace TINKERUSD_NS
@@ -0,0 +1,385 @@
+#include "renderStatsRecorder.h"
+
+#include "core/utils.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace TINKERUSD_NS
+{
+
+namespace
+{
+
+constexpr int    DEFAULT_INTERVAL_MS = 500;
+constexpr double MISSING = std::numeric_limits<double>::quiet_NaN();
+
+// render delegates report their stats with various integer and floating point types
+bool toDouble(const VtValue& value, double* result)
+{
+    if (value.IsHolding<bool>() || !value.CanCast<double>())
+    {
+        return false;
+    }
+    *result = VtValue::Cast<double>(value).UncheckedGet<double>();
+    return true;
+}
+
+double positiveOrMissing(double value) { return value >= 0.0 ? value : MISSING; }
+
+QString formatValue(double value, int precision)
+{
+    return std::isnan(value) ? QString() : QString::number(value, 'f', precision);
+}
+
+} // namespace
+
+RenderStatsRecorder::RenderStatsRecorder(QObject* parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_startTime(QDateTime::currentDateTime())
+    , m_history(HISTORY_SIZE)
+{
+    m_clock.start();
+
+    m_timer->setInterval(DEFAULT_INTERVAL_MS);
+    connect(m_timer, &QTimer::timeout, this, &RenderStatsRecorder::takeSample);
+    m_timer->start();
+}
+
+RenderStatsRecorder::~RenderStatsRecorder() = default;
+
+void RenderStatsRecorder::setStatsSource(std::function<VtDictionary()> source)
+{
+    m_statsSource = std::move(source);
+}
+
+void RenderStatsRecorder::setIntervalMs(int intervalMs) { m_timer->setInterval(std::max(50, intervalMs)); }
+
+int RenderStatsRecorder::intervalMs() const { return m_timer->interval(); }
+
+void RenderStatsRecorder::addFrameTime(double frameMs)
+{
+    if (frameMs < 0.0)
+    {
+        return;
+    }
+    m_frameSumMs += frameMs;
+    m_frameMaxMs = std::max(m_frameMaxMs, frameMs);
+    ++m_frames;
+}
+
+int RenderStatsRecorder::statColumn(const std::string& key)
+{
+    auto it = std::find(m_statKeys.begin(), m_statKeys.end(), key);
+    if (it != m_statKeys.end())
+    {
+        return static_cast<int>(it - m_statKeys.begin());
+    }
+    m_statKeys.push_back(key);
+    return static_cast<int>(m_statKeys.size()) - 1;
+}
+
+void RenderStatsRecorder::takeSample()
+{
+    Sample& sample = m_history[m_next];
+    sample.timeMs = m_clock.elapsed();
+    sample.frames = m_frames;
+    sample.frameAvgMs = m_frames > 0 ? m_frameSumMs / m_frames : -1.0;
+    sample.frameMaxMs = m_frames > 0 ? m_frameMaxMs : -1.0;
+    sample.residentMb = residentMemoryMb();
+
+    m_frameSumMs = 0.0;
+    m_frameMaxMs = -1.0;
+    m_frames = 0;
+
+    // the slot is reused, its vector keeps its capacity
+    sample.stats.assign(m_statKeys.size(), MISSING);
+    if (m_statsSource)
+    {
+        for (const auto& stat : m_statsSource())
+        {
+            double value = 0.0;
+            if (!toDouble(stat.second, &value))
+            {
+                continue;
+            }
+            const size_t column = statColumn(stat.first);
+            if (column >= sample.stats.size())
+            {
+                sample.stats.resize(column + 1, MISSING);
+            }
+            sample.stats[column] = value;
+        }
+    }
+
+    m_next = (m_next + 1) % HISTORY_SIZE;
+    m_count = std::min<size_t>(m_count + 1, HISTORY_SIZE);
+
+    if (m_stream.isOpen())
+    {
+        streamSample(sample);
+    }
+}
+
+const RenderStatsRecorder::Sample& RenderStatsRecorder::sampleAt(size_t index) const
+{
+    return m_history[(m_next + HISTORY_SIZE - m_count + index) % HISTORY_SIZE];
+}
+
+std::vector<const RenderStatsRecorder::Sample*> RenderStatsRecorder::orderedSamples(size_t count) const
+{
+    count = std::min(count, m_count);
+
+    std::vector<const Sample*> samples;
+    samples.reserve(count);
+    for (size_t i = m_count - count; i < m_count; ++i)
+    {
+        samples.push_back(&sampleAt(i));
+    }
+    return samples;
+}
+
+QString RenderStatsRecorder::sparkline(const std::function<double(const Sample&)>& value, int width) const
+{
+    static const QChar blocks[] = { QChar(0x2581), QChar(0x2582), QChar(0x2583), QChar(0x2584),
+                                    QChar(0x2585), QChar(0x2586), QChar(0x2587), QChar(0x2588) };
+    constexpr int      levels = static_cast<int>(sizeof(blocks) / sizeof(blocks[0]));
+
+    const std::vector<const Sample*> samples = orderedSamples(static_cast<size_t>(std::max(0, width)));
+
+    double low = std::numeric_limits<double>::max();
+    double high = std::numeric_limits<double>::lowest();
+    for (const Sample* sample : samples)
+    {
+        const double v = value(*sample);
+        if (!std::isnan(v))
+        {
+            low = std::min(low, v);
+            high = std::max(high, v);
+        }
+    }
+
+    // scaled to the range of the samples shown, a flat series sits on the baseline
+    QString line;
+    line.reserve(static_cast<int>(samples.size()));
+    for (const Sample* sample : samples)
+    {
+        const double v = value(*sample);
+        if (std::isnan(v))
+        {
+            line += QChar(' ');
+            continue;
+        }
+        const double scaled = high > low ? (v - low) / (high - low) : 0.0;
+        line += blocks[static_cast<int>(std::lround(scaled * (levels - 1)))];
+    }
+    return line;
+}
+
+QString RenderStatsRecorder::frameTimeSparkline(int width) const
+{
+    return sparkline([](const Sample& sample) { return positiveOrMissing(sample.frameMaxMs); }, width);
+}
+
+QString RenderStatsRecorder::memorySparkline(int width) const
+{
+    return sparkline([](const Sample& sample) { return positiveOrMissing(sample.residentMb); }, width);
+}
+
+QString RenderStatsRecorder::statSparkline(const std::string& key, int width) const
+{
+    auto it = std::find(m_statKeys.begin(), m_statKeys.end(), key);
+    if (it == m_statKeys.end())
+    {
+        return QString();
+    }
+
+    const size_t column = static_cast<size_t>(it - m_statKeys.begin());
+    const auto value = [column](const Sample& sample) {
+        return column < sample.stats.size() ? sample.stats[column] : MISSING;
+    };
+    return sparkline(value, width);
+}
+
+QStringList RenderStatsRecorder::hudLines(int sparklineWidth) const
+{
+    QStringList lines;
+    if (m_count == 0)
+    {
+        return lines;
+    }
+
+    const Sample& latest = sampleAt(m_count - 1);
+    const Sample& first = sampleAt(m_count - std::min<size_t>(m_count, std::max(1, sparklineWidth)));
+    const QString frameMs
+        = latest.frameMaxMs >= 0.0 ? QString::number(latest.frameMaxMs, 'f', 1) : QStringLiteral("idle");
+    const QString memoryMb
+        = latest.residentMb >= 0.0 ? QString::number(latest.residentMb, 'f', 0) : QStringLiteral("n/a");
+
+    lines << QStringLiteral("Session, last %1 s every %2 ms")
+                 .arg((latest.timeMs - first.timeMs) / 1000)
+                 .arg(intervalMs());
+    lines << QStringLiteral("Frame max ms %1 %2").arg(frameTimeSparkline(sparklineWidth)).arg(frameMs);
+    lines << QStringLiteral("Memory MB    %1 %2").arg(memorySparkline(sparklineWidth)).arg(memoryMb);
+    return lines;
+}
+
+QString RenderStatsRecorder::csvHeader(size_t statColumns) const
+{
+    QString header = QStringLiteral("time_ms,frames,frame_avg_ms,frame_max_ms,resident_mb");
+    for (size_t i = 0; i < statColumns; ++i)
+    {
+        header += ',' + QString::fromStdString(m_statKeys[i]);
+    }
+    return header + '\n';
+}
+
+QString RenderStatsRecorder::csvRow(const Sample& sample, size_t statColumns) const
+{
+    // values that were not measured are left empty.
+    QString row = QStringLiteral("%1,%2,%3,%4,%5")
+                      .arg(sample.timeMs)
+                      .arg(sample.frames)
+                      .arg(formatValue(positiveOrMissing(sample.frameAvgMs), 4))
+                      .arg(formatValue(positiveOrMissing(sample.frameMaxMs), 4))
+                      .arg(formatValue(positiveOrMissing(sample.residentMb), 1));
+    for (size_t i = 0; i < statColumns; ++i)
+    {
+        row += ',' + formatValue(i < sample.stats.size() ? sample.stats[i] : MISSING, 4);
+    }
+    return row + '\n';
+}
+
+QJsonObject RenderStatsRecorder::toJsonObject(const Sample& sample) const
+{
+    QJsonObject object;
+    object["time_ms"] = sample.timeMs;
+    object["frames"] = sample.frames;
+    if (sample.frameAvgMs >= 0.0)
+    {
+        object["frame_avg_ms"] = sample.frameAvgMs;
+        object["frame_max_ms"] = sample.frameMaxMs;
+    }
+    if (sample.residentMb >= 0.0)
+    {
+        object["resident_mb"] = sample.residentMb;
+    }
+
+    QJsonObject stats;
+    for (size_t i = 0; i < sample.stats.size(); ++i)
+    {
+        if (!std::isnan(sample.stats[i]))
+        {
+            stats[QString::fromStdString(m_statKeys[i])] = sample.stats[i];
+        }
+    }
+    object["stats"] = stats;
+    return object;
+}
+
+QString RenderStatsRecorder::toCsv() const
+{
+    QString     csv;
+    QTextStream stream(&csv);
+
+    stream << csvHeader(m_statKeys.size());
+    for (const Sample* sample : orderedSamples(m_count))
+    {
+        stream << csvRow(*sample, m_statKeys.size());
+    }
+    return csv;
+}
+
+QString RenderStatsRecorder::toJson() const
+{
+    QJsonArray samples;
+    for (const Sample* sample : orderedSamples(m_count))
+    {
+        samples.append(toJsonObject(*sample));
+    }
+
+    QJsonObject root;
+    root["start_time"] = m_startTime.toString(Qt::ISODate);
+    root["interval_ms"] = intervalMs();
+    root["samples"] = samples;
+    return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Indented));
+}
+
+bool RenderStatsRecorder::exportToFile(const QString& filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        qWarning() << "RenderStatsRecorder: could not write" << filePath;
+        return false;
+    }
+
+    const bool json = QFileInfo(filePath).suffix().compare("json", Qt::CaseInsensitive) == 0;
+    file.write((json ? toJson() : toCsv()).toUtf8());
+    return true;
+}
+
+bool RenderStatsRecorder::setStreamFile(const QString& filePath)
+{
+    if (m_stream.isOpen())
+    {
+        m_stream.close();
+    }
+    if (filePath.isEmpty())
+    {
+        return true;
+    }
+
+    m_stream.setFileName(filePath);
+    if (!m_stream.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        qWarning() << "RenderStatsRecorder: could not write" << filePath;
+        return false;
+    }
+
+    m_streamJson = QFileInfo(filePath).suffix().compare("jsonl", Qt::CaseInsensitive) == 0;
+    m_streamColumns = -1;
+    return true;
+}
+
+QString RenderStatsRecorder::streamFile() const
+{
+    return m_stream.isOpen() ? m_stream.fileName() : QString();
+}
+
+void RenderStatsRecorder::streamSample(const Sample& sample)
+{
+    QString text;
+    if (m_streamJson)
+    {
+        text = QString::fromUtf8(QJsonDocument(toJsonObject(sample)).toJson(QJsonDocument::Compact));
+        text += '\n';
+    }
+    else
+    {
+        // the columns are fixed by the header, written with the first sample
+        if (m_streamColumns < 0)
+        {
+            m_streamColumns = static_cast<int>(m_statKeys.size());
+            text = csvHeader(m_streamColumns);
+        }
+        text += csvRow(sample, m_streamColumns);
+    }
+
+    // flushed with every sample, a crashed session keeps its record
+    m_stream.write(text.toUtf8());
+    m_stream.flush();
+}
+
+} // namespace TINKERUSD_NS
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <pxr/base/vt/dictionary.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class QTimer;
+
+namespace TINKERUSD_NS
+{
+
+// time series of the viewport frame times, the process resident memory and the numeric Hydra
+// render stats, to follow trends over a session. A sample is taken at a fixed interval whether
+// or not the viewport repaints, frames rendered in between are summarized by their average and
+// longest time. Samples are kept in a fixed size ring buffer, exported on demand or streamed to a
+// file as they are taken. Sampling costs one render stats query and one memory query per
+// interval, cheap enough to be left on.
+class RenderStatsRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    RenderStatsRecorder(QObject* parent = nullptr);
+    virtual ~RenderStatsRecorder();
+
+    // render stats of the current renderer, queried on every sample.
+    void setStatsSource(std::function<PXR_NS::VtDictionary()> source);
+
+    void setIntervalMs(int intervalMs);
+    int  intervalMs() const;
+
+    // called once per rendered frame, cheap.
+    void addFrameTime(double frameMs);
+
+    size_t sampleCount() const { return m_count; }
+
+    // sparkline of the last samples, one block character per sample from lowest to highest.
+    QString frameTimeSparkline(int width) const;
+    QString memorySparkline(int width) const;
+    QString statSparkline(const std::string& key, int width) const;
+
+    // frame time and memory sparklines with their latest values, for the viewport HUD.
+    QStringList hudLines(int sparklineWidth = 32) const;
+
+    // writes the recorded samples. The format follows the file suffix: .json, anything else
+    // is written as CSV.
+    bool exportToFile(const QString& filePath) const;
+
+    // appends every new sample to a file, as CSV or as JSON Lines for a .jsonl suffix. CSV columns
+    // are the render stats known when the first sample is streamed, stats appearing later are only
+    // in the JSON Lines stream and the exports. An empty path stops streaming.
+    bool    setStreamFile(const QString& filePath);
+    QString streamFile() const;
+
+private slots:
+    void takeSample();
+
+private:
+    // number of samples kept, 10 minutes at the default interval.
+    static constexpr int HISTORY_SIZE = 1200;
+
+    struct Sample
+    {
+        qint64              timeMs { 0 };       // since recording started
+        double              frameAvgMs { -1.0 }; // negative when no frame was rendered
+        double              frameMaxMs { -1.0 };
+        int                 frames { 0 };
+        double              residentMb { -1.0 };
+        std::vector<double> stats; // by column of m_statKeys, NaN when missing
+    };
+
+    const Sample&              sampleAt(size_t index) const; // 0 is the oldest
+    std::vector<const Sample*> orderedSamples(size_t count) const;
+    int                        statColumn(const std::string& key);
+    QString                    sparkline(const std::function<double(const Sample&)>& value, int width) const;
+    QString                    toCsv() const;
+    QString                    toJson() const;
+    QString                    csvHeader(size_t statColumns) const;
+    QString                    csvRow(const Sample& sample, size_t statColumns) const;
+    QJsonObject                toJsonObject(const Sample& sample) const;
+    void                       streamSample(const Sample& sample);
+
+private:
+    std::function<PXR_NS::VtDictionary()> m_statsSource;
+    QTimer*                               m_timer;
+    QElapsedTimer                         m_clock;
+    QDateTime                             m_startTime;
+    std::vector<Sample>                   m_history;
+    size_t                                m_next { 0 };
+    size_t                                m_count { 0 };
+    std::vector<std::string>              m_statKeys;
+
+    // frames since the last sample
+    double m_frameSumMs { 0.0 };
+    double m_frameMaxMs { -1.0 };
+    int    m_frames { 0 };
+
+    QFile m_stream;
+    bool  m_streamJson { false };
+    int   m_streamColumns { -1 }; // render stat columns of the CSV stream, -1 until its header is written
+};
+
+} // namespace TINKERUSD_NS
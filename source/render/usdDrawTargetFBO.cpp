@@ -3,15 +3,21 @@
 #include <pxr/base/gf/vec2i.h>
 #include <pxr/usd/usd/prim.h>
 
+#include <algorithm>
+
 namespace
 {
 const char* vertexShaderSrc = R"(#version 450 core
     layout(location = 0) in vec2 aPos;
     layout(location = 1) in vec2 aTexCoord;
     out vec2 TexCoord;
+
+    // part of the attachments covered by the current size
+    uniform vec2 uvScale;
+
     void main()
     {
-        TexCoord = aTexCoord;
+        TexCoord = aTexCoord * uvScale;
         gl_Position = vec4(aPos, 0.0, 1.0);
     }
     )";
@@ -21,6 +27,9 @@ const char* fragmentShaderSrc = R"(#version 450 core
         out vec4 FragColor;
         uniform sampler2D screenTexture;
 
+        // last texel centers of the current size, filtering must not reach past them
+        uniform vec2 uvMax;
+
         // don't use a cannon to kill a mosquito.! let's do the linear to SRGB in the pixel shader.
         // good enough for now.
         vec3 linearToSRGB(vec3 color) {
@@ -31,7 +40,7 @@ const char* fragmentShaderSrc = R"(#version 450 core
 
         void main()
         {
-            vec4 linearColor = texture(screenTexture, TexCoord);
+            vec4 linearColor = texture(screenTexture, min(TexCoord, uvMax));
             vec3 srgbColor = linearToSRGB(linearColor.rgb);
             FragColor = vec4(srgbColor, linearColor.a);
         }
@@ -41,14 +50,23 @@ const char* fragmentShaderSrc = R"(#version 450 core
 namespace TINKERUSD_NS
 {
 
-UsdDrawTargetFBO::UsdDrawTargetFBO()
+UsdDrawTargetFBO::UsdDrawTargetFBO(ColorFormat colorFormat)
     : m_vao(0)
     , m_vbo(0)
-    , m_width(512)
-    , m_height(512)
+    , m_width(0)
+    , m_height(0)
+    , m_allocatedWidth(0)
+    , m_allocatedHeight(0)
     , m_shaderProgram(0)
+    , m_uvScaleLocation(-1)
+    , m_uvMaxLocation(-1)
+    , m_colorFormat(colorFormat)
 {
     initializeOpenGLFunctions();
+
+    // the blit resources do not depend on the size, they live as long as the target
+    initializeShader();
+    initializeQuad();
 }
 
 UsdDrawTargetFBO::~UsdDrawTargetFBO()
@@ -61,28 +79,65 @@ UsdDrawTargetFBO::~UsdDrawTargetFBO()
     {
         glDeleteVertexArrays(1, &m_vao);
     }
+    if (m_shaderProgram)
+    {
+        glDeleteProgram(m_shaderProgram);
+    }
 }
 
 void UsdDrawTargetFBO::resize(int width, int height)
 {
-    if (width == m_width && height == m_height)
+    m_width = std::max(1, width);
+    m_height = std::max(1, height);
+
+    if (m_drawTarget && m_width <= m_allocatedWidth && m_height <= m_allocatedHeight)
     {
         return;
     }
-    m_width = width;
-    m_height = height;
 
-    // create draw target
-    m_drawTarget = GlfDrawTarget::New(GfVec2i(m_width, m_height));
+    // grow to cover both the old and the new size, a dock dragged wider then taller allocates twice
+    allocate(std::max(m_width, m_allocatedWidth), std::max(m_height, m_allocatedHeight));
+}
+
+void UsdDrawTargetFBO::setColorFormat(ColorFormat colorFormat)
+{
+    if (colorFormat == m_colorFormat)
+    {
+        return;
+    }
+    m_colorFormat = colorFormat;
+
+    if (m_drawTarget)
+    {
+        allocate(m_allocatedWidth, m_allocatedHeight);
+    }
+}
+
+void UsdDrawTargetFBO::allocate(int width, int height)
+{
+    m_allocatedWidth = width;
+    m_allocatedHeight = height;
+
+    // replacing the draw target releases the attachments of the previous one
+    m_drawTarget = GlfDrawTarget::New(GfVec2i(m_allocatedWidth, m_allocatedHeight));
     m_drawTarget->Bind();
 
-    m_drawTarget->AddAttachment(TfToken("color"), GL_RGBA, GL_FLOAT, GL_RGBA);
+    switch (m_colorFormat)
+    {
+    case ColorFormat::RGBA8:
+        m_drawTarget->AddAttachment(TfToken("color"), GL_RGBA, GL_UNSIGNED_BYTE, GL_RGBA8);
+        break;
+    case ColorFormat::RGBA16F:
+    default: m_drawTarget->AddAttachment(TfToken("color"), GL_RGBA, GL_HALF_FLOAT, GL_RGBA16F); break;
+    }
 
     m_drawTarget->AddAttachment(TfToken("depth"), GL_DEPTH_COMPONENT, GL_FLOAT, GL_DEPTH_COMPONENT32F);
 
     m_drawTarget->Unbind();
+}
 
-    // compile shaders
+void UsdDrawTargetFBO::initializeShader()
+{
     GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(vertexShader, 1, &vertexShaderSrc, nullptr);
     glCompileShader(vertexShader);
@@ -99,7 +154,12 @@ void UsdDrawTargetFBO::resize(int width, int height)
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
 
-    initializeQuad();
+    m_uvScaleLocation = glGetUniformLocation(m_shaderProgram, "uvScale");
+    m_uvMaxLocation = glGetUniformLocation(m_shaderProgram, "uvMax");
+
+    glUseProgram(m_shaderProgram);
+    glUniform1i(glGetUniformLocation(m_shaderProgram, "screenTexture"), 0);
+    glUseProgram(0);
 }
 
 void UsdDrawTargetFBO::initializeQuad()
@@ -170,7 +230,10 @@ void UsdDrawTargetFBO::draw()
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, texId);
 
-    glUniform1i(glGetUniformLocation(m_shaderProgram, "screenTexture"), 0);
+    const float allocatedWidth = static_cast<float>(m_allocatedWidth);
+    const float allocatedHeight = static_cast<float>(m_allocatedHeight);
+    glUniform2f(m_uvScaleLocation, m_width / allocatedWidth, m_height / allocatedHeight);
+    glUniform2f(m_uvMaxLocation, (m_width - 0.5f) / allocatedWidth, (m_height - 0.5f) / allocatedHeight);
 
     glBindVertexArray(m_vao);
     glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
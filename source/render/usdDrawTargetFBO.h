@@ -10,26 +10,45 @@ PXR_NAMESPACE_USING_DIRECTIVE
 namespace TINKERUSD_NS
 {
 
+// offscreen target the viewport renders into, drawn to the widget in sRGB. The attachments only
+// grow: a smaller size renders into the lower left corner of the existing ones, so resizing the
+// viewport back and forth does not reallocate anything. Must be created with a current context.
 class UsdDrawTargetFBO : protected QOpenGLFunctions_4_5_Core
 {
 public:
-    UsdDrawTargetFBO();
+    enum class ColorFormat
+    {
+        RGBA16F, // keeps the linear image precise enough in the darks for the sRGB conversion
+        RGBA8    // half the bandwidth, dark gradients band
+    };
+
+    UsdDrawTargetFBO(ColorFormat colorFormat = ColorFormat::RGBA16F);
     virtual ~UsdDrawTargetFBO();
 
-    void resize(int width, int height);
+    void        resize(int width, int height);
+    void        setColorFormat(ColorFormat colorFormat);
+    ColorFormat colorFormat() const { return m_colorFormat; }
+
     void bind();
     void unbind();
     void draw();
 
 private:
+    void initializeShader();
     void initializeQuad();
+    void allocate(int width, int height);
 
 private:
     GLuint              m_vao;
     GLuint              m_vbo;
-    size_t              m_width;
-    size_t              m_height;
+    int                 m_width;
+    int                 m_height;
+    int                 m_allocatedWidth;
+    int                 m_allocatedHeight;
     GLuint              m_shaderProgram;
+    GLint               m_uvScaleLocation;
+    GLint               m_uvMaxLocation;
+    ColorFormat         m_colorFormat;
     GlfDrawTargetRefPtr m_drawTarget;
 };
 
@@ -3,22 +3,68 @@
 #include "camera/usdCamera.h"
 #include "core/globalSelection.h"
 
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <pxr/base/gf/half.h>
+#include <pxr/imaging/hd/aov.h>
+#include <pxr/imaging/hd/renderBuffer.h>
+#include <pxr/imaging/hdx/taskController.h>
 #include <pxr/usd/usd/prim.h>
-#include <pxr/usdImaging/usdImaging/delegate.h>
+#include <pxr/usd/usdGeom/camera.h>
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
+namespace
+{
+
+// UsdImagingGLEngine selects a single AOV, the id pass needs the prim and instance ids together.
+class Engine final : public UsdImagingGLEngine
+{
+public:
+    using UsdImagingGLEngine::UsdImagingGLEngine;
+
+    void setRenderOutputs(const TfTokenVector& outputs) { _taskController->SetRenderOutputs(outputs); }
+};
+
+} // namespace
+
 namespace TINKERUSD_NS
 {
 
 void UsdRenderEngineGL::initialize(const PXR_NS::UsdStageRefPtr& stage)
 {
     PXR_NS::SdfPathVector excludedPaths;
-    m_usdGLEngine
-        = std::make_unique<PXR_NS::UsdImagingGLEngine>(stage->GetPseudoRoot().GetPath(), excludedPaths);
+    m_usdGLEngine = std::make_unique<Engine>(stage->GetPseudoRoot().GetPath(), excludedPaths);
 
     addBboxRenderParams(stageBbox(stage));
 
+    initializeLighting();
+}
+
+bool UsdRenderEngineGL::initializeOffscreen(
+    const PXR_NS::UsdStageRefPtr& stage,
+    const PXR_NS::TfToken&        rendererId)
+{
+    PXR_NS::UsdImagingGLEngine::Parameters parameters;
+    parameters.rootPath = stage->GetPseudoRoot().GetPath();
+    parameters.rendererPluginId = rendererId;
+    parameters.gpuEnabled = false;
+
+    m_usdGLEngine = std::make_unique<Engine>(parameters);
+    if (m_usdGLEngine->GetCurrentRendererId() != rendererId)
+    {
+        qWarning() << "Renderer plugin" << rendererId.GetText() << "is not available";
+        m_usdGLEngine.reset();
+        return false;
+    }
+
+    initializeLighting();
+    return true;
+}
+
+void UsdRenderEngineGL::initializeLighting()
+{
     // camera light
     m_cameraLight.SetAmbient({ 0.1, 0.1, 0.1, 1.0 });
     m_cameraLight.SetDiffuse({ 1.0, 1.0, 1.0, 1.f });
@@ -31,9 +77,21 @@ void UsdRenderEngineGL::initialize(const PXR_NS::UsdStageRefPtr& stage)
 
     m_ambient = GfVec4f(0.0, 0.0, 0.0, 0.0);
 
+    m_lights.clear();
     m_lights.push_back(m_cameraLight);
 }
 
+void UsdRenderEngineGL::updateCameraLight(const PXR_NS::GfCamera& camera)
+{
+    GfVec3d cameraPos = camera.GetFrustum().GetPosition();
+    m_cameraLight.SetPosition(GfVec4f(cameraPos[0], cameraPos[1], cameraPos[2], 1.0));
+    m_cameraLight.SetTransform(camera.GetTransform());
+
+    // update the light state
+    m_lights[0] = m_cameraLight;
+    m_usdGLEngine->SetLightingState(m_lights, m_material, m_ambient);
+}
+
 void UsdRenderEngineGL::render(const PXR_NS::UsdStageRefPtr& stage, UsdCamera* camera, double w, double h)
 {
     camera->setAspectRatio(w / std::max(1.0, h));
@@ -51,18 +109,106 @@ void UsdRenderEngineGL::render(const PXR_NS::UsdStageRefPtr& stage, UsdCamera* c
         std::make_optional(CameraUtilConformWindowPolicy::CameraUtilMatchHorizontally));
 
     // update camera light position
-    GfVec3d cameraPos = camera->getCamera().GetFrustum().GetPosition();
-    m_cameraLight.SetPosition(GfVec4f(cameraPos[0], cameraPos[1], cameraPos[2], 1.0));
-    m_cameraLight.SetTransform(camera->getCamera().GetTransform());
+    updateCameraLight(camera->getCamera());
 
-    // update the light state
-    m_lights[0] = m_cameraLight;
-    m_usdGLEngine->SetLightingState(m_lights, m_material, m_ambient);
+    m_usdGLEngine->SetRendererAov(TfToken(m_aov));
+    m_usdGLEngine->Render(stage->GetPseudoRoot(), m_params);
+}
+
+void UsdRenderEngineGL::render(
+    const PXR_NS::UsdStageRefPtr& stage,
+    const PXR_NS::SdfPath&        cameraPath,
+    int                           w,
+    int                           h)
+{
+    const GfRect2i dataWindow(GfVec2i(0, 0), w, h);
+
+    m_usdGLEngine->SetCameraPath(cameraPath);
+    m_usdGLEngine->SetRenderBufferSize(GfVec2i(w, h));
+    m_usdGLEngine->SetFraming(CameraUtilFraming(GfRange2f(GfVec2f(0, 0), GfVec2f(w, h)), dataWindow));
+    m_usdGLEngine->SetOverrideWindowPolicy(std::make_optional(CameraUtilConformWindowPolicy::CameraUtilFit));
+
+    // the camera light follows the camera prim at the rendered time
+    const UsdGeomCamera camera(stage->GetPrimAtPath(cameraPath));
+    updateCameraLight(camera.GetCamera(m_params.frame));
 
     m_usdGLEngine->SetRendererAov(TfToken(m_aov));
     m_usdGLEngine->Render(stage->GetPseudoRoot(), m_params);
 }
 
+bool UsdRenderEngineGL::colorImage(QImage* image) const
+{
+    HdRenderBuffer* buffer = m_usdGLEngine ? m_usdGLEngine->GetAovRenderBuffer(HdAovTokens->color) : nullptr;
+    if (!buffer)
+    {
+        return false;
+    }
+
+    buffer->Resolve();
+
+    const int      width = static_cast<int>(buffer->GetWidth());
+    const int      height = static_cast<int>(buffer->GetHeight());
+    const HdFormat format = buffer->GetFormat();
+    if (format != HdFormatUNorm8Vec4 && format != HdFormatFloat16Vec4 && format != HdFormatFloat32Vec4)
+    {
+        qWarning() << "Unsupported color AOV format" << format;
+        return false;
+    }
+
+    const void* data = buffer->Map();
+    if (!data)
+    {
+        return false;
+    }
+
+    // color AOVs hold linear values whatever their format, encoded to sRGB here as no color
+    // correction task runs without a GPU.
+    auto toUnorm = [](float value) {
+        return static_cast<uchar>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+    auto toSrgb = [&toUnorm](float linear) {
+        linear = std::clamp(linear, 0.0f, 1.0f);
+        return toUnorm(
+            linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f);
+    };
+
+    *image = QImage(width, height, QImage::Format_RGBA8888);
+    for (int y = 0; y < height; ++y)
+    {
+        // hydra buffers start at the bottom row
+        uchar*       dst = image->scanLine(height - 1 - y);
+        const size_t rowStart = static_cast<size_t>(y) * width * 4;
+        for (int i = 0; i < width * 4; ++i)
+        {
+            const bool alpha = (i % 4) == 3;
+            switch (format)
+            {
+            case HdFormatUNorm8Vec4:
+            {
+                const uchar value = static_cast<const uchar*>(data)[rowStart + i];
+                dst[i] = alpha ? value : toSrgb(value / 255.0f);
+                break;
+            }
+            case HdFormatFloat16Vec4:
+            {
+                const float value = static_cast<const GfHalf*>(data)[rowStart + i];
+                dst[i] = alpha ? toUnorm(value) : toSrgb(value);
+                break;
+            }
+            default:
+            {
+                const float value = static_cast<const float*>(data)[rowStart + i];
+                dst[i] = alpha ? toUnorm(value) : toSrgb(value);
+                break;
+            }
+            }
+        }
+    }
+
+    buffer->Unmap();
+    return true;
+}
+
 PXR_NS::UsdImagingGLRenderParams& UsdRenderEngineGL::params() { return m_params; }
 
 pxr::UsdImagingGLEngine* UsdRenderEngineGL::getUsdImagingGLEngine() const { return m_usdGLEngine.get(); }
@@ -72,6 +218,49 @@ std::string UsdRenderEngineGL::rendererDisplayName() const
     return m_usdGLEngine->GetRendererDisplayName(m_usdGLEngine->GetCurrentRendererId());
 }
 
+PXR_NS::TfTokenVector UsdRenderEngineGL::rendererPlugins()
+{
+    return UsdImagingGLEngine::GetRendererPlugins();
+}
+
+std::string UsdRenderEngineGL::rendererDisplayName(const PXR_NS::TfToken& rendererId)
+{
+    return UsdImagingGLEngine::GetRendererDisplayName(rendererId);
+}
+
+PXR_NS::TfToken UsdRenderEngineGL::rendererId() const { return m_usdGLEngine->GetCurrentRendererId(); }
+
+bool UsdRenderEngineGL::setRendererPlugin(const PXR_NS::TfToken& rendererId)
+{
+    if (rendererId == m_usdGLEngine->GetCurrentRendererId())
+    {
+        return true;
+    }
+    if (!m_usdGLEngine->SetRendererPlugin(rendererId))
+    {
+        qWarning() << "Renderer plugin" << rendererId.GetText() << "could not be loaded";
+        return false;
+    }
+    return true;
+}
+
+PXR_NS::UsdImagingGLRendererSettingsList UsdRenderEngineGL::rendererSettings() const
+{
+    return m_usdGLEngine->GetRendererSettingsList();
+}
+
+PXR_NS::VtValue UsdRenderEngineGL::rendererSetting(const PXR_NS::TfToken& key) const
+{
+    return m_usdGLEngine->GetRendererSetting(key);
+}
+
+void UsdRenderEngineGL::setRendererSetting(const PXR_NS::TfToken& key, const PXR_NS::VtValue& value)
+{
+    m_usdGLEngine->SetRendererSetting(key, value);
+}
+
+bool UsdRenderEngineGL::isConverged() const { return !m_usdGLEngine || m_usdGLEngine->IsConverged(); }
+
 std::vector<std::string> UsdRenderEngineGL::getRendererAovs() const
 {
     std::vector<std::string> result;
@@ -86,16 +275,72 @@ void UsdRenderEngineGL::setRendererAov(const std::string& name) { m_aov = name;
 
 void UsdRenderEngineGL::addBboxRenderParams(const GfBBox3d& bBox)
 {
-    m_params.bboxes.clear();
-    m_params.bboxes.emplace_back(bBox);
+    addBboxRenderParams(std::vector<GfBBox3d> { bBox });
+}
+
+void UsdRenderEngineGL::addBboxRenderParams(const std::vector<GfBBox3d>& bBoxes)
+{
+    m_params.bboxes = bBoxes;
     m_params.bboxLineColor = GfVec4f(1.0f, 1.0f, 1.0f, 1.0f);
     m_params.bboxLineDashSize = 5;
 }
 
+PXR_NS::HdRenderBuffer* UsdRenderEngineGL::aovRenderBuffer(const PXR_NS::TfToken& name) const
+{
+    return m_usdGLEngine ? m_usdGLEngine->GetAovRenderBuffer(name) : nullptr;
+}
+
+bool UsdRenderEngineGL::renderIds(const PXR_NS::UsdStageRefPtr& stage)
+{
+    if (!m_usdGLEngine)
+    {
+        return false;
+    }
+
+    // path tracers produce the ids along with color, Storm only adds depth
+    if (aovRenderBuffer(HdAovTokens->primId) && aovRenderBuffer(HdAovTokens->instanceId))
+    {
+        return true;
+    }
+
+    // same camera and framing as the last render. The next render selects the displayed AOV again.
+    auto engine = static_cast<Engine*>(m_usdGLEngine.get());
+    engine->setRenderOutputs({ HdAovTokens->primId, HdAovTokens->instanceId });
+    engine->SetEnablePresentation(false);
+    engine->Render(stage->GetPseudoRoot(), m_params);
+    engine->SetEnablePresentation(true);
+
+    return aovRenderBuffer(HdAovTokens->primId) && aovRenderBuffer(HdAovTokens->instanceId);
+}
+
+PXR_NS::SdfPath UsdRenderEngineGL::decodeIds(int32_t primId, int32_t instanceId) const
+{
+    // the engine decodes ids packed as little endian colors, the way the pick task writes them
+    unsigned char primIdColor[4];
+    unsigned char instanceIdColor[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        primIdColor[i] = static_cast<unsigned char>((static_cast<uint32_t>(primId) >> (8 * i)) & 0xff);
+        instanceIdColor[i]
+            = static_cast<unsigned char>((static_cast<uint32_t>(instanceId) >> (8 * i)) & 0xff);
+    }
+
+    SdfPath primPath;
+    SdfPath instancerPath;
+    int     instanceIndex = -1;
+    if (!m_usdGLEngine->DecodeIntersection(
+            primIdColor, instanceIdColor, &primPath, &instancerPath, &instanceIndex))
+    {
+        return SdfPath();
+    }
+    return primPath.IsEmpty() ? instancerPath : primPath;
+}
+
 void UsdRenderEngineGL::addSelectionHighlighting()
 {
-    m_usdGLEngine->ClearSelected();
-    m_usdGLEngine->AddSelected(GlobalSelection::instance().path(), PXR_NS::UsdImagingDelegate::ALL_INSTANCES);
+    // a single selection update, rather than one per selected path
+    const auto& paths = GlobalSelection::instance().paths();
+    m_usdGLEngine->SetSelected(PXR_NS::SdfPathVector(paths.begin(), paths.end()));
 }
 
 } // namespace TINKERUSD_NS
@@ -2,8 +2,10 @@
 
 #include "core/utils.h"
 
+#include <QImage>
 #include <memory>
 #include <pxr/base/gf/bbox3d.h>
+#include <pxr/base/gf/camera.h>
 #include <pxr/imaging/glf/simpleLight.h>
 #include <pxr/usd/usd/stage.h>
 #include <pxr/usdImaging/usdImagingGL/engine.h>
@@ -23,8 +25,19 @@ public:
 
     void initialize(const PXR_NS::UsdStageRefPtr& stage);
 
+    // creates an engine that needs neither a GPU nor a GL context, rendering through a CPU
+    // renderer plugin such as HdEmbreeRendererPlugin. Returns false when the plugin cannot be used.
+    bool initializeOffscreen(const PXR_NS::UsdStageRefPtr& stage, const PXR_NS::TfToken& rendererId);
+
     void render(const PXR_NS::UsdStageRefPtr& stage, UsdCamera* camera, double w, double h);
 
+    // renders the stage through a camera prim.
+    void render(const PXR_NS::UsdStageRefPtr& stage, const PXR_NS::SdfPath& cameraPath, int w, int h);
+
+    // copies the color AOV of the last render into an 8 bit sRGB image. Only available for engines
+    // created by initializeOffscreen, the interactive ones present straight to the framebuffer.
+    bool colorImage(QImage* image) const;
+
     PXR_NS::UsdImagingGLRenderParams& params();
     pxr::UsdImagingGLEngine*          getUsdImagingGLEngine() const;
 
@@ -33,10 +46,44 @@ public:
 
     std::string rendererDisplayName() const;
 
+    // hydra renderer plugins installed, e.g. HdStormRendererPlugin or HdEmbreeRendererPlugin.
+    static PXR_NS::TfTokenVector rendererPlugins();
+    static std::string           rendererDisplayName(const PXR_NS::TfToken& rendererId);
+
+    PXR_NS::TfToken rendererId() const;
+
+    // switches the renderer of the existing engine. A GL context must be current.
+    bool setRendererPlugin(const PXR_NS::TfToken& rendererId);
+
+    // settings exposed by the current renderer, e.g. sample counts or thread limits.
+    PXR_NS::UsdImagingGLRendererSettingsList rendererSettings() const;
+    PXR_NS::VtValue                          rendererSetting(const PXR_NS::TfToken& key) const;
+    void setRendererSetting(const PXR_NS::TfToken& key, const PXR_NS::VtValue& value);
+
+    // whether the renderer has finished refining the last rendered image. Rasterizers are
+    // converged after every frame, path tracers only once they reached their sample count.
+    bool isConverged() const;
+
     void addBboxRenderParams(const GfBBox3d& bBox);
+    void addBboxRenderParams(const std::vector<GfBBox3d>& bBoxes);
+
+    // AOV of the last render, e.g. HdAovTokens->primId. Null when the renderer does not produce it.
+    PXR_NS::HdRenderBuffer* aovRenderBuffer(const PXR_NS::TfToken& name) const;
+
+    // makes the primId and instanceId AOVs of the last rendered view available. Renderers that
+    // only produce color and depth, e.g. Storm, render them in an extra pass that presents nothing.
+    // Read them back before the next render, which switches to the displayed AOV again.
+    bool renderIds(const PXR_NS::UsdStageRefPtr& stage);
+
+    // resolves ids read from the primId and instanceId AOVs to the prim they were rendered for.
+    PXR_NS::SdfPath decodeIds(int32_t primId, int32_t instanceId) const;
 
     void addSelectionHighlighting();
 
+private:
+    void initializeLighting();
+    void updateCameraLight(const PXR_NS::GfCamera& camera);
+
 private:
     Ptr                              m_usdGLEngine;
     PXR_NS::UsdImagingGLRenderParams m_params;
@@ -2,6 +2,7 @@
 
 #include "core/globalSelection.h"
 #include "core/usdDocument.h"
+#include "ui/panelRefreshScheduler.h"
 
 #include <QMainWindow>
 #include <QVBoxLayout>
@@ -13,6 +14,7 @@ namespace TINKERUSD_NS
 CompositionInspectorWidget::CompositionInspectorWidget(UsdDocument* document, QMainWindow* parent)
     : QWidget(parent)
     , m_usdDocument(document)
+    , m_refreshScheduler(new PanelRefreshScheduler(this, [this]() { refresh(); }))
 {
     setObjectName("CompositionInspectorWidget");
 
@@ -56,7 +58,9 @@ void CompositionInspectorWidget::onStageOpened(const QString& filePath)
     m_primCompositionWidget->clearAll();
 }
 
-void CompositionInspectorWidget::onSelectionChanged()
+void CompositionInspectorWidget::onSelectionChanged() { m_refreshScheduler->requestRefresh(); }
+
+void CompositionInspectorWidget::refresh()
 {
     m_layerStackWidget->clearAll();
     m_primCompositionWidget->clearAll();
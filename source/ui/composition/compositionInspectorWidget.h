@@ -12,6 +12,7 @@ namespace TINKERUSD_NS
 {
 
 class UsdDocument;
+class PanelRefreshScheduler;
 class CompositionInspectorWidget : public QWidget
 {
     Q_OBJECT
@@ -23,6 +24,7 @@ public:
 
 private:
     void setupLayout();
+    void refresh();
 
 private slots:
     void onStageOpened(const QString& filePath);
@@ -31,6 +33,7 @@ private:
     QPointer<LayerStack>      m_layerStackWidget;
     QPointer<PrimComposition> m_primCompositionWidget;
     UsdDocument*              m_usdDocument { nullptr };
+    PanelRefreshScheduler*    m_refreshScheduler { nullptr };
 };
 
 } // namespace TINKERUSD_NS
\ No newline at end of file
@@ -1,10 +1,13 @@
 #include "mainMenuBar.h"
 
+#include "stageOpenDialog.h"
 #include "undomanager.h"
 
 #include <QAction>
 #include <QApplication>
 #include <QFileDialog>
+#include <QInputDialog>
+#include <QLineEdit>
 #include <QMessageBox>
 
 namespace TINKERUSD_NS
@@ -23,13 +26,22 @@ void MainMenuBar::setupMenus()
 
     QAction* newStageAction = new QAction("New Stage", this);
     QAction* openStageAction = new QAction("Open Stage", this);
+    QAction* openStageOptionsAction = new QAction("Open Stage With Options...", this);
+    QAction* expandMaskAction = new QAction("Expand Population Mask...", this);
     QAction* saveEditsAction = new QAction("Save", this);
+    QAction* saveAsAction = new QAction("Save As...", this);
+    QAction* clearStageCacheAction = new QAction("Clear Stage Cache", this);
     QAction* quitAction = new QAction("Quit", this);
 
     fileMenu->addAction(newStageAction);
     fileMenu->addAction(openStageAction);
+    fileMenu->addAction(openStageOptionsAction);
+    fileMenu->addAction(expandMaskAction);
     fileMenu->addSeparator();
     fileMenu->addAction(saveEditsAction);
+    fileMenu->addAction(saveAsAction);
+    fileMenu->addSeparator();
+    fileMenu->addAction(clearStageCacheAction);
     fileMenu->addSeparator();
     fileMenu->addAction(quitAction);
 
@@ -73,13 +85,32 @@ void MainMenuBar::setupMenus()
     showRendererStats->setCheckable(true);
     showRendererStats->setChecked(false);
     debugMenu->addAction(showRendererStats);
+    QAction* exportFrameProfileAction = new QAction("Export Frame Profile...", this);
+    debugMenu->addAction(exportFrameProfileAction);
+    QAction* exportRenderStatsAction = new QAction("Export Render Stats...", this);
+    debugMenu->addAction(exportRenderStatsAction);
+    QAction* streamRenderStatsAction = new QAction("Stream Render Stats To File...", this);
+    streamRenderStatsAction->setCheckable(true);
+    debugMenu->addAction(streamRenderStatsAction);
 
     connect(newStageAction, &QAction::triggered, this, &MainMenuBar::requestNewStage);
     connect(openStageAction, &QAction::triggered, [this]() {
         QString file = QFileDialog::getOpenFileName(
             this, "Open USD Stage", "", "USD Files (*.usd *.usda *.usdc *.usdz)");
         if (!file.isEmpty())
-            emit requestOpenStage(file);
+            emit requestOpenStage(file, StageOpenOptions());
+    });
+    connect(openStageOptionsAction, &QAction::triggered, [this]() {
+        StageOpenDialog dlg(this);
+        if (dlg.exec() == QDialog::Accepted)
+            emit requestOpenStage(dlg.filePath(), dlg.options());
+    });
+    connect(expandMaskAction, &QAction::triggered, [this]() {
+        bool    ok;
+        QString text = QInputDialog::getMultiLineText(
+            this, "Expand Population Mask", "Prim paths or patterns to add, one per line:", "", &ok);
+        if (ok && !text.trimmed().isEmpty())
+            emit requestExpandPopulationMask(text.split('\n', Qt::SkipEmptyParts));
     });
     connect(quitAction, &QAction::triggered, qApp, &QApplication::quit);
 
@@ -96,12 +127,69 @@ void MainMenuBar::setupMenus()
     connect(resetAction, &QAction::triggered, this, &MainMenuBar::camResetSignal);
     connect(cameraSettingsAction,&QAction::triggered, this, &MainMenuBar::camSettingsRequested);
     connect(showRendererStats, &QAction::toggled, this, &MainMenuBar::showRendererStatsToggled);
+    connect(exportFrameProfileAction, &QAction::triggered, [this]() {
+        QString file = QFileDialog::getSaveFileName(
+            this, "Export Frame Profile", "", "CSV (*.csv);;JSON (*.json)");
+        if (!file.isEmpty())
+            emit requestExportFrameProfile(file);
+    });
+    connect(exportRenderStatsAction, &QAction::triggered, [this]() {
+        QString file = QFileDialog::getSaveFileName(
+            this, "Export Render Stats", "", "CSV (*.csv);;JSON (*.json)");
+        if (!file.isEmpty())
+            emit requestExportRenderStats(file);
+    });
+    connect(streamRenderStatsAction, &QAction::triggered, [this, streamRenderStatsAction](bool checked) {
+        if (!checked)
+        {
+            emit requestStreamRenderStats(QString());
+            return;
+        }
+        QString file = QFileDialog::getSaveFileName(
+            this, "Stream Render Stats To File", "", "CSV (*.csv);;JSON Lines (*.jsonl)");
+        if (file.isEmpty())
+            streamRenderStatsAction->setChecked(false);
+        else
+            emit requestStreamRenderStats(file);
+    });
 
     connect(clearUndoAction, &QAction::triggered, this, []() { UndoManager::instance().undoStack()->clear(); });
 
     connect(debugUndoStackAction, &QAction::triggered, this, []() { UndoManager::instance().displayUndoStackInfo(); });
 
     connect(saveEditsAction, &QAction::triggered, this, &MainMenuBar::requestSaveEdits);
+    connect(saveAsAction, &QAction::triggered, [this]() {
+        QString file = QFileDialog::getSaveFileName(
+            this, "Save USD Stage As", "", "USD Crate (*.usdc);;USD ASCII (*.usda);;USD (*.usd)");
+        if (file.isEmpty())
+            return;
+
+        bool    ok;
+        QString text = QInputDialog::getText(
+            this,
+            "Save As",
+            "File format arguments (key=value, separated by spaces):",
+            QLineEdit::Normal,
+            "",
+            &ok);
+        if (!ok)
+            return;
+
+        PXR_NS::SdfLayer::FileFormatArguments args;
+        for (const QString& entry : text.split(' ', Qt::SkipEmptyParts))
+        {
+            const int separator = entry.indexOf('=');
+            if (separator <= 0)
+            {
+                QMessageBox::warning(this, "Save As", QString("Invalid file format argument: %1").arg(entry));
+                return;
+            }
+            args[entry.left(separator).toStdString()] = entry.mid(separator + 1).toStdString();
+        }
+        emit requestSaveStageAs(file, args);
+    });
+
+    connect(clearStageCacheAction, &QAction::triggered, this, &MainMenuBar::requestClearStageCache);
 }
 
 } // namespace TINKERUSD_NS
\ No newline at end of file
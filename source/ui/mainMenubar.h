@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/usdDocument.h"
+
 #include <QMenu>
 #include <QMenuBar>
 
@@ -17,12 +19,19 @@ public:
 
 signals:
     void requestNewStage();
-    void requestOpenStage(const QString& path);
+    void requestOpenStage(const QString& path, const StageOpenOptions& options);
+    void requestExpandPopulationMask(const QStringList& paths);
     void requestSaveEdits();
+    void requestSaveStageAs(const QString& path, const PXR_NS::SdfLayer::FileFormatArguments& args);
+    void requestClearStageCache();
     void camFrameSelectSignal();
     void camResetSignal();
     void camSettingsRequested();
     void showRendererStatsToggled(bool value);
+    void requestExportFrameProfile(const QString& path);
+    void requestExportRenderStats(const QString& path);
+    // an empty path stops streaming
+    void requestStreamRenderStats(const QString& path);
 
 private:
     void setupMenus();
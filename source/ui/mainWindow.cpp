@@ -3,11 +3,15 @@
 #include "DockManager.h"
 #include "composition/compositionInspectorWidget.h"
 #include "core/globalSelection.h"
+#include "core/layerSaver.h"
+#include "core/stageCache.h"
 #include "core/usdDocument.h"
 #include "mainMenuBar.h"
 #include "outliner/outlinerWidget.h"
 #include "propertyEditor/propertyWidget.h"
+#include "rendererSettingsWidget.h"
 #include "scriptEditor/scriptEditor.h"
+#include "timelineWidget.h"
 #include "viewportOpenGLWidget.h"
 #include "logger/loggerWidget.h"
 #include "cameraSettingsDialog.h"
@@ -16,8 +20,10 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QLabel>
+#include <QMessageBox>
 #include <QStatusBar>
 #include <QToolBar>
+#include <QToolButton>
 #include <QPlainTextEdit>
 
 namespace TINKERUSD_NS
@@ -37,6 +43,8 @@ MainWindow::MainWindow(QWidget* parent)
     auto compInspectorWidget = new CompositionInspectorWidget(usdDocument);
     auto outlinerWidget = new OutlinerWidget(usdDocument);
     auto propertyWidget = new PropertyWidget(usdDocument);
+    auto timelineWidget = new TimelineWidget();
+    auto rendererSettingsWidget = new RendererSettingsWidget(viewportGLWidget);
     auto aovComboBox = new QComboBox();
     auto shadingComboBox = new QComboBox();
     LogWidget& loggerWidget = LogWidget::instance(this);
@@ -68,7 +76,7 @@ MainWindow::MainWindow(QWidget* parent)
     openGlViewportDockWidget->setFeature(ads::CDockWidget::DockWidgetMovable, false);
     openGlViewportDockWidget->setFeature(ads::CDockWidget::DockWidgetFloatable, false);
 
-    dockManager->addDockWidget(ads::CenterDockWidgetArea, openGlViewportDockWidget);
+    auto dockAreaViewport = dockManager->addDockWidget(ads::CenterDockWidgetArea, openGlViewportDockWidget);
     mainMenuBar->getPanelsMenu()->addAction(openGlViewportDockWidget->toggleViewAction());
 
     auto toolBar = openGlViewportDockWidget->createDefaultToolBar();
@@ -104,6 +112,13 @@ MainWindow::MainWindow(QWidget* parent)
 
     toolBar->addSeparator();
 
+    // timeline
+    ads::CDockWidget* timelineDockWidget = new ads::CDockWidget("Timeline");
+    timelineDockWidget->setWidget(timelineWidget);
+    timelineDockWidget->setMinimumSizeHintMode(ads::CDockWidget::MinimumSizeHintFromContent);
+    dockManager->addDockWidget(ads::BottomDockWidgetArea, timelineDockWidget, dockAreaViewport);
+    mainMenuBar->getPanelsMenu()->addAction(timelineDockWidget->toggleViewAction());
+
     // outliner
     ads::CDockWidget* outlinerDockWidget = new ads::CDockWidget("Outliner");
     outlinerDockWidget->setWidget(outlinerWidget);
@@ -128,6 +143,13 @@ MainWindow::MainWindow(QWidget* parent)
     auto dockAreaPropertyEditor = dockManager->addDockWidget(ads::RightDockWidgetArea, dockWidgetProperty);
     mainMenuBar->getPanelsMenu()->addAction(dockWidgetProperty->toggleViewAction());
 
+    // renderer settings, tabbed with the property editor
+    ads::CDockWidget* rendererSettingsDockWidget = new ads::CDockWidget("Renderer");
+    rendererSettingsDockWidget->setWidget(rendererSettingsWidget);
+    dockManager->addDockWidget(ads::CenterDockWidgetArea, rendererSettingsDockWidget, dockAreaPropertyEditor);
+    mainMenuBar->getPanelsMenu()->addAction(rendererSettingsDockWidget->toggleViewAction());
+    dockWidgetProperty->setAsCurrentTab();
+
     // script editor
     ads::CDockWidget* scriptEditorDockWidget = new ads::CDockWidget("Script Editor");
     scriptEditorDockWidget->setWidget(scriptEditorWidget);
@@ -144,7 +166,9 @@ MainWindow::MainWindow(QWidget* parent)
 
     // connection signal/slots
     connect(mainMenuBar, &MainMenuBar::requestNewStage, usdDocument, &UsdDocument::createNewStageInMemory);
-    connect(mainMenuBar, &MainMenuBar::requestOpenStage, usdDocument, &UsdDocument::openStage);
+    connect(mainMenuBar, &MainMenuBar::requestOpenStage, usdDocument, &UsdDocument::openStageAsync);
+    connect(
+        mainMenuBar, &MainMenuBar::requestExpandPopulationMask, usdDocument, &UsdDocument::expandPopulationMask);
 
     connect(usdDocument, &UsdDocument::stageOpened, [this](const QString& filePath) {
         QString baseName = QFileInfo(filePath).fileName();
@@ -163,11 +187,96 @@ MainWindow::MainWindow(QWidget* parent)
     connect(mainMenuBar, &MainMenuBar::camResetSignal, viewportGLWidget, &ViewportOpenGLWidget::reset);
 
     connect(mainMenuBar, &MainMenuBar::showRendererStatsToggled, viewportGLWidget, &ViewportOpenGLWidget::setShowRendererStats);
+    connect(mainMenuBar, &MainMenuBar::requestExportFrameProfile, this, [viewportGLWidget](const QString& path) {
+        viewportGLWidget->exportFrameProfile(path);
+    });
+    connect(
+        mainMenuBar,
+        &MainMenuBar::requestExportRenderStats,
+        this,
+        [viewportGLWidget](const QString& path) { viewportGLWidget->exportRenderStats(path); });
+    connect(
+        mainMenuBar,
+        &MainMenuBar::requestStreamRenderStats,
+        this,
+        [viewportGLWidget](const QString& path) { viewportGLWidget->setRenderStatsStreamFile(path); });
 
     auto stageUpAxisLabel = new QLabel(QString("Up Axis: %1 ").arg(viewportGLWidget->upAxisDisplayName()));
 
     statusBar->addWidget(stageUpAxisLabel);
 
+    connect(viewportGLWidget, &ViewportOpenGLWidget::primHovered, this, [statusBar](const SdfPath& path) {
+        if (path.IsEmpty())
+        {
+            statusBar->clearMessage();
+        }
+        else
+        {
+            statusBar->showMessage(QString::fromStdString(path.GetString()));
+        }
+    });
+
+    // stage cache statistics
+    auto stageCacheLabel = new QLabel();
+    statusBar->addPermanentWidget(stageCacheLabel);
+
+    auto updateStageCacheLabel = [stageCacheLabel]() {
+        const StageCache& cache = StageCache::instance();
+        stageCacheLabel->setText(QString("Stage Cache: %1 stages, ~%2 MB of layer files, %3 hits / %4 misses ")
+                                     .arg(cache.size())
+                                     .arg(cache.memoryUsage() / (1024.0 * 1024.0), 0, 'f', 1)
+                                     .arg(cache.hits())
+                                     .arg(cache.misses()));
+    };
+    updateStageCacheLabel();
+
+    connect(&StageCache::instance(), &StageCache::statisticsChanged, stageCacheLabel, updateStageCacheLabel);
+    connect(mainMenuBar, &MainMenuBar::requestClearStageCache, this, []() { StageCache::instance().clear(); });
+
+    // stage open progress
+    auto openProgressLabel = new QLabel();
+    auto cancelOpenButton = new QToolButton();
+    cancelOpenButton->setText("Cancel");
+    cancelOpenButton->setToolTip("Cancel opening the stage");
+    openProgressLabel->setVisible(false);
+    cancelOpenButton->setVisible(false);
+    statusBar->addPermanentWidget(openProgressLabel);
+    statusBar->addPermanentWidget(cancelOpenButton);
+
+    auto hideOpenProgress = [openProgressLabel, cancelOpenButton]() {
+        openProgressLabel->setVisible(false);
+        cancelOpenButton->setVisible(false);
+    };
+
+    connect(cancelOpenButton, &QToolButton::clicked, usdDocument, &UsdDocument::cancelOpenStage);
+    connect(cancelOpenButton, &QToolButton::clicked, this, hideOpenProgress);
+
+    connect(
+        usdDocument,
+        &UsdDocument::stageOpenProgress,
+        this,
+        [usdDocument, openProgressLabel, cancelOpenButton](
+            const QString& filePath, int layersResolved, int primsComposed) {
+            // late notifications of a cancelled open must not show the widgets again
+            if (!usdDocument->isOpeningStage())
+            {
+                return;
+            }
+            openProgressLabel->setText(QString("Opening %1: %2 layers, %3 prims ")
+                                           .arg(QFileInfo(filePath).fileName())
+                                           .arg(layersResolved)
+                                           .arg(primsComposed));
+            openProgressLabel->setVisible(true);
+            cancelOpenButton->setVisible(true);
+        });
+
+    connect(usdDocument, &UsdDocument::stageOpened, this, hideOpenProgress);
+    connect(usdDocument, &UsdDocument::stageOpenCancelled, this, hideOpenProgress);
+    connect(usdDocument, &UsdDocument::stageOpenFailed, this, [statusBar, hideOpenProgress](const QString& filePath) {
+        hideOpenProgress();
+        statusBar->showMessage(QString("Failed to open stage: %1").arg(filePath), 5000);
+    });
+
     connect(
         viewportGLWidget,
         &ViewportOpenGLWidget::rendererAvailable,
@@ -192,16 +301,50 @@ MainWindow::MainWindow(QWidget* parent)
         stageUpAxisLabel->setText(QString("Up Axis: %1 ").arg(viewportGLWidget->upAxisDisplayName()));
     });
 
-    connect(mainMenuBar, &MainMenuBar::requestSaveEdits, usdDocument, [usdDocument]() {
-        auto stage = usdDocument->getCurrentStage();
-        if (stage) {
-            auto targetLayer = stage->GetEditTarget().GetLayer();
-            if (targetLayer) {
-                targetLayer->Save();
-                qDebug() << "Saved edits to target layer:" << QString::fromStdString(targetLayer->GetIdentifier());
+    // background saves
+    connect(mainMenuBar, &MainMenuBar::requestSaveEdits, usdDocument, &UsdDocument::saveDirtyLayers);
+    connect(mainMenuBar, &MainMenuBar::requestSaveStageAs, usdDocument, &UsdDocument::saveStageAs);
+
+    connect(
+        usdDocument->layerSaver(), &LayerSaver::layerSaveFailed, this, [statusBar](const LayerSaveResult& result) {
+            statusBar->showMessage(QString("Failed to save %1").arg(result.filePath), 5000);
+        });
+    connect(
+        usdDocument->layerSaver(),
+        &LayerSaver::saveFinished,
+        this,
+        [statusBar](int savedCount, int failedCount, double elapsedMs) {
+            if (failedCount == 0)
+            {
+                statusBar->showMessage(
+                    QString("Saved %1 layer(s) in %2 ms").arg(savedCount).arg(elapsedMs, 0, 'f', 0), 5000);
             }
-        }
-    });
+        });
+
+    // crash recovery, asked once the stage is on screen
+    connect(
+        usdDocument,
+        &UsdDocument::editJournalFound,
+        this,
+        [this, usdDocument](const QString& filePath, const QString& journalPath) {
+            const auto answer = QMessageBox::question(
+                this,
+                "Recover Edits",
+                QString("TinkerUsd did not close normally while editing %1.\n\n"
+                        "Do you want to recover the unsaved edits?")
+                    .arg(QDir::toNativeSeparators(filePath)),
+                QMessageBox::Yes | QMessageBox::Discard | QMessageBox::Cancel);
+            // a dismissed prompt keeps the edits, they are offered again on the next open
+            if (answer == QMessageBox::Yes)
+            {
+                usdDocument->recoverEdits(journalPath);
+            }
+            else if (answer == QMessageBox::Discard)
+            {
+                usdDocument->discardRecoveredEdits(journalPath);
+            }
+        },
+        Qt::QueuedConnection);
 
     connect(mainMenuBar, &MainMenuBar::camSettingsRequested, this, [this, viewportGLWidget]() {
         CameraSettingsDialog dlg(viewportGLWidget, this);
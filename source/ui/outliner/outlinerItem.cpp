@@ -5,14 +5,15 @@ using namespace pxr;
 namespace TINKERUSD_NS
 {
 
-UsdOutlinerItem::Ptr UsdOutlinerItem::create(const UsdPrim& prim, Ptr parent)
+UsdOutlinerItem::Ptr UsdOutlinerItem::create(const UsdPrim& prim, Ptr parent, int row)
 {
-    return std::shared_ptr<UsdOutlinerItem>(new UsdOutlinerItem(prim, parent));
+    return std::shared_ptr<UsdOutlinerItem>(new UsdOutlinerItem(prim, parent, row));
 }
 
-UsdOutlinerItem::UsdOutlinerItem(const UsdPrim& prim, Ptr parent)
+UsdOutlinerItem::UsdOutlinerItem(const UsdPrim& prim, Ptr parent, int row)
     : m_prim(prim)
     , m_parentItem(parent)
+    , m_row(row)
     , m_childrenFetched(false)
 {
 }
@@ -27,11 +28,15 @@ void UsdOutlinerItem::fetchChildrenIfNeeded()
     m_childrenFetched = true;
 
     m_childItems.clear();
+    m_childRows.clear();
 
-    // get all child prims that match the default predicate
-    for (const auto& childPrim : m_prim.GetFilteredChildren(UsdPrimDefaultPredicate))
+    // same as the default predicate, but unloaded prims are kept so they can be loaded on demand
+    const auto predicate = UsdPrimIsActive && UsdPrimIsDefined && !UsdPrimIsAbstract;
+    for (const auto& childPrim : m_prim.GetFilteredChildren(predicate))
     {
-        m_childItems.push_back(create(childPrim, shared_from_this()));
+        const int childRow = static_cast<int>(m_childItems.size());
+        m_childRows.emplace(childPrim.GetName(), childRow);
+        m_childItems.push_back(create(childPrim, shared_from_this(), childRow));
     }
 }
 
@@ -53,20 +58,14 @@ int UsdOutlinerItem::childCount()
     return static_cast<int>(m_childItems.size());
 }
 
-int UsdOutlinerItem::row() const
+int UsdOutlinerItem::row() const { return m_row; }
+
+UsdOutlinerItem::Ptr UsdOutlinerItem::childByName(const TfToken& name)
 {
-    if (auto parent = m_parentItem.lock())
-    {
-        const auto& siblings = parent->m_childItems;
-        for (size_t i = 0; i < siblings.size(); ++i)
-        {
-            if (siblings[i].get() == this)
-            {
-                return static_cast<int>(i);
-            }
-        }
-    }
-    return 0;
+    fetchChildrenIfNeeded();
+
+    const auto it = m_childRows.find(name);
+    return it != m_childRows.end() ? m_childItems[it->second] : nullptr;
 }
 
 UsdOutlinerItem::Ptr UsdOutlinerItem::parentItem() { return m_parentItem.lock(); }
@@ -6,6 +6,7 @@
 #include <pxr/usd/sdf/path.h>
 #include <pxr/usd/usd/prim.h>
 #include <pxr/usd/usd/stage.h>
+#include <unordered_map>
 #include <vector>
 
 namespace TINKERUSD_NS
@@ -17,7 +18,7 @@ public:
     using Ptr = std::shared_ptr<UsdOutlinerItem>;
     using WeakPtr = std::weak_ptr<UsdOutlinerItem>;
 
-    static Ptr create(const PXR_NS::UsdPrim& prim, Ptr parent = nullptr);
+    static Ptr create(const PXR_NS::UsdPrim& prim, Ptr parent = nullptr, int row = 0);
 
     DISALLOW_COPY_MOVE_ASSIGNMENT(UsdOutlinerItem);
 
@@ -25,18 +26,25 @@ public:
     int childCount();
     int row() const;
 
+    // constant time lookup of a child by prim name, used to resolve paths into items.
+    Ptr childByName(const PXR_NS::TfToken& name);
+
     Ptr             parentItem();
     PXR_NS::UsdPrim prim() const;
 
     void fetchChildrenIfNeeded();
 
 private:
-    UsdOutlinerItem(const PXR_NS::UsdPrim& prim, Ptr parent);
+    UsdOutlinerItem(const PXR_NS::UsdPrim& prim, Ptr parent, int row);
 
 private:
+    using RowByName = std::unordered_map<PXR_NS::TfToken, int, PXR_NS::TfToken::HashFunctor>;
+
     PXR_NS::UsdPrim  m_prim;
     WeakPtr          m_parentItem;
     std::vector<Ptr> m_childItems;
+    RowByName        m_childRows;
+    int              m_row;
     bool             m_childrenFetched;
 };
 
@@ -1,5 +1,7 @@
 #include "outlinerModel.h"
 
+#include <QBrush>
+#include <QFont>
 #include <QString>
 #include <pxr/usd/sdf/path.h>
 #include <pxr/usd/usd/modelAPI.h>
@@ -155,7 +157,7 @@ int UsdOutlinerModel::columnCount(const QModelIndex&) const { return 3; }
 
 QVariant UsdOutlinerModel::data(const QModelIndex& index, int role) const
 {
-    if (!index.isValid() || role != Qt::DisplayRole)
+    if (!index.isValid())
     {
         return {};
     }
@@ -169,6 +171,25 @@ QVariant UsdOutlinerModel::data(const QModelIndex& index, int role) const
     UsdOutlinerItem::Ptr item = itemRaw->shared_from_this();
     UsdPrim              prim = item->prim();
 
+    // prims with deferred payloads are greyed out and italic
+    const bool unloaded = !prim.IsLoaded();
+    switch (role)
+    {
+    case Qt::DisplayRole: break;
+    case Qt::ForegroundRole: return unloaded ? QVariant(QBrush(QColor(130, 130, 130))) : QVariant();
+    case Qt::FontRole: {
+        if (!unloaded)
+        {
+            return {};
+        }
+        QFont font;
+        font.setItalic(true);
+        return font;
+    }
+    case Qt::ToolTipRole: return unloaded ? QString("Unloaded") : QVariant();
+    default: return {};
+    }
+
     switch (index.column())
     {
     case 0: return QString::fromUtf8(prim.GetName().GetText());
@@ -218,31 +239,27 @@ UsdPrim UsdOutlinerModel::primFromIndex(const QModelIndex& index) const
 
 QModelIndex UsdOutlinerModel::indexFromPrim(const UsdPrim& targetPrim) const
 {
-    std::function<QModelIndex(UsdOutlinerItem::Ptr)> findIndex;
-    findIndex = [&](UsdOutlinerItem::Ptr item) -> QModelIndex {
-        if (!item)
-        {
-            return {};
-        }
+    return targetPrim.IsValid() ? indexFromPath(targetPrim.GetPath()) : QModelIndex();
+}
 
-        if (item->prim() == targetPrim)
-        {
-            return createIndex(item->row(), 0, item.get());
-        }
+QModelIndex UsdOutlinerModel::indexFromPath(const SdfPath& path) const
+{
+    if (!m_rootItem || !path.IsAbsolutePath() || !path.IsPrimPath())
+    {
+        return {};
+    }
 
-        item->fetchChildrenIfNeeded();
-        for (int i = 0; i < item->childCount(); ++i)
+    UsdOutlinerItem::Ptr item = m_rootItem;
+    for (const auto& prefix : path.GetPrefixes())
+    {
+        item = item->childByName(prefix.GetNameToken());
+        if (!item)
         {
-            auto index = findIndex(item->child(i));
-            if (index.isValid())
-            {
-                return index;
-            }
+            return {};
         }
-        return {};
-    };
+    }
 
-    return findIndex(m_rootItem);
+    return createIndex(item->row(), 0, item.get());
 }
 
 } // namespace TINKERUSD_NS
\ No newline at end of file
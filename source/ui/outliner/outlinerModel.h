@@ -16,7 +16,8 @@ public:
     UsdOutlinerModel(QObject* parent = nullptr);
     virtual ~UsdOutlinerModel() = default;
 
-    void setStage(const PXR_NS::UsdStageRefPtr& stage);
+    void                   setStage(const PXR_NS::UsdStageRefPtr& stage);
+    PXR_NS::UsdStageRefPtr stage() const { return m_stage; }
 
     QModelIndex index(int row, int column, const QModelIndex& parent) const override;
     QModelIndex parent(const QModelIndex& child) const override;
@@ -29,6 +30,9 @@ public:
 
     QModelIndex indexFromPrim(const PXR_NS::UsdPrim& prim) const;
 
+    // resolves a prim path one name at a time, in time proportional to the path length.
+    QModelIndex indexFromPath(const PXR_NS::SdfPath& path) const;
+
 private:
     PXR_NS::UsdStageRefPtr m_stage;
     UsdOutlinerItem::Ptr   m_rootItem;
@@ -1,11 +1,17 @@
 #include "outlinerView.h"
 
 #include "core/globalSelection.h"
+#include "core/pathExpressionQuery.h"
 #include "outlinerModel.h"
+#include "ui/panelRefreshScheduler.h"
 
+#include <QDebug>
 #include <QItemSelectionModel>
 #include <QKeyEvent>
 #include <QLineEdit>
+#include <algorithm>
+#include <map>
+#include <vector>
 
 namespace TINKERUSD_NS
 {
@@ -15,12 +21,13 @@ UsdOutlinerView::UsdOutlinerView(QWidget* parent)
     , m_model(new UsdOutlinerModel(this))
     , m_proxyModel(new UsdOutlinerFilterProxyModel(this))
     , m_searchLineEdit(nullptr)
+    , m_refreshScheduler(new PanelRefreshScheduler(this, [this]() { syncFromGlobalSelection(); }))
 {
     m_proxyModel->setSourceModel(m_model);
     setModel(m_proxyModel);
 
     setSelectionBehavior(QAbstractItemView::SelectRows);
-    setSelectionMode(QAbstractItemView::SingleSelection);
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
     setItemsExpandable(true);
     setUniformRowHeights(true);
     setSortingEnabled(false);
@@ -35,22 +42,20 @@ UsdOutlinerView::UsdOutlinerView(QWidget* parent)
 
     m_searchLineEdit = new QLineEdit(this);
     m_searchLineEdit->setPlaceholderText("Search...");
+    m_searchLineEdit->setToolTip(
+        "Filters the prims by name.\n"
+        "A path expression such as /World//Tree_*{isa:Mesh} selects the prims it matches on Enter.");
     m_searchLineEdit->setClearButtonEnabled(true);
 
     connect(
         selectionModel(), &QItemSelectionModel::selectionChanged, this, &UsdOutlinerView::onSelectionChanged);
     connect(m_searchLineEdit, &QLineEdit::textChanged, this, &UsdOutlinerView::onSearchTextChanged);
-
-
+    connect(m_searchLineEdit, &QLineEdit::returnPressed, this, &UsdOutlinerView::onSearchReturnPressed);
     connect(
-        &GlobalSelection::instance(), &GlobalSelection::selectionChanged,
-        this, [this](const PXR_NS::UsdPrim& prim) {
-            if (prim.IsValid()) {
-                focusPrim(prim);
-            } else {
-                selectionModel()->clearSelection();
-            }
-        });
+        &GlobalSelection::instance(),
+        &GlobalSelection::selectionChanged,
+        this,
+        &UsdOutlinerView::onGlobalSelectionChanged);
 }
 
 void UsdOutlinerView::setStage(const PXR_NS::UsdStageRefPtr& stage)
@@ -63,23 +68,107 @@ void UsdOutlinerView::setStage(const PXR_NS::UsdStageRefPtr& stage)
     }
 }
 
-void UsdOutlinerView::onSelectionChanged(const QItemSelection& selected)
+void UsdOutlinerView::onSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
+{
+    if (m_syncingSelection)
+    {
+        return;
+    }
+
+    // only the rows that changed are forwarded, so extending a large selection stays cheap
+    m_syncingSelection = true;
+    {
+        GlobalSelection::Block block;
+        GlobalSelection::instance().remove(pathsFromSelection(deselected));
+        GlobalSelection::instance().add(pathsFromSelection(selected));
+    }
+    m_syncingSelection = false;
+}
+
+void UsdOutlinerView::onGlobalSelectionChanged()
 {
-    if (selected.indexes().isEmpty())
+    // changes made from this view are already in sync
+    if (m_syncingSelection)
     {
         return;
     }
 
-    QModelIndex index = selected.indexes().first().siblingAtColumn(0);
-    PXR_NS::UsdPrim prim = m_proxyModel->primFromIndex(index);
-    if (prim.IsValid())
+    m_refreshScheduler->requestRefresh();
+}
+
+void UsdOutlinerView::syncFromGlobalSelection()
+{
+    m_syncingSelection = true;
+    selectionModel()->select(
+        selectionFromPaths(GlobalSelection::instance().paths()),
+        QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+
+    const PXR_NS::UsdPrim leadPrim = GlobalSelection::instance().prim();
+    if (leadPrim.IsValid())
+    {
+        focusPrim(leadPrim);
+    }
+    m_syncingSelection = false;
+}
+
+PXR_NS::SdfPathVector UsdOutlinerView::pathsFromSelection(const QItemSelection& selection) const
+{
+    PXR_NS::SdfPathVector paths;
+    for (const auto& range : selection)
     {
-        GlobalSelection::instance().setPrim(prim);
+        for (int row = range.top(); row <= range.bottom(); ++row)
+        {
+            const PXR_NS::UsdPrim prim = m_proxyModel->primFromIndex(m_proxyModel->index(row, 0, range.parent()));
+            if (prim.IsValid())
+            {
+                paths.push_back(prim.GetPath());
+            }
+        }
     }
+    return paths;
+}
+
+QItemSelection UsdOutlinerView::selectionFromPaths(const PXR_NS::SdfPathSet& paths) const
+{
+    // group the rows by parent so that runs of adjacent siblings become a single range
+    std::map<QModelIndex, std::vector<int>> rowsByParent;
+    for (const auto& path : paths)
+    {
+        const QModelIndex proxyIndex = m_proxyModel->mapFromSource(m_model->indexFromPath(path));
+        if (proxyIndex.isValid())
+        {
+            rowsByParent[proxyIndex.parent()].push_back(proxyIndex.row());
+        }
+    }
+
+    QItemSelection selection;
+    for (auto& [parent, rows] : rowsByParent)
+    {
+        std::sort(rows.begin(), rows.end());
+        for (size_t first = 0; first < rows.size();)
+        {
+            size_t last = first;
+            while (last + 1 < rows.size() && rows[last + 1] == rows[last] + 1)
+            {
+                ++last;
+            }
+            selection.append(QItemSelectionRange(
+                m_proxyModel->index(rows[first], 0, parent), m_proxyModel->index(rows[last], 0, parent)));
+            first = last + 1;
+        }
+    }
+    return selection;
 }
 
 void UsdOutlinerView::onSearchTextChanged(const QString& text)
 {
+    // path expressions select rather than filter, see onSearchReturnPressed
+    if (looksLikePathExpression(text.toStdString()))
+    {
+        m_proxyModel->setFilterPattern(QString());
+        return;
+    }
+
     m_proxyModel->setFilterPattern(text);
 
     if (!text.isEmpty())
@@ -88,6 +177,25 @@ void UsdOutlinerView::onSearchTextChanged(const QString& text)
     }
 }
 
+void UsdOutlinerView::onSearchReturnPressed()
+{
+    const std::string expression = m_searchLineEdit->text().toStdString();
+    if (!looksLikePathExpression(expression))
+    {
+        return;
+    }
+
+    PXR_NS::SdfPathVector paths;
+    std::string           error;
+    if (!matchPathExpression(m_model->stage(), expression, &paths, &error))
+    {
+        qWarning().noquote() << "Invalid path expression:" << QString::fromStdString(error);
+        return;
+    }
+
+    GlobalSelection::instance().replace(paths);
+}
+
 void UsdOutlinerView::focusPrim(const UsdPrim& prim)
 {
     QModelIndex sourceIndex = m_model->indexFromPrim(prim);
@@ -104,7 +212,9 @@ void UsdOutlinerView::focusPrim(const UsdPrim& prim)
 
     expand(proxyIndex.parent());
     scrollTo(proxyIndex, QAbstractItemView::PositionAtCenter);
-    setCurrentIndex(proxyIndex);
+
+    // the selection itself is driven by GlobalSelection
+    selectionModel()->setCurrentIndex(proxyIndex, QItemSelectionModel::NoUpdate);
 }
 
 } // namespace TINKERUSD_NS
\ No newline at end of file
@@ -2,13 +2,16 @@
 
 #include <QLineEdit>
 #include <QTreeView>
+#include <QItemSelection>
 #include <memory>
+#include <pxr/usd/sdf/path.h>
 #include <pxr/usd/usd/stage.h>
 
 namespace TINKERUSD_NS
 {
 class UsdOutlinerModel;
 class UsdOutlinerFilterProxyModel;
+class PanelRefreshScheduler;
 
 class UsdOutlinerView : public QTreeView
 {
@@ -23,13 +26,22 @@ public:
     void focusPrim(const PXR_NS::UsdPrim& prim);
 
 private slots:
-    void onSelectionChanged(const QItemSelection& selected);
+    void onSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected);
+    void onGlobalSelectionChanged();
     void onSearchTextChanged(const QString& text);
+    void onSearchReturnPressed();
+
+private:
+    void                  syncFromGlobalSelection();
+    PXR_NS::SdfPathVector pathsFromSelection(const QItemSelection& selection) const;
+    QItemSelection        selectionFromPaths(const PXR_NS::SdfPathSet& paths) const;
 
 private:
     UsdOutlinerModel*            m_model;
     UsdOutlinerFilterProxyModel* m_proxyModel;
     QLineEdit*                   m_searchLineEdit;
+    PanelRefreshScheduler*       m_refreshScheduler;
+    bool                         m_syncingSelection { false };
 };
 
 } // namespace TINKERUSD_NS
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include <QHBoxLayout>
 #include <QHeaderView>
+#include <QMenu>
 #include <QShortcut>
 #include <QVBoxLayout>
 #include <pxr/usd/usd/modelAPI.h>
@@ -23,6 +24,7 @@ OutlinerWidget::OutlinerWidget(UsdDocument* document, QWidget* parent)
     onCreateUI();
 
     connect(m_usdDocument, &UsdDocument::stageOpened, this, &OutlinerWidget::onStageOpened);
+    connect(m_usdDocument, &UsdDocument::stagePopulationChanged, this, [this]() { onStageOpened(QString()); });
 }
 
 void OutlinerWidget::onCreateUI()
@@ -49,9 +51,35 @@ void OutlinerWidget::onCreateUI()
         m_treeView->focusPrim(GlobalSelection::instance().prim());
     });
 
+    m_treeView->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(m_treeView, &QWidget::customContextMenuRequested, this, &OutlinerWidget::onContextMenu);
+
     setLayout(mainLayout);
 }
 
+void OutlinerWidget::onContextMenu(const QPoint& pos)
+{
+    const SdfPathSet paths = GlobalSelection::instance().paths();
+    if (paths.empty())
+    {
+        return;
+    }
+
+    QMenu    menu(this);
+    QAction* loadAction = menu.addAction("Load Payloads");
+    QAction* unloadAction = menu.addAction("Unload Payloads");
+
+    QAction* chosen = menu.exec(m_treeView->viewport()->mapToGlobal(pos));
+    if (chosen == loadAction)
+    {
+        m_usdDocument->loadPayloads(paths);
+    }
+    else if (chosen == unloadAction)
+    {
+        m_usdDocument->unloadPayloads(paths);
+    }
+}
+
 void OutlinerWidget::onStageOpened(const QString& filePath)
 {
     m_treeView->setStage(m_usdDocument->getCurrentStage());
@@ -22,6 +22,7 @@ private:
 
 private slots:
     void onStageOpened(const QString& filePath);
+    void onContextMenu(const QPoint& pos);
 
 private:
     UsdDocument*     m_usdDocument;
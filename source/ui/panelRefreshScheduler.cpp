@@ -0,0 +1,58 @@
+#include "panelRefreshScheduler.h"
+
+#include <QEvent>
+#include <QTimer>
+
+namespace TINKERUSD_NS
+{
+
+PanelRefreshScheduler::PanelRefreshScheduler(QWidget* panel, std::function<void()> refresh)
+    : QObject(panel)
+    , m_panel(panel)
+    , m_refresh(std::move(refresh))
+{
+    m_panel->installEventFilter(this);
+}
+
+void PanelRefreshScheduler::requestRefresh()
+{
+    m_stale = true;
+    schedule();
+}
+
+void PanelRefreshScheduler::flush()
+{
+    m_scheduled = false;
+
+    if (!m_stale || !m_panel || !m_panel->isVisible())
+    {
+        return;
+    }
+
+    m_stale = false;
+    m_refresh();
+}
+
+bool PanelRefreshScheduler::eventFilter(QObject* watched, QEvent* event)
+{
+    // catch up on the requests made while hidden
+    if (watched == m_panel && event->type() == QEvent::Show && m_stale)
+    {
+        schedule();
+    }
+
+    return QObject::eventFilter(watched, event);
+}
+
+void PanelRefreshScheduler::schedule()
+{
+    if (m_scheduled || !m_panel || !m_panel->isVisible())
+    {
+        return;
+    }
+
+    m_scheduled = true;
+    QTimer::singleShot(0, this, &PanelRefreshScheduler::flush);
+}
+
+} // namespace TINKERUSD_NS
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QWidget>
+#include <functional>
+
+namespace TINKERUSD_NS
+{
+
+/*
+Coalesces the refresh requests of a panel.
+
+Requests made while a refresh is pending collapse into a single refresh run on the
+next event loop turn. While the panel is hidden, e.g. its dock widget is closed or
+tabbed away, requests only mark it stale and the refresh runs once it is shown again.
+*/
+class PanelRefreshScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    PanelRefreshScheduler(QWidget* panel, std::function<void()> refresh);
+    virtual ~PanelRefreshScheduler() = default;
+
+    void requestRefresh();
+
+    // runs a pending refresh right away.
+    void flush();
+
+    bool isStale() const { return m_stale; }
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    void schedule();
+
+private:
+    QPointer<QWidget>     m_panel;
+    std::function<void()> m_refresh;
+    bool                  m_stale { false };
+    bool                  m_scheduled { false };
+};
+
+} // namespace TINKERUSD_NS
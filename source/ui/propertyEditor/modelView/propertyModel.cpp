@@ -95,7 +95,7 @@ bool PropertyModel::setData(const QModelIndex& index, const QVariant& value, int
             auto attributeWrapper = abstractPropEditor->usdAttributeWrapper();
             if (attributeWrapper) {
                 auto attributeCommand
-                    = new UsdUndoAttributeCommand(attributeWrapper, vtValue, PXR_NS::UsdTimeCode::Default());
+                    = new UsdUndoAttributeCommand(attributeWrapper, vtValue, attributeWrapper->editTime());
                 
                 if (attributeCommand) {
                     sendDataChangedSignal = true;
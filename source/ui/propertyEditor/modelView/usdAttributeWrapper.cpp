@@ -1,6 +1,7 @@
 #include "usdAttributeWrapper.h"
 
 #include "common/utils.h"
+#include "core/timeline.h"
 
 namespace TINKERUSD_NS
 {
@@ -15,16 +16,28 @@ UsdAttributeWrapper::Ptr UsdAttributeWrapper::create(const PXR_NS::UsdAttribute&
     return std::unique_ptr<UsdAttributeWrapper>(new UsdAttributeWrapper(usdAttr));
 }
 
+bool UsdAttributeWrapper::get(PXR_NS::VtValue& value) const
+{
+    return get(value, Timeline::instance().timeCode());
+}
+
 bool UsdAttributeWrapper::get(PXR_NS::VtValue& value, PXR_NS::UsdTimeCode time) const
 {
     return m_usdAttr.Get(&value, time);
 }
 
+bool UsdAttributeWrapper::set(const PXR_NS::VtValue& value) { return set(value, editTime()); }
+
 bool UsdAttributeWrapper::set(const PXR_NS::VtValue& value, PXR_NS::UsdTimeCode time)
 {
     return m_usdAttr.Set(value, time);
 }
 
+PXR_NS::UsdTimeCode UsdAttributeWrapper::editTime() const
+{
+    return m_usdAttr.GetNumTimeSamples() > 0 ? Timeline::instance().timeCode() : PXR_NS::UsdTimeCode::Default();
+}
+
 bool UsdAttributeWrapper::isAuthored() const { return isValid() && m_usdAttr.IsAuthored(); }
 
 bool UsdAttributeWrapper::isValid() const { return m_usdAttr.IsValid(); }
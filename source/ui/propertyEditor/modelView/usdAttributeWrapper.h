@@ -25,11 +25,21 @@ public:
     //! creates a new UsdAttributeWrapper instance.
     static Ptr create(const PXR_NS::UsdAttribute& usdAttr);
 
+    //! retrieves the value of the USD attribute at the current time of the timeline.
+    bool get(PXR_NS::VtValue& value) const;
+
     //! retrieves the value of the USD attribute at a specific time code.
-    bool get(PXR_NS::VtValue& value, PXR_NS::UsdTimeCode time = PXR_NS::UsdTimeCode::Default()) const;
+    bool get(PXR_NS::VtValue& value, PXR_NS::UsdTimeCode time) const;
+
+    //! sets the value of the USD attribute at editTime().
+    bool set(const PXR_NS::VtValue& value);
 
     //! sets the value of the USD attribute at a specific time code.
-    bool set(const PXR_NS::VtValue& value, PXR_NS::UsdTimeCode time = PXR_NS::UsdTimeCode::Default());
+    bool set(const PXR_NS::VtValue& value, PXR_NS::UsdTimeCode time);
+
+    //! the time edits are authored at: the current time of the timeline for animated
+    //! attributes, the default time otherwise so that static values stay static.
+    PXR_NS::UsdTimeCode editTime() const;
 
     //! checks whether the USD attribute has authored data.
     bool isAuthored() const;
@@ -2,11 +2,13 @@
 
 #include "common/utils.h"
 #include "core/globalSelection.h"
+#include "core/timeline.h"
 #include "core/usdDocument.h"
 #include "modelView/propertyModel.h"
 #include "modelView/propertyProxy.h"
 #include "modelView/propertyTreeView.h"
 #include "searchBar.h"
+#include "ui/panelRefreshScheduler.h"
 #include "valueEditors/factory.h"
 
 #include <QtCore/QTimer>
@@ -18,6 +20,7 @@ namespace TINKERUSD_NS
 PropertyWidget::PropertyWidget(UsdDocument* document, QWidget* parent)
     : QWidget(parent)
     , m_usdDocument(document)
+    , m_refreshScheduler(new PanelRefreshScheduler(this, [this]() { refresh(); }))
 {
     onCreateUI();
 
@@ -28,6 +31,20 @@ PropertyWidget::PropertyWidget(UsdDocument* document, QWidget* parent)
         &GlobalSelection::selectionChanged,
         this,
         &PropertyWidget::onSelectionChanged);
+
+    // values are shown at the current time, refreshing them during playback would only slow it down
+    connect(&Timeline::instance(), &Timeline::timeChanged, this, [this]() {
+        if (!Timeline::instance().isPlaying())
+        {
+            m_refreshScheduler->requestRefresh();
+        }
+    });
+    connect(&Timeline::instance(), &Timeline::playbackChanged, this, [this](bool playing) {
+        if (!playing)
+        {
+            m_refreshScheduler->requestRefresh();
+        }
+    });
 }
 
 void PropertyWidget::onCreateUI()
@@ -45,7 +62,9 @@ void PropertyWidget::onCreateUI()
 
 void PropertyWidget::onStageOpened(const QString& filePath) { m_treeView->getModel()->reset(); }
 
-void PropertyWidget::onSelectionChanged()
+void PropertyWidget::onSelectionChanged() { m_refreshScheduler->requestRefresh(); }
+
+void PropertyWidget::refresh()
 {
     m_treeView->getModel()->reset();
 
@@ -9,6 +9,7 @@ namespace TINKERUSD_NS
 class SearchBar;
 class PropertyTreeView;
 class UsdDocument;
+class PanelRefreshScheduler;
 
 class PropertyWidget : public QWidget
 {
@@ -24,11 +25,13 @@ private slots:
 
 private:
     void onCreateUI();
+    void refresh();
 
 private:
-    PropertyTreeView* m_treeView;
-    SearchBar*        m_searchBar;
-    UsdDocument*      m_usdDocument { nullptr };
+    PropertyTreeView*      m_treeView;
+    SearchBar*             m_searchBar;
+    UsdDocument*           m_usdDocument { nullptr };
+    PanelRefreshScheduler* m_refreshScheduler { nullptr };
 };
 
 } // namespace TINKERUSD_NS
\ No newline at end of file
@@ -0,0 +1,418 @@
+#include "rendererSettingsWidget.h"
+
+#include "viewportOpenGLWidget.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDebug>
+#include <QDir>
+#include <QDoubleSpinBox>
+#include <QFile>
+#include <QFileInfo>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QInputDialog>
+#include <QJsonDocument>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QScrollArea>
+#include <QSpinBox>
+#include <QStandardPaths>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+
+QString presetsFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/renderPresets.json";
+}
+
+QJsonValue toJson(const VtValue& value)
+{
+    if (value.IsHolding<bool>())
+        return value.UncheckedGet<bool>();
+    if (value.IsHolding<int>())
+        return value.UncheckedGet<int>();
+    if (value.IsHolding<float>())
+        return value.UncheckedGet<float>();
+    if (value.IsHolding<double>())
+        return value.UncheckedGet<double>();
+    if (value.IsHolding<std::string>())
+        return QString::fromStdString(value.UncheckedGet<std::string>());
+    return QJsonValue();
+}
+
+// converts back to the type the renderer uses for the setting, given by its default value.
+VtValue fromJson(const QJsonValue& json, const VtValue& defaultValue)
+{
+    if (defaultValue.IsHolding<bool>())
+        return VtValue(json.toBool());
+    if (defaultValue.IsHolding<int>())
+        return VtValue(json.toInt());
+    if (defaultValue.IsHolding<float>())
+        return VtValue(static_cast<float>(json.toDouble()));
+    if (defaultValue.IsHolding<double>())
+        return VtValue(json.toDouble());
+    if (defaultValue.IsHolding<std::string>())
+        return VtValue(json.toString().toStdString());
+    return VtValue();
+}
+
+} // namespace
+
+namespace TINKERUSD_NS
+{
+
+RendererSettingsWidget::RendererSettingsWidget(ViewportOpenGLWidget* viewport, QWidget* parent)
+    : QWidget(parent)
+    , m_viewport(viewport)
+{
+    onCreateUI();
+    loadPresets();
+    updatePresetList();
+
+    connect(
+        m_viewport,
+        &ViewportOpenGLWidget::rendererAvailable,
+        this,
+        &RendererSettingsWidget::onRendererAvailable);
+
+    onRendererAvailable();
+}
+
+void RendererSettingsWidget::onCreateUI()
+{
+    m_rendererCombo = new QComboBox(this);
+    m_rendererCombo->setToolTip("Hydra renderer plugin of the viewport");
+
+    m_adaptiveQualityCheck = new QCheckBox("Adaptive quality while navigating", this);
+    m_adaptiveQualityCheck->setToolTip(
+        "Lower the resolution, materials and lights while the camera moves to stay within the frame budget");
+    m_adaptiveQualityCheck->setChecked(m_viewport->adaptiveQuality());
+
+    m_frameBudgetSpinBox = new QDoubleSpinBox(this);
+    m_frameBudgetSpinBox->setRange(4.0, 500.0);
+    m_frameBudgetSpinBox->setDecimals(0);
+    m_frameBudgetSpinBox->setSuffix(" ms");
+    m_frameBudgetSpinBox->setKeyboardTracking(false);
+    m_frameBudgetSpinBox->setValue(m_viewport->frameBudgetMs());
+    m_frameBudgetSpinBox->setEnabled(m_viewport->adaptiveQuality());
+
+    m_colorFormatCombo = new QComboBox(this);
+    m_colorFormatCombo->setToolTip("Color format the viewport renders into before its sRGB conversion");
+    m_colorFormatCombo->addItem("RGBA16F", static_cast<int>(UsdDrawTargetFBO::ColorFormat::RGBA16F));
+    m_colorFormatCombo->addItem("RGBA8", static_cast<int>(UsdDrawTargetFBO::ColorFormat::RGBA8));
+    m_colorFormatCombo->setCurrentIndex(
+        m_colorFormatCombo->findData(static_cast<int>(m_viewport->colorFormat())));
+
+    m_presetCombo = new QComboBox(this);
+    m_presetCombo->setToolTip("Saved renderer and settings");
+
+    m_applyPresetButton = new QToolButton(this);
+    m_applyPresetButton->setText("Apply");
+    m_savePresetButton = new QToolButton(this);
+    m_savePresetButton->setText("Save...");
+    m_savePresetButton->setToolTip("Save the current renderer and settings as a preset");
+    m_deletePresetButton = new QToolButton(this);
+    m_deletePresetButton->setText("Delete");
+
+    m_restoreDefaultsButton = new QPushButton("Restore Defaults", this);
+
+    m_settingsContainer = new QWidget(this);
+    m_settingsLayout = new QFormLayout(m_settingsContainer);
+
+    auto scrollArea = new QScrollArea(this);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setWidget(m_settingsContainer);
+
+    auto presetLayout = new QHBoxLayout;
+    presetLayout->addWidget(m_presetCombo, 1);
+    presetLayout->addWidget(m_applyPresetButton);
+    presetLayout->addWidget(m_savePresetButton);
+    presetLayout->addWidget(m_deletePresetButton);
+
+    auto headerLayout = new QFormLayout;
+    headerLayout->addRow("Renderer", m_rendererCombo);
+    headerLayout->addRow("Preset", presetLayout);
+    headerLayout->addRow(m_adaptiveQualityCheck);
+    headerLayout->addRow("Frame Budget", m_frameBudgetSpinBox);
+    headerLayout->addRow("Color Buffer", m_colorFormatCombo);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(2, 2, 2, 2);
+    mainLayout->addLayout(headerLayout);
+    mainLayout->addWidget(scrollArea, 1);
+    mainLayout->addWidget(m_restoreDefaultsButton);
+    setLayout(mainLayout);
+
+    connect(
+        m_rendererCombo,
+        QOverload<int>::of(&QComboBox::currentIndexChanged),
+        this,
+        &RendererSettingsWidget::onRendererSelected);
+    connect(m_adaptiveQualityCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        m_viewport->setAdaptiveQuality(checked);
+        m_frameBudgetSpinBox->setEnabled(checked);
+    });
+    connect(
+        m_frameBudgetSpinBox,
+        QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+        m_viewport,
+        &ViewportOpenGLWidget::setFrameBudgetMs);
+    connect(m_colorFormatCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        const int colorFormat = m_colorFormatCombo->itemData(index).toInt();
+        m_viewport->setColorFormat(static_cast<UsdDrawTargetFBO::ColorFormat>(colorFormat));
+    });
+    connect(m_applyPresetButton, &QToolButton::clicked, this, &RendererSettingsWidget::onApplyPreset);
+    connect(m_savePresetButton, &QToolButton::clicked, this, &RendererSettingsWidget::onSavePreset);
+    connect(m_deletePresetButton, &QToolButton::clicked, this, &RendererSettingsWidget::onDeletePreset);
+    connect(m_restoreDefaultsButton, &QPushButton::clicked, this, &RendererSettingsWidget::onRestoreDefaults);
+}
+
+void RendererSettingsWidget::onRendererAvailable()
+{
+    m_updatingControls = true;
+
+    m_rendererCombo->clear();
+    const TfToken current = m_viewport->rendererPlugin();
+    for (const TfToken& rendererId : m_viewport->rendererPlugins())
+    {
+        m_rendererCombo->addItem(
+            QString::fromStdString(UsdRenderEngineGL::rendererDisplayName(rendererId)),
+            QString::fromStdString(rendererId.GetString()));
+        if (rendererId == current)
+        {
+            m_rendererCombo->setCurrentIndex(m_rendererCombo->count() - 1);
+        }
+    }
+
+    m_updatingControls = false;
+
+    rebuildSettings();
+}
+
+void RendererSettingsWidget::onRendererSelected(int index)
+{
+    if (m_updatingControls || index < 0)
+    {
+        return;
+    }
+
+    const TfToken rendererId(m_rendererCombo->itemData(index).toString().toStdString());
+    if (!m_viewport->setRendererPlugin(rendererId))
+    {
+        // back to the renderer still in use
+        onRendererAvailable();
+    }
+}
+
+void RendererSettingsWidget::rebuildSettings()
+{
+    while (m_settingsLayout->rowCount() > 0)
+    {
+        m_settingsLayout->removeRow(0);
+    }
+
+    const auto settings = m_viewport->rendererSettings();
+    if (settings.empty())
+    {
+        m_settingsLayout->addRow(new QLabel("The renderer has no settings."));
+        return;
+    }
+
+    for (const UsdImagingGLRendererSetting& setting : settings)
+    {
+        const TfToken key = setting.key;
+        VtValue       value = m_viewport->rendererSetting(key);
+        if (value.IsEmpty())
+        {
+            value = setting.defValue;
+        }
+
+        QWidget* editor = nullptr;
+        switch (setting.type)
+        {
+        case UsdImagingGLRendererSetting::TYPE_FLAG:
+        {
+            auto checkBox = new QCheckBox(m_settingsContainer);
+            checkBox->setChecked(VtValue::Cast<bool>(value).GetWithDefault<bool>(false));
+            connect(checkBox, &QCheckBox::toggled, this, [this, key](bool checked) {
+                m_viewport->setRendererSetting(key, VtValue(checked));
+            });
+            editor = checkBox;
+            break;
+        }
+        case UsdImagingGLRendererSetting::TYPE_INT:
+        {
+            auto spinBox = new QSpinBox(m_settingsContainer);
+            spinBox->setRange(-1000000, 1000000000);
+            spinBox->setKeyboardTracking(false);
+            spinBox->setValue(VtValue::Cast<int>(value).GetWithDefault<int>(0));
+            connect(spinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, [this, key](int newValue) {
+                m_viewport->setRendererSetting(key, VtValue(newValue));
+            });
+            editor = spinBox;
+            break;
+        }
+        case UsdImagingGLRendererSetting::TYPE_FLOAT:
+        {
+            auto spinBox = new QDoubleSpinBox(m_settingsContainer);
+            spinBox->setDecimals(4);
+            spinBox->setRange(-1.0e6, 1.0e6);
+            spinBox->setKeyboardTracking(false);
+            spinBox->setValue(VtValue::Cast<double>(value).GetWithDefault<double>(0.0));
+            const VtValue defValue = setting.defValue;
+            connect(
+                spinBox,
+                QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+                this,
+                [this, key, defValue](double newValue) {
+                    m_viewport->setRendererSetting(key, fromJson(newValue, defValue));
+                });
+            editor = spinBox;
+            break;
+        }
+        case UsdImagingGLRendererSetting::TYPE_STRING:
+        {
+            auto lineEdit = new QLineEdit(m_settingsContainer);
+            const VtValue text = VtValue::Cast<std::string>(value);
+            lineEdit->setText(QString::fromStdString(text.GetWithDefault<std::string>()));
+            connect(lineEdit, &QLineEdit::editingFinished, this, [this, key, lineEdit]() {
+                m_viewport->setRendererSetting(key, VtValue(lineEdit->text().toStdString()));
+            });
+            editor = lineEdit;
+            break;
+        }
+        default: break;
+        }
+
+        if (editor)
+        {
+            editor->setToolTip(QString::fromStdString(key.GetString()));
+            m_settingsLayout->addRow(QString::fromStdString(setting.name), editor);
+        }
+    }
+}
+
+void RendererSettingsWidget::onRestoreDefaults()
+{
+    for (const UsdImagingGLRendererSetting& setting : m_viewport->rendererSettings())
+    {
+        m_viewport->setRendererSetting(setting.key, setting.defValue);
+    }
+    rebuildSettings();
+}
+
+void RendererSettingsWidget::onApplyPreset()
+{
+    const QJsonObject preset = m_presets.value(m_presetCombo->currentText()).toObject();
+    if (preset.isEmpty())
+    {
+        return;
+    }
+
+    const TfToken rendererId(preset.value("renderer").toString().toStdString());
+    if (!m_viewport->setRendererPlugin(rendererId))
+    {
+        return;
+    }
+
+    // settings the renderer no longer has are ignored
+    const QJsonObject values = preset.value("settings").toObject();
+    for (const UsdImagingGLRendererSetting& setting : m_viewport->rendererSettings())
+    {
+        const QString key = QString::fromStdString(setting.key.GetString());
+        if (values.contains(key))
+        {
+            const VtValue value = fromJson(values.value(key), setting.defValue);
+            if (!value.IsEmpty())
+            {
+                m_viewport->setRendererSetting(setting.key, value);
+            }
+        }
+    }
+    rebuildSettings();
+}
+
+void RendererSettingsWidget::onSavePreset()
+{
+    bool          ok;
+    const QString name = QInputDialog::getText(
+        this, "Save Renderer Preset", "Preset name:", QLineEdit::Normal, m_presetCombo->currentText(), &ok);
+    if (!ok || name.trimmed().isEmpty())
+    {
+        return;
+    }
+
+    QJsonObject values;
+    for (const UsdImagingGLRendererSetting& setting : m_viewport->rendererSettings())
+    {
+        const QJsonValue value = toJson(m_viewport->rendererSetting(setting.key));
+        if (!value.isNull())
+        {
+            values[QString::fromStdString(setting.key.GetString())] = value;
+        }
+    }
+
+    QJsonObject preset;
+    preset["renderer"] = QString::fromStdString(m_viewport->rendererPlugin().GetString());
+    preset["settings"] = values;
+    m_presets[name.trimmed()] = preset;
+
+    savePresets();
+    updatePresetList();
+    m_presetCombo->setCurrentText(name.trimmed());
+}
+
+void RendererSettingsWidget::onDeletePreset()
+{
+    if (m_presetCombo->currentIndex() < 0)
+    {
+        return;
+    }
+
+    m_presets.remove(m_presetCombo->currentText());
+    savePresets();
+    updatePresetList();
+}
+
+void RendererSettingsWidget::updatePresetList()
+{
+    m_presetCombo->clear();
+    m_presetCombo->addItems(m_presets.keys());
+
+    const bool hasPresets = !m_presets.isEmpty();
+    m_applyPresetButton->setEnabled(hasPresets);
+    m_deletePresetButton->setEnabled(hasPresets);
+}
+
+void RendererSettingsWidget::loadPresets()
+{
+    QFile file(presetsFilePath());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+    m_presets = QJsonDocument::fromJson(file.readAll()).object();
+}
+
+void RendererSettingsWidget::savePresets() const
+{
+    const QString filePath = presetsFilePath();
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "Could not save renderer presets to" << filePath;
+        return;
+    }
+    file.write(QJsonDocument(m_presets).toJson(QJsonDocument::Indented));
+}
+
+} // namespace TINKERUSD_NS
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QWidget>
+
+class QCheckBox;
+class QComboBox;
+class QDoubleSpinBox;
+class QFormLayout;
+class QPushButton;
+class QToolButton;
+
+namespace TINKERUSD_NS
+{
+
+class ViewportOpenGLWidget;
+
+// renderer plugin choice and settings of the viewport. The settings editors are generated from
+// the settings the current renderer exposes. A renderer with its settings can be saved as a
+// named preset, kept across sessions. Also holds the interactive quality options of the viewport.
+class RendererSettingsWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    RendererSettingsWidget(ViewportOpenGLWidget* viewport, QWidget* parent = nullptr);
+    virtual ~RendererSettingsWidget() = default;
+
+private slots:
+    void onRendererAvailable();
+    void onRendererSelected(int index);
+    void onApplyPreset();
+    void onSavePreset();
+    void onDeletePreset();
+    void onRestoreDefaults();
+
+private:
+    void onCreateUI();
+    void rebuildSettings();
+    void updatePresetList();
+    void loadPresets();
+    void savePresets() const;
+
+private:
+    ViewportOpenGLWidget* m_viewport;
+    QComboBox*            m_rendererCombo;
+    QCheckBox*            m_adaptiveQualityCheck;
+    QDoubleSpinBox*       m_frameBudgetSpinBox;
+    QComboBox*            m_colorFormatCombo;
+    QComboBox*            m_presetCombo;
+    QToolButton*          m_applyPresetButton;
+    QToolButton*          m_savePresetButton;
+    QToolButton*          m_deletePresetButton;
+    QPushButton*          m_restoreDefaultsButton;
+    QWidget*              m_settingsContainer;
+    QFormLayout*          m_settingsLayout;
+    QJsonObject           m_presets; // by name: { "renderer": id, "settings": { key: value } }
+    bool                  m_updatingControls { false };
+};
+
+} // namespace TINKERUSD_NS
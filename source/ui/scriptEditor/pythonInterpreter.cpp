@@ -0,0 +1,182 @@
+// must be called before anything else
+extern "C" {
+#include <Python.h>
+}
+
+#include "pythonInterpreter.h"
+
+#include <cstdio>
+
+namespace TINKERUSD_NS
+{
+
+// https://docs.python.org/3/c-api/import.html
+// Python module to redirect stdout/stderr
+static PyObject* redirector_write(PyObject* self, PyObject* args)
+{
+    const char* text;
+    if (!PyArg_ParseTuple(args, "s", &text))
+    {
+        return nullptr;
+    }
+
+    PythonInterpreter::instance().write(QString(text));
+    return Py_BuildValue("");
+}
+
+static PyMethodDef RedirectorMethods[] = { { "write", redirector_write, METH_VARARGS, "Write to Qt console" },
+                                           { nullptr, nullptr, 0, nullptr } };
+
+static PyModuleDef RedirectorModule
+    = { PyModuleDef_HEAD_INIT, "redirector", "Redirector module for Python output", -1, RedirectorMethods };
+
+static PyObject* PyInit_Redirector(void) { return PyModule_Create(&RedirectorModule); }
+
+PythonInterpreter& PythonInterpreter::instance()
+{
+    static PythonInterpreter instance;
+    return instance;
+}
+
+void PythonInterpreter::initialize()
+{
+    if (Py_IsInitialized())
+    {
+        return;
+    }
+
+    PyImport_AppendInittab("redirector", &PyInit_Redirector);
+    Py_Initialize();
+    PyRun_SimpleString("import sys\n"
+                       "import redirector\n"
+                       "class StdoutRedirector:\n"
+                       "    def write(self, text):\n"
+                       "        redirector.write(text)\n"
+                       "    def flush(self):\n"
+                       "        pass\n"
+                       "sys.stdout = StdoutRedirector()\n"
+                       "sys.stderr = StdoutRedirector()\n");
+}
+
+void PythonInterpreter::finalize()
+{
+    if (Py_IsInitialized())
+    {
+        Py_Finalize();
+    }
+}
+
+void PythonInterpreter::setOutputHandler(OutputHandler handler) { m_outputHandler = std::move(handler); }
+
+void PythonInterpreter::write(const QString& text)
+{
+    if (m_outputHandler)
+    {
+        m_outputHandler(text);
+    }
+    else
+    {
+        std::fputs(text.toUtf8().constData(), stdout);
+        std::fflush(stdout);
+    }
+}
+
+void PythonInterpreter::setArguments(const QStringList& arguments)
+{
+    PyObject* argv = PyList_New(0);
+    for (const QString& argument : arguments)
+    {
+        PyObject* item = PyUnicode_FromString(argument.toUtf8().constData());
+        PyList_Append(argv, item);
+        Py_DECREF(item);
+    }
+    PySys_SetObject("argv", argv);
+    Py_DECREF(argv);
+}
+
+/**
+ * When using separate globals and locals dictionaries in PyRun_String():
+ * - Top-level imports (like 'from pxr import UsdGeom') go into the locals dictionary
+ * - Function definitions also go into locals, but functions look up names in globals by default
+ * - This causes NameError when functions try to access imported modules
+ *
+ * I am using the same dictionary (globals) for both parameters. This behavior matches Python's interactive interpreter
+ * This ensures that imports are accessible to both module-level code and function definitions
+ * Example that would fail with separate locals/globals:
+ *   from pxr import UsdGeom
+ *   def my_function():
+ *       geom = UsdGeom.Sphere()  # NameError: 'UsdGeom' is not defined
+ *
+ * Note: This approach does not persist state between script runs. Each execution
+ * starts with a fresh namespace containing only Python built-ins.
+ */
+int PythonInterpreter::run(const QString& script, const QString& fileName)
+{
+    // get the __main__ module and its global namespace dictionary
+    PyObject* main = PyImport_AddModule("__main__");
+    PyObject* globals = PyModule_GetDict(main);
+
+    // compiling with the file name gives meaningful tracebacks for batch scripts
+    PyObject* code = Py_CompileString(script.toUtf8().constData(), fileName.toUtf8().constData(), Py_file_input);
+
+    // use globals for both parameters - this ensures functions can access
+    // imported modules and variables defined at module level
+    PyObject* result = code ? PyEval_EvalCode(code, globals, globals) : nullptr;
+    Py_XDECREF(code);
+
+    if (result)
+    {
+        Py_DECREF(result);
+        return 0;
+    }
+
+    // PyErr_Print() would terminate the process on SystemExit
+    if (PyErr_ExceptionMatches(PyExc_SystemExit))
+    {
+        return handleSystemExit();
+    }
+
+    // on error, print Python traceback to stderr (which is redirected)
+    PyErr_Print();
+    return 1;
+}
+
+int PythonInterpreter::handleSystemExit()
+{
+    PyObject* type = nullptr;
+    PyObject* value = nullptr;
+    PyObject* traceback = nullptr;
+    PyErr_Fetch(&type, &value, &traceback);
+    PyErr_NormalizeException(&type, &value, &traceback);
+
+    int       status = 0;
+    PyObject* code = value ? PyObject_GetAttrString(value, "code") : nullptr;
+    if (code && code != Py_None)
+    {
+        if (PyLong_Check(code))
+        {
+            status = static_cast<int>(PyLong_AsLong(code));
+        }
+        else
+        {
+            // sys.exit("message") prints the message and exits with 1
+            PyObject* message = PyObject_Str(code);
+            if (message)
+            {
+                write(QString::fromUtf8(PyUnicode_AsUTF8(message)) + "\n");
+                Py_DECREF(message);
+            }
+            status = 1;
+        }
+    }
+    PyErr_Clear();
+
+    Py_XDECREF(code);
+    Py_XDECREF(type);
+    Py_XDECREF(value);
+    Py_XDECREF(traceback);
+
+    return status;
+}
+
+} // namespace TINKERUSD_NS
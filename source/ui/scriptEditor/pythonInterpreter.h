@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+namespace TINKERUSD_NS
+{
+
+/*
+Embedded Python interpreter shared by the script editor and the headless batch mode.
+It has no widget dependencies: Python's stdout/stderr are forwarded to the output
+handler, or to the process stdout when no handler is set.
+*/
+class PythonInterpreter
+{
+public:
+    using OutputHandler = std::function<void(const QString&)>;
+
+    static PythonInterpreter& instance();
+
+    void initialize();
+    void finalize();
+
+    void setOutputHandler(OutputHandler handler);
+    void write(const QString& text);
+
+    // sets sys.argv for the scripts that follow.
+    void setArguments(const QStringList& arguments);
+
+    // runs the script in the __main__ namespace and returns an exit status:
+    // 0 on success, 1 on an uncaught exception, or the code passed to sys.exit().
+    int run(const QString& script, const QString& fileName = "<string>");
+
+private:
+    PythonInterpreter() = default;
+
+    int handleSystemExit();
+
+private:
+    OutputHandler m_outputHandler;
+};
+
+} // namespace TINKERUSD_NS
@@ -1,9 +1,5 @@
-// must be called before anything else
-extern "C" {
-#include <Python.h>
-}
-
 #include "codeEditor.h"
+#include "pythonInterpreter.h"
 #include "scriptEditor.h"
 
 #include <QHBoxLayout>
@@ -19,54 +15,6 @@ extern "C" {
 namespace TINKERUSD_NS
 {
 
-// https://docs.python.org/3/c-api/import.html
-// Custom stream redirection to capture Python's stdout/stderr
-class PythonRedirector
-{
-public:
-    static PythonRedirector& instance()
-    {
-        static PythonRedirector instance;
-        return instance;
-    }
-
-    void setOutputConsole(QPlainTextEdit* console) { outputConsole = console; }
-
-    void write(const QString& text)
-    {
-        if (outputConsole)
-            outputConsole->appendPlainText(text);
-    }
-
-private:
-    PythonRedirector()
-        : outputConsole(nullptr)
-    {
-    }
-    QPlainTextEdit* outputConsole;
-};
-
-// Python module to redirect stdout/stderr
-static PyObject* redirector_write(PyObject* self, PyObject* args)
-{
-    const char* text;
-    if (!PyArg_ParseTuple(args, "s", &text))
-    {
-        return nullptr;
-    }
-
-    PythonRedirector::instance().write(QString(text));
-    return Py_BuildValue("");
-}
-
-static PyMethodDef RedirectorMethods[] = { { "write", redirector_write, METH_VARARGS, "Write to Qt console" },
-                                           { nullptr, nullptr, 0, nullptr } };
-
-static PyModuleDef RedirectorModule
-    = { PyModuleDef_HEAD_INIT, "redirector", "Redirector module for Python output", -1, RedirectorMethods };
-
-static PyObject* PyInit_Redirector(void) { return PyModule_Create(&RedirectorModule); }
-
 ScriptEditor::ScriptEditor(QWidget* parent)
     : QWidget(parent)
 {
@@ -76,27 +24,12 @@ ScriptEditor::ScriptEditor(QWidget* parent)
 
 ScriptEditor::~ScriptEditor() { finalizePython(); }
 
-void ScriptEditor::initializePython()
-{
-    PyImport_AppendInittab("redirector", &PyInit_Redirector);
-    Py_Initialize();
-    PyRun_SimpleString("import sys\n"
-                       "import redirector\n"
-                       "class StdoutRedirector:\n"
-                       "    def write(self, text):\n"
-                       "        redirector.write(text)\n"
-                       "    def flush(self):\n"
-                       "        pass\n"
-                       "sys.stdout = StdoutRedirector()\n"
-                       "sys.stderr = StdoutRedirector()\n");
-}
+void ScriptEditor::initializePython() { PythonInterpreter::instance().initialize(); }
 
 void ScriptEditor::finalizePython()
 {
-    if (Py_IsInitialized())
-    {
-        Py_Finalize();
-    }
+    PythonInterpreter::instance().setOutputHandler(nullptr);
+    PythonInterpreter::instance().finalize();
 }
 
 void ScriptEditor::setupUI()
@@ -138,7 +71,8 @@ void ScriptEditor::setupUI()
     m_outputConsole->setReadOnly(true);
     m_outputConsole->setMaximumBlockCount(40000);
 
-    PythonRedirector::instance().setOutputConsole(m_outputConsole);
+    PythonInterpreter::instance().setOutputHandler(
+        [console = m_outputConsole](const QString& text) { console->appendPlainText(text); });
 
     QToolButton* runButton = new QToolButton();
     QIcon        runIcon(":/run_script.png");
@@ -200,22 +134,6 @@ CodeEditor* ScriptEditor::currentScriptEditor() const
     return nullptr;
 }
 
-/**
- * When using separate globals and locals dictionaries in PyRun_String():
- * - Top-level imports (like 'from pxr import UsdGeom') go into the locals dictionary
- * - Function definitions also go into locals, but functions look up names in globals by default
- * - This causes NameError when functions try to access imported modules
- * 
- * I am using the same dictionary (globals) for both parameters to PyRun_String(). This behavior matches Python's interactive interpreter
- * This ensures that imports are accessible to both module-level code and function definitions
-  * Example that would fail with separate locals/globals:
- *   from pxr import UsdGeom
- *   def my_function():
- *       geom = UsdGeom.Sphere()  # NameError: 'UsdGeom' is not defined
- * 
- * Note: This approach does not persist state between script runs. Each execution
- * starts with a fresh namespace containing only Python built-ins.
- */
 void ScriptEditor::runScript()
 {
     // get the currently active script editor tab
@@ -230,27 +148,12 @@ void ScriptEditor::runScript()
         return;
     }
 
-    // get the __main__ module and its global namespace dictionary
-    PyObject* main = PyImport_AddModule("__main__");
-    PyObject* globals = PyModule_GetDict(main);
-
-    // use globals for both parameters - this ensures functions can access
-    // imported modules and variables defined at module level
-    PyObject* result = PyRun_String(script.toUtf8().constData(), Py_file_input, globals, globals);
-
-    // if evaluation succeeded, display the script (or results if desired)
-    if (result)
+    // if evaluation succeeded, display the script (or results if desired).
+    // errors are printed to stderr, which is redirected to the UI
+    if (PythonInterpreter::instance().run(script) == 0)
     {
-        Py_DECREF(result);
         m_outputConsole->appendPlainText(script);
     }
-    else
-    {
-        // on error, print Python traceback to stderr (which is redirected to the UI)
-        PyErr_Print();
-    }
-
-    // No need to clean up locals since we're using globals. Revisit this...
 }
 
 void ScriptEditor::clearOutput()
@@ -0,0 +1,121 @@
+#include "stageOpenDialog.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+namespace
+{
+QStringList nonEmptyLines(const QPlainTextEdit* edit)
+{
+    return edit->toPlainText().split('\n', Qt::SkipEmptyParts);
+}
+} // namespace
+
+using namespace TINKERUSD_NS;
+
+StageOpenDialog::StageOpenDialog(QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Open Stage");
+    auto* form = new QFormLayout;
+
+    m_pathEdit = new QLineEdit(this);
+    auto* browseButton = new QToolButton(this);
+    browseButton->setIcon(QIcon(":/browse.png"));
+    browseButton->setToolTip("Browse");
+
+    auto* pathLayout = new QHBoxLayout;
+    pathLayout->addWidget(m_pathEdit, 1);
+    pathLayout->addWidget(browseButton);
+
+    m_maskEdit = new QPlainTextEdit(this);
+    m_maskEdit->setPlaceholderText("Prim paths or patterns, one per line (e.g. /World/Sets/Tree_*).\n"
+                                   "Leave empty to populate the whole stage.");
+
+    m_loadPolicyCombo = new QComboBox(this);
+    m_loadPolicyCombo->addItem("Load All", static_cast<int>(StageOpenOptions::LoadPolicy::LOAD_ALL));
+    m_loadPolicyCombo->addItem("Load None", static_cast<int>(StageOpenOptions::LoadPolicy::LOAD_NONE));
+    m_loadPolicyCombo->addItem("Load By Rules", static_cast<int>(StageOpenOptions::LoadPolicy::LOAD_BY_RULES));
+
+    m_includeEdit = new QPlainTextEdit(this);
+    m_includeEdit->setPlaceholderText("Prim paths whose payloads are loaded, one per line.");
+    m_excludeEdit = new QPlainTextEdit(this);
+    m_excludeEdit->setPlaceholderText("Prim paths whose payloads stay unloaded, one per line.");
+
+    m_parallelPrefetchCheck = new QCheckBox("Open dependent layers in parallel", this);
+    m_parallelPrefetchCheck->setChecked(StageOpenOptions().parallelPrefetch);
+    m_parallelPrefetchCheck->setToolTip("Off by default. Speeds up opening stages from network file systems.");
+
+    form->addRow("File", pathLayout);
+    form->addRow("Population Mask", m_maskEdit);
+    form->addRow("Payloads", m_loadPolicyCombo);
+    form->addRow("Load", m_includeEdit);
+    form->addRow("Don't Load", m_excludeEdit);
+    form->addRow("Prefetch", m_parallelPrefetchCheck);
+
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Open | QDialogButtonBox::Cancel, this);
+    buttons->button(QDialogButtonBox::Open)->setEnabled(false);
+
+    connect(browseButton, &QToolButton::clicked, this, &StageOpenDialog::onBrowse);
+    connect(
+        m_loadPolicyCombo,
+        QOverload<int>::of(&QComboBox::currentIndexChanged),
+        this,
+        &StageOpenDialog::onLoadPolicyChanged);
+    connect(m_pathEdit, &QLineEdit::textChanged, this, [buttons](const QString& text) {
+        buttons->button(QDialogButtonBox::Open)->setEnabled(!text.trimmed().isEmpty());
+    });
+    connect(buttons, &QDialogButtonBox::accepted, this, &StageOpenDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &StageOpenDialog::reject);
+
+    onLoadPolicyChanged(m_loadPolicyCombo->currentIndex());
+
+    auto* layout = new QVBoxLayout(this);
+    layout->addLayout(form);
+    layout->addWidget(buttons);
+    setLayout(layout);
+}
+
+QString StageOpenDialog::filePath() const { return m_pathEdit->text().trimmed(); }
+
+StageOpenOptions StageOpenDialog::options() const
+{
+    StageOpenOptions options;
+    options.populationMask = nonEmptyLines(m_maskEdit);
+    options.loadPolicy = static_cast<StageOpenOptions::LoadPolicy>(m_loadPolicyCombo->currentData().toInt());
+    if (options.loadPolicy == StageOpenOptions::LoadPolicy::LOAD_BY_RULES)
+    {
+        options.loadIncludePaths = nonEmptyLines(m_includeEdit);
+        options.loadExcludePaths = nonEmptyLines(m_excludeEdit);
+    }
+    options.parallelPrefetch = m_parallelPrefetchCheck->isChecked();
+    return options;
+}
+
+void StageOpenDialog::onBrowse()
+{
+    QString file = QFileDialog::getOpenFileName(
+        this, "Open USD Stage", m_pathEdit->text(), "USD Files (*.usd *.usda *.usdc *.usdz)");
+    if (!file.isEmpty())
+    {
+        m_pathEdit->setText(file);
+    }
+}
+
+void StageOpenDialog::onLoadPolicyChanged(int index)
+{
+    const auto policy = static_cast<StageOpenOptions::LoadPolicy>(m_loadPolicyCombo->itemData(index).toInt());
+    const bool byRules = policy == StageOpenOptions::LoadPolicy::LOAD_BY_RULES;
+
+    m_includeEdit->setEnabled(byRules);
+    m_excludeEdit->setEnabled(byRules);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "core/usdDocument.h"
+
+#include <QDialog>
+
+class QCheckBox;
+class QComboBox;
+class QLineEdit;
+class QPlainTextEdit;
+
+namespace TINKERUSD_NS
+{
+
+// lets the user pick a stage along with its population mask and payload load policy.
+class StageOpenDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    StageOpenDialog(QWidget* parent = nullptr);
+
+    QString          filePath() const;
+    StageOpenOptions options() const;
+
+private slots:
+    void onBrowse();
+    void onLoadPolicyChanged(int index);
+
+private:
+    QLineEdit*      m_pathEdit;
+    QPlainTextEdit* m_maskEdit;
+    QComboBox*      m_loadPolicyCombo;
+    QPlainTextEdit* m_includeEdit;
+    QPlainTextEdit* m_excludeEdit;
+    QCheckBox*      m_parallelPrefetchCheck;
+};
+
+} // namespace TINKERUSD_NS
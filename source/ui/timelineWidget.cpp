@@ -0,0 +1,148 @@
+#include "timelineWidget.h"
+
+#include "core/timeline.h"
+
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QSlider>
+#include <QToolButton>
+#include <cmath>
+
+namespace TINKERUSD_NS
+{
+
+TimelineWidget::TimelineWidget(QWidget* parent)
+    : QWidget(parent)
+{
+    onCreateUI();
+
+    auto& timeline = Timeline::instance();
+    connect(&timeline, &Timeline::rangeChanged, this, &TimelineWidget::onRangeChanged);
+    connect(&timeline, &Timeline::timeChanged, this, &TimelineWidget::onTimeChanged);
+    connect(&timeline, &Timeline::playbackChanged, this, &TimelineWidget::onPlaybackChanged);
+
+    onRangeChanged(timeline.startTime(), timeline.endTime());
+    onTimeChanged(timeline.currentTime());
+}
+
+void TimelineWidget::onCreateUI()
+{
+    auto makeButton = [this](const QString& text, const QString& toolTip) {
+        auto button = new QToolButton(this);
+        button->setText(text);
+        button->setToolTip(toolTip);
+        return button;
+    };
+
+    m_firstButton = makeButton("|<", "First frame");
+    m_previousButton = makeButton("<", "Previous frame");
+    m_playButton = makeButton("Play", "Play or pause");
+    m_nextButton = makeButton(">", "Next frame");
+    m_lastButton = makeButton(">|", "Last frame");
+
+    m_slider = new QSlider(Qt::Horizontal, this);
+
+    m_timeSpinBox = new QDoubleSpinBox(this);
+    m_timeSpinBox->setDecimals(2);
+    m_timeSpinBox->setKeyboardTracking(false);
+
+    m_loopCheck = new QCheckBox("Loop", this);
+    m_loopCheck->setChecked(Timeline::instance().isLooping());
+
+    m_rangeLabel = new QLabel(this);
+    m_droppedFramesLabel = new QLabel(this);
+    m_droppedFramesLabel->setToolTip("Frames skipped during playback to keep up with the frame rate");
+
+    QHBoxLayout* mainLayout = new QHBoxLayout(this);
+    mainLayout->setContentsMargins(2, 2, 2, 2);
+    mainLayout->addWidget(m_firstButton);
+    mainLayout->addWidget(m_previousButton);
+    mainLayout->addWidget(m_playButton);
+    mainLayout->addWidget(m_nextButton);
+    mainLayout->addWidget(m_lastButton);
+    mainLayout->addWidget(m_slider, 1); // 1 = stretch factor
+    mainLayout->addWidget(m_timeSpinBox);
+    mainLayout->addWidget(m_loopCheck);
+    mainLayout->addWidget(m_rangeLabel);
+    mainLayout->addWidget(m_droppedFramesLabel);
+    setLayout(mainLayout);
+
+    auto& timeline = Timeline::instance();
+    connect(m_playButton, &QToolButton::clicked, &timeline, &Timeline::togglePlayback);
+    connect(m_firstButton, &QToolButton::clicked, this, [&timeline]() {
+        timeline.setCurrentTime(timeline.startTime());
+    });
+    connect(m_lastButton, &QToolButton::clicked, this, [&timeline]() {
+        timeline.setCurrentTime(timeline.endTime());
+    });
+    connect(m_previousButton, &QToolButton::clicked, this, [this]() { stepFrames(-1); });
+    connect(m_nextButton, &QToolButton::clicked, this, [this]() { stepFrames(1); });
+    connect(m_loopCheck, &QCheckBox::toggled, &timeline, &Timeline::setLooping);
+
+    connect(m_slider, &QSlider::valueChanged, this, [this, &timeline](int frame) {
+        if (!m_updatingControls)
+        {
+            timeline.setCurrentTime(timeline.startTime() + frame * timeline.frameStep());
+        }
+    });
+    connect(
+        m_timeSpinBox,
+        QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+        this,
+        [this, &timeline](double time) {
+            if (!m_updatingControls)
+            {
+                timeline.setCurrentTime(time);
+            }
+        });
+}
+
+void TimelineWidget::stepFrames(int frames)
+{
+    auto& timeline = Timeline::instance();
+    timeline.pause();
+    timeline.setCurrentTime(timeline.currentTime() + frames * timeline.frameStep());
+}
+
+void TimelineWidget::onRangeChanged(double startTime, double endTime)
+{
+    const auto& timeline = Timeline::instance();
+    const int   frameCount = static_cast<int>(std::round((endTime - startTime) / timeline.frameStep()));
+
+    m_updatingControls = true;
+    m_slider->setRange(0, frameCount);
+    m_timeSpinBox->setRange(startTime, endTime);
+    m_updatingControls = false;
+
+    m_rangeLabel->setText(
+        timeline.hasTimeRange()
+            ? QString("%1 - %2 @ %3 fps").arg(startTime).arg(endTime).arg(timeline.framesPerSecond())
+            : QString("No animation"));
+
+    // stages without a time range are shown at the default time
+    setEnabled(timeline.hasTimeRange());
+}
+
+void TimelineWidget::onTimeChanged(double time)
+{
+    const auto& timeline = Timeline::instance();
+
+    m_updatingControls = true;
+    m_slider->setValue(static_cast<int>(std::round((time - timeline.startTime()) / timeline.frameStep())));
+    m_timeSpinBox->setValue(time);
+    m_updatingControls = false;
+
+    if (timeline.isPlaying())
+    {
+        m_droppedFramesLabel->setText(QString("Dropped: %1").arg(timeline.droppedFrames()));
+    }
+}
+
+void TimelineWidget::onPlaybackChanged(bool playing)
+{
+    m_playButton->setText(playing ? "Pause" : "Play");
+}
+
+} // namespace TINKERUSD_NS
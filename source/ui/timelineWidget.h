@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QWidget>
+
+class QCheckBox;
+class QDoubleSpinBox;
+class QLabel;
+class QSlider;
+class QToolButton;
+
+namespace TINKERUSD_NS
+{
+
+// transport controls and time slider of the Timeline.
+class TimelineWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    TimelineWidget(QWidget* parent = nullptr);
+    virtual ~TimelineWidget() = default;
+
+private slots:
+    void onRangeChanged(double startTime, double endTime);
+    void onTimeChanged(double time);
+    void onPlaybackChanged(bool playing);
+
+private:
+    void onCreateUI();
+    void stepFrames(int frames);
+
+private:
+    QToolButton*    m_firstButton;
+    QToolButton*    m_previousButton;
+    QToolButton*    m_playButton;
+    QToolButton*    m_nextButton;
+    QToolButton*    m_lastButton;
+    QSlider*        m_slider;
+    QDoubleSpinBox* m_timeSpinBox;
+    QCheckBox*      m_loopCheck;
+    QLabel*         m_rangeLabel;
+    QLabel*         m_droppedFramesLabel;
+    bool            m_updatingControls { false };
+};
+
+} // namespace TINKERUSD_NS
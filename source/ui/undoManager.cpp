@@ -10,29 +10,55 @@ UndoManager& UndoManager::instance()
     return instance;
 }
 
+UndoManager::UndoManager()
+{
+    m_undoGroup.addStack(&m_defaultStack);
+    m_undoGroup.setActiveStack(&m_defaultStack);
+}
+
 QUndoStack* UndoManager::undoStack()
 {
-    return &m_undoStack;
+    if (!m_undoGroup.activeStack())
+    {
+        // the active stack went away with its owner
+        m_undoGroup.setActiveStack(&m_defaultStack);
+    }
+    return m_undoGroup.activeStack();
+}
+
+void UndoManager::setActiveStack(QUndoStack* stack)
+{
+    if (!stack)
+    {
+        stack = &m_defaultStack;
+    }
+    if (stack->group() != &m_undoGroup)
+    {
+        m_undoGroup.addStack(stack);
+    }
+    m_undoGroup.setActiveStack(stack);
 }
 
 QAction* UndoManager::createUndoAction(QObject* parent, const QString& prefix)
 {
-    return m_undoStack.createUndoAction(parent, prefix);
+    return m_undoGroup.createUndoAction(parent, prefix);
 }
 
 QAction* UndoManager::createRedoAction(QObject* parent, const QString& prefix)
 {
-    return m_undoStack.createRedoAction(parent, prefix);
+    return m_undoGroup.createRedoAction(parent, prefix);
 }
 
 void UndoManager::displayUndoStackInfo()
 {
+    const QUndoStack* undoStack = this->undoStack();
+
     qDebug() << "---- Undo Stack ----";
-    for (int i = 0; i < m_undoStack.count(); ++i)
+    for (int i = 0; i < undoStack->count(); ++i)
     {
-        const QUndoCommand* cmd = m_undoStack.command(i);
+        const QUndoCommand* cmd = undoStack->command(i);
         QString label = cmd ? cmd->text() : "null";
-        QString marker = (i == m_undoStack.index()) ? " <- current" : "";
+        QString marker = (i == undoStack->index()) ? " <- current" : "";
         qDebug() << QString("#%1: %2%3").arg(i).arg(label, marker);
     }
     qDebug() << "--------------------";
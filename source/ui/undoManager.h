@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QUndoGroup>
 #include <QUndoStack>
 #include <QUndoCommand>
 #include <QAction>
@@ -8,13 +9,18 @@ namespace TINKERUSD_NS
 {
 
 // Singleton class to manage QUndoStack.
+// Every stage keeps its own history, the undo and redo actions follow the active stack.
 class UndoManager
 {
 public:
     static UndoManager& instance();
 
+    // the active stack, commands are pushed to it.
     QUndoStack* undoStack();
 
+    // makes a stack owned by the caller the active one, nullptr goes back to the default stack.
+    void setActiveStack(QUndoStack* stack);
+
     QAction* createUndoAction(QObject* parent, const QString& prefix = "Undo");
     QAction* createRedoAction(QObject* parent, const QString& prefix = "Redo");
     void displayUndoStackInfo();
@@ -22,8 +28,9 @@ public:
     // TODO: implement command composition
 
 private:
-    UndoManager() = default;
-    QUndoStack m_undoStack;
+    UndoManager();
+    QUndoGroup m_undoGroup;
+    QUndoStack m_defaultStack; // active until a stack is set
 };
 
 class UndoCommand : public QUndoCommand
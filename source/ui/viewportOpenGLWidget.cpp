@@ -1,15 +1,26 @@
 #include "viewportOpenGLWidget.h"
 
+#include "core/boundsCache.h"
 #include "core/globalSelection.h"
+#include "core/timeline.h"
 #include "core/usdDocument.h"
 
+#include <QApplication>
 #include <QMouseEvent>
+#include <QScreen>
 #include <QSurfaceFormat>
+#include <QTimer>
 #include <QWheelEvent>
+#include <pxr/imaging/hd/aov.h>
+#include <pxr/imaging/hd/tokens.h>
+#include <pxr/imaging/hdx/pickTask.h>
 #include <pxr/usd/usdGeom/metrics.h>
 
 #define SAMPLE_AMOUNT 8
 
+// time without camera input after which an interaction is over and full quality comes back
+#define INTERACTION_SETTLE_MS 150
+
 namespace TINKERUSD_NS
 {
 
@@ -20,13 +31,29 @@ ViewportOpenGLWidget::ViewportOpenGLWidget(UsdDocument* document, QWidget* paren
     , m_height(1)
     , m_width(1)
     , m_shadingMode(ShadingMode::SHADEDSMOOTH)
+    , m_interactionTimer(new QTimer(this))
+    , m_statsRecorder(new RenderStatsRecorder(this))
 {
     QSurfaceFormat format;
     format.setSamples(SAMPLE_AMOUNT);
     setFormat(format);
 
-    TfWeakPtr<ViewportOpenGLWidget> me(this);
-    m_ObjectsChangedKey = TfNotice::Register(me, &ViewportOpenGLWidget::onUsdObjectChanged);
+    // hover highlighting follows the cursor without a button held
+    setMouseTracking(true);
+
+    m_interactionTimer->setSingleShot(true);
+    m_interactionTimer->setInterval(INTERACTION_SETTLE_MS);
+    connect(m_interactionTimer, &QTimer::timeout, this, &ViewportOpenGLWidget::endInteraction);
+
+    m_statsRecorder->setStatsSource([this]() {
+        if (!m_renderEngineGL)
+        {
+            return VtDictionary();
+        }
+        return m_renderEngineGL->getUsdImagingGLEngine()->GetRenderStats();
+    });
+
+    registerStageNotices();
 
     connect(m_usdDocument, &UsdDocument::stageOpened, this, &ViewportOpenGLWidget::onStageOpened);
 
@@ -35,6 +62,8 @@ ViewportOpenGLWidget::ViewportOpenGLWidget(UsdDocument* document, QWidget* paren
         &GlobalSelection::selectionChanged,
         this,
         &ViewportOpenGLWidget::onSelectionChanged);
+
+    connect(&Timeline::instance(), &Timeline::timeChanged, this, &ViewportOpenGLWidget::onTimeChanged);
 }
 
 ViewportOpenGLWidget::~ViewportOpenGLWidget()
@@ -43,38 +72,250 @@ ViewportOpenGLWidget::~ViewportOpenGLWidget()
     {
         TfNotice::Revoke(m_ObjectsChangedKey);
     }
+
+    // GL resources are released in the context they were created in
+    makeCurrent();
+    m_renderEngineGL.reset();
+    m_idBuffer.reset();
+    m_grid.reset();
+    m_interactiveDrawTarget.reset();
+    m_drawTarget.reset();
+    m_profiler.destroyGL();
+    m_hud.destroyGL();
+    doneCurrent();
+}
+
+void ViewportOpenGLWidget::registerStageNotices()
+{
+    if (m_ObjectsChangedKey.IsValid())
+    {
+        TfNotice::Revoke(m_ObjectsChangedKey);
+    }
+
+    if (!m_stage)
+    {
+        return;
+    }
+
+    // only listen to the displayed stage: stages being composed on worker threads
+    // send notices too, and those must not reach the viewport.
+    TfWeakPtr<ViewportOpenGLWidget> me(this);
+    m_ObjectsChangedKey
+        = TfNotice::Register(me, &ViewportOpenGLWidget::onUsdObjectChanged, UsdStageWeakPtr(m_stage));
 }
 
 void ViewportOpenGLWidget::onSelectionChanged()
 {
-    m_renderEngineGL->addSelectionHighlighting();
+    // applied once per frame, see syncSelection
+    m_selectionDirty = true;
+    m_selectionBboxDirty = true;
 
-    m_renderEngineGL->addBboxRenderParams(globalSelectionBbox(m_stage));
+    restartConvergence();
+    requestRepaint();
+}
 
-    update();
+void ViewportOpenGLWidget::onTimeChanged()
+{
+    // animated prims move the selection and hover bounds
+    if (!GlobalSelection::instance().isEmpty() || !m_hoveredPath.IsEmpty())
+    {
+        m_selectionBboxDirty = true;
+    }
+
+    restartConvergence();
+    requestRepaint();
+}
+
+void ViewportOpenGLWidget::syncSelection()
+{
+    if (m_selectionDirty)
+    {
+        m_selectionDirty = false;
+        m_renderEngineGL->addSelectionHighlighting();
+    }
+
+    if (m_selectionBboxDirty)
+    {
+        m_selectionBboxDirty = false;
+
+        std::vector<GfBBox3d> bBoxes { globalSelectionBbox(m_stage) };
+        const UsdPrim         hoveredPrim = m_stage->GetPrimAtPath(m_hoveredPath);
+        auto                  boundsCache = BoundsCache::forStage(m_stage);
+        if (hoveredPrim && boundsCache && !GlobalSelection::instance().isSelected(m_hoveredPath))
+        {
+            bBoxes.push_back(boundsCache->worldBound(hoveredPrim));
+        }
+        m_renderEngineGL->addBboxRenderParams(bBoxes);
+    }
 }
 
 void ViewportOpenGLWidget::onUsdObjectChanged(const UsdNotice::ObjectsChanged& notice)
 {
-    const auto& resyncedPaths = notice.GetResyncedPaths();
-    const auto& changedPaths = notice.GetChangedInfoOnlyPaths();
+    if (notice.GetResyncedPaths().empty() && notice.GetChangedInfoOnlyPaths().empty())
+    {
+        return;
+    }
+
+    // hydra tracks the changes itself, only the selection bounds drawn on top depend on us
+    if (!m_selectionBboxDirty && affectsSelectionBounds(notice))
+    {
+        m_selectionBboxDirty = true;
+    }
+
+    restartConvergence();
+    requestRepaint();
+}
+
+bool ViewportOpenGLWidget::affectsSelectionBounds(const UsdNotice::ObjectsChanged& notice) const
+{
+    const SdfPathSet& selection = GlobalSelection::instance().paths();
+    if (selection.empty() && m_hoveredPath.IsEmpty())
+    {
+        return false;
+    }
+
+    // the bounds of a selected or hovered prim move with its ancestors and its descendants
+    const auto isRelated = [this, &selection](const SdfPath& primPath) {
+        for (SdfPath path = primPath; !path.IsEmpty(); path = path.GetParentPath())
+        {
+            if (selection.count(path) || path == m_hoveredPath)
+            {
+                return true;
+            }
+        }
+
+        const auto it = selection.lower_bound(primPath);
+        return (it != selection.end() && it->HasPrefix(primPath)) || m_hoveredPath.HasPrefix(primPath);
+    };
 
-    if (!resyncedPaths.empty() || !changedPaths.empty())
+    for (const auto& path : notice.GetResyncedPaths())
     {
+        if (isRelated(path.GetPrimPath()))
+        {
+            return true;
+        }
+    }
 
-        m_renderEngineGL->addBboxRenderParams(globalSelectionBbox(m_stage));
+    for (const auto& path : notice.GetChangedInfoOnlyPaths())
+    {
+        if (path.IsPropertyPath() && BoundsCache::isAffectedBy(path.GetNameToken()) && isRelated(path.GetPrimPath()))
+        {
+            return true;
+        }
+    }
 
+    return false;
+}
+
+void ViewportOpenGLWidget::requestRepaint()
+{
+    if (m_repaintPending)
+    {
+        return;
+    }
+
+    // at most one repaint per display refresh, however many notices a script sends
+    const qreal  refreshRate = screen() ? screen()->refreshRate() : 60.0;
+    const qint64 frameInterval = static_cast<qint64>(1000.0 / std::max<qreal>(refreshRate, 1.0));
+    const qint64 elapsed = m_frameTimer.isValid() ? m_frameTimer.elapsed() : frameInterval;
+    const int    delay = static_cast<int>(std::max<qint64>(0, frameInterval - elapsed));
+
+    m_repaintPending = true;
+    QTimer::singleShot(delay, this, [this]() {
+        m_repaintPending = false;
+        update();
+    });
+}
+
+void ViewportOpenGLWidget::restartConvergence()
+{
+    m_convergence.restart = true;
+    m_idBufferDirty = true;
+}
+
+void ViewportOpenGLWidget::beginInteraction()
+{
+    if (!m_quality.isEnabled())
+    {
+        return;
+    }
+    m_quality.beginInteraction();
+    m_interactionTimer->start();
+}
+
+void ViewportOpenGLWidget::endInteraction()
+{
+    m_interactionTimer->stop();
+    if (!m_quality.isInteracting())
+    {
+        return;
+    }
+
+    const bool degraded = m_quality.levelIndex() != 0;
+    m_quality.endInteraction();
+
+    // refine the last interactive frame back to full quality, and read its ids for picking
+    if (degraded || m_idBufferDirty)
+    {
+        restartConvergence();
         update();
     }
 }
 
+void ViewportOpenGLWidget::setAdaptiveQuality(bool enabled)
+{
+    endInteraction();
+    m_quality.setEnabled(enabled);
+}
+
+bool ViewportOpenGLWidget::adaptiveQuality() const { return m_quality.isEnabled(); }
+
+void ViewportOpenGLWidget::setFrameBudgetMs(double budgetMs) { m_quality.setFrameBudgetMs(budgetMs); }
+
+double ViewportOpenGLWidget::frameBudgetMs() const { return m_quality.frameBudgetMs(); }
+
+void ViewportOpenGLWidget::updateConvergence()
+{
+    if (m_convergence.restart)
+    {
+        m_convergence.restart = false;
+        m_convergence.timer.start();
+        m_convergence.frames = 0;
+        m_convergence.convergedMs = -1;
+    }
+
+    ++m_convergence.frames;
+
+    if (m_renderEngineGL->isConverged())
+    {
+        if (m_convergence.convergedMs < 0)
+        {
+            m_convergence.convergedMs = m_convergence.timer.elapsed();
+        }
+        return;
+    }
+
+    // progressive renderers such as path tracers add samples with every frame, keep
+    // rendering until the image has converged
+    requestRepaint();
+}
+
 void ViewportOpenGLWidget::initializeGL()
 {
     initializeOpenGLFunctions();
 
+    m_profiler.init(this);
+
     initialize();
 
-    m_drawTarget = std::make_unique<UsdDrawTargetFBO>();
+    // the grid and the HUD do not depend on the stage, they are kept across stage switches
+    m_grid = std::make_unique<Grid>();
+    m_grid->initialize();
+    m_hud.init(this);
+
+    m_drawTarget = std::make_unique<UsdDrawTargetFBO>(m_colorFormat);
+    m_interactiveDrawTarget = std::make_unique<UsdDrawTargetFBO>(m_colorFormat);
+    m_idBuffer = std::make_unique<IdBuffer>();
 
     emit rendererAvailable();
 }
@@ -87,21 +328,57 @@ void ViewportOpenGLWidget::initialize()
     }
 
     m_usdCamera = std::make_unique<UsdCamera>(m_stage);
+
+    // the engine of the previous stage releases its resources before the new one allocates
+    m_renderEngineGL.reset();
     m_renderEngineGL = std::make_unique<UsdRenderEngineGL>();
     m_renderEngineGL->initialize(m_stage);
+    applyRendererChoice();
+}
 
-    m_grid = std::make_unique<Grid>();
-    m_grid->initialize();
+void ViewportOpenGLWidget::applyRendererChoice()
+{
+    if (!m_rendererId.IsEmpty() && !m_renderEngineGL->setRendererPlugin(m_rendererId))
+    {
+        m_rendererId = TfToken();
+        m_rendererSettings.clear();
+        return;
+    }
 
-    m_hud.init(this);
+    for (const auto& setting : m_rendererSettings)
+    {
+        m_renderEngineGL->setRendererSetting(TfToken(setting.first), setting.second);
+    }
 }
 
 void ViewportOpenGLWidget::onStageOpened(const QString& filePath)
 {
     m_stage = m_usdDocument->getCurrentStage();
 
-    initialize();
+    registerStageNotices();
+
+    // the render engine is replaced on the viewport context. Before the first initializeGL
+    // there is no context yet, initializeGL builds the engine for the current stage then.
+    if (isValid())
+    {
+        makeCurrent();
+        initialize();
 
+        // the ids of the previous stage mean nothing to the new render engine
+        if (m_idBuffer)
+        {
+            m_idBuffer->invalidate();
+        }
+        doneCurrent();
+    }
+    m_decodedIds.clear();
+    setHoveredPath(SdfPath());
+
+    // the new render engine starts without any selection
+    m_selectionDirty = true;
+    m_selectionBboxDirty = true;
+
+    restartConvergence();
     update();
 }
 
@@ -109,6 +386,7 @@ void ViewportOpenGLWidget::frameSelected()
 {
     m_usdCamera->frameSelected(globalSelectionBbox(m_stage));
 
+    restartConvergence();
     update();
 }
 
@@ -116,6 +394,7 @@ void ViewportOpenGLWidget::reset()
 {
     m_usdCamera->reset();
 
+    restartConvergence();
     update();
 }
 
@@ -125,6 +404,7 @@ void ViewportOpenGLWidget::resizeGL(int w, int h)
     m_height = h * devicePixelRatio();
 
     m_drawTarget->resize(m_width, m_height);
+    restartConvergence();
 
     glViewport(0, 0, w, h);
 }
@@ -139,6 +419,7 @@ void ViewportOpenGLWidget::setShadingMode(ViewportOpenGLWidget::ShadingMode mode
 {
     m_shadingMode = mode;
 
+    restartConvergence();
     update();
 }
 
@@ -153,12 +434,97 @@ void ViewportOpenGLWidget::setRendererAov(const std::string& name)
 {
     m_renderEngineGL->setRendererAov(name);
 
+    restartConvergence();
+    update();
+}
+
+PXR_NS::TfTokenVector ViewportOpenGLWidget::rendererPlugins() const
+{
+    return UsdRenderEngineGL::rendererPlugins();
+}
+
+PXR_NS::TfToken ViewportOpenGLWidget::rendererPlugin() const
+{
+    return m_renderEngineGL ? m_renderEngineGL->rendererId() : m_rendererId;
+}
+
+bool ViewportOpenGLWidget::setRendererPlugin(const PXR_NS::TfToken& rendererId)
+{
+    if (rendererId == rendererPlugin())
+    {
+        return true;
+    }
+
+    if (m_renderEngineGL)
+    {
+        // renderers allocate their GPU resources on the viewport context
+        makeCurrent();
+        const bool switched = m_renderEngineGL->setRendererPlugin(rendererId);
+        doneCurrent();
+        if (!switched)
+        {
+            return false;
+        }
+    }
+
+    m_rendererId = rendererId;
+    m_rendererSettings.clear();
+
+    restartConvergence();
+    update();
+
+    emit rendererAvailable();
+    return true;
+}
+
+PXR_NS::UsdImagingGLRendererSettingsList ViewportOpenGLWidget::rendererSettings() const
+{
+    return m_renderEngineGL ? m_renderEngineGL->rendererSettings() : UsdImagingGLRendererSettingsList();
+}
+
+PXR_NS::VtValue ViewportOpenGLWidget::rendererSetting(const PXR_NS::TfToken& key) const
+{
+    return m_renderEngineGL ? m_renderEngineGL->rendererSetting(key) : VtValue();
+}
+
+void ViewportOpenGLWidget::setRendererSetting(const PXR_NS::TfToken& key, const PXR_NS::VtValue& value)
+{
+    m_rendererSettings[key.GetString()] = value;
+    if (m_renderEngineGL)
+    {
+        m_renderEngineGL->setRendererSetting(key, value);
+    }
+
+    restartConvergence();
     update();
 }
 
 void ViewportOpenGLWidget::paintGL()
 {
-    m_drawTarget->bind();
+    m_frameTimer.restart();
+    m_profiler.beginFrame();
+
+    // the GPU times of frames rendered at a previous level arrive a few frames late
+    if (m_quality.levelIndex() != m_renderedQualityLevel)
+    {
+        m_renderedQualityLevel = m_quality.levelIndex();
+        m_qualityLevelFrame = m_profiler.frame();
+    }
+
+    // while the camera moves, render at the resolution the quality controller settled on
+    const InteractiveQuality::Level& quality = m_quality.level();
+    const bool reduced = quality.resolutionScale < 1.0f;
+    const int  renderWidth = std::max(1, static_cast<int>(m_width * quality.resolutionScale));
+    const int  renderHeight = std::max(1, static_cast<int>(m_height * quality.resolutionScale));
+
+    UsdDrawTargetFBO* drawTarget = reduced ? m_interactiveDrawTarget.get() : m_drawTarget.get();
+    if (reduced)
+    {
+        drawTarget->resize(renderWidth, renderHeight);
+    }
+
+    drawTarget->bind();
+    glViewport(0, 0, renderWidth, renderHeight);
 
     glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -191,27 +557,65 @@ void ViewportOpenGLWidget::paintGL()
     m_renderEngineGL->params().forceRefresh = false;
     m_renderEngineGL->params().enableLighting = true; // false to turn off camera light
     m_renderEngineGL->params().enableSampleAlphaToCoverage = false;
-    m_renderEngineGL->params().enableSceneMaterials = true;
-    m_renderEngineGL->params().enableSceneLights = true;
+    m_renderEngineGL->params().enableSceneMaterials = quality.sceneMaterials;
+    m_renderEngineGL->params().enableSceneLights = quality.sceneLights;
     m_renderEngineGL->params().flipFrontFacing = true;
     m_renderEngineGL->params().gammaCorrectColors = false;
     m_renderEngineGL->params().highlight = true;
     m_renderEngineGL->params().showGuides = true;
     m_renderEngineGL->params().showProxy = true;
-    m_renderEngineGL->params().showRender = true;
+    m_renderEngineGL->params().showRender = !quality.proxyOnly;
     m_renderEngineGL->params().complexity = 1.0;
+    m_renderEngineGL->params().frame = Timeline::instance().timeCode();
 
-    m_renderEngineGL->render(m_stage, m_usdCamera.get(), m_width, m_height);
+    syncSelection();
 
-    TfToken stageUpAxis = PXR_NS::UsdGeomGetStageUpAxis(m_stage);
-    m_grid->draw(m_usdCamera.get(), stageUpAxis);
+    {
+        FrameProfiler::Scope scope(m_profiler, FrameProfiler::Pass::HYDRA_RENDER);
+        m_renderEngineGL->render(m_stage, m_usdCamera.get(), renderWidth, renderHeight);
+    }
+    updateConvergence();
 
-    m_drawTarget->unbind();
-    m_drawTarget->draw();
+    // ids for picking are read once the image changed and converged, not on every frame of a
+    // camera move or of a progressive render
+    if (m_idBufferDirty && m_renderEngineGL->isConverged() && !m_quality.isInteracting()
+        && m_usdCamera->getDragMode() == UsdCamera::DragMode::NONE)
+    {
+        m_idBufferDirty = false;
+        requestIdReadback();
+
+        // the id pass of renderers without id AOVs renders through framebuffers of its own
+        drawTarget->bind();
+        glViewport(0, 0, renderWidth, renderHeight);
+    }
+
+    {
+        FrameProfiler::Scope scope(m_profiler, FrameProfiler::Pass::GRID);
+        TfToken stageUpAxis = PXR_NS::UsdGeomGetStageUpAxis(m_stage);
+        m_grid->draw(m_usdCamera.get(), stageUpAxis);
+    }
+
+    {
+        FrameProfiler::Scope scope(m_profiler, FrameProfiler::Pass::FBO_BLIT);
+        drawTarget->unbind();
+        glViewport(0, 0, m_width, m_height);
+        drawTarget->draw();
+    }
+
+    if (m_marqueeActive)
+    {
+        drawMarquee();
+    }
 
     if (m_showRendererStats) {
+        FrameProfiler::Scope scope(m_profiler, FrameProfiler::Pass::HUD);
         hudDrawRendereStats();
     }
+
+    m_profiler.endFrame();
+
+    m_quality.addFrameTime(m_profiler.latestFrameMs(), m_profiler.hasGpuTimeSince(m_qualityLevelFrame));
+    m_statsRecorder->addFrameTime(m_profiler.latestFrameMs());
 }
 
 void ViewportOpenGLWidget::setShowRendererStats(bool val)
@@ -221,11 +625,50 @@ void ViewportOpenGLWidget::setShowRendererStats(bool val)
     update();
 }
 
+void ViewportOpenGLWidget::setColorFormat(UsdDrawTargetFBO::ColorFormat colorFormat)
+{
+    if (colorFormat == m_colorFormat)
+    {
+        return;
+    }
+    m_colorFormat = colorFormat;
+
+    if (m_drawTarget)
+    {
+        makeCurrent();
+        m_drawTarget->setColorFormat(colorFormat);
+        m_interactiveDrawTarget->setColorFormat(colorFormat);
+        doneCurrent();
+    }
+
+    restartConvergence();
+    update();
+}
+
+UsdDrawTargetFBO::ColorFormat ViewportOpenGLWidget::colorFormat() const { return m_colorFormat; }
+
+bool ViewportOpenGLWidget::exportFrameProfile(const QString& filePath) const
+{
+    return m_profiler.exportToFile(filePath);
+}
+
+bool ViewportOpenGLWidget::exportRenderStats(const QString& filePath) const
+{
+    return m_statsRecorder->exportToFile(filePath);
+}
+
+bool ViewportOpenGLWidget::setRenderStatsStreamFile(const QString& filePath)
+{
+    return m_statsRecorder->setStreamFile(filePath);
+}
+
 void ViewportOpenGLWidget::wheelEvent(QWheelEvent* event)
 {
     double angleDelta = static_cast<double>(event->angleDelta().y()) / 1000.0;
     m_usdCamera->adjustDistance(1.0 - std::max(-0.5, std::min(0.5, angleDelta)));
 
+    beginInteraction();
+    restartConvergence();
     update();
 }
 
@@ -247,46 +690,14 @@ void ViewportOpenGLWidget::mousePressEvent(QMouseEvent* event)
         {
             m_usdCamera->setDragMode(UsdCamera::DragMode::PAN);
         }
+        setHoveredPath(SdfPath());
     }
-    else
+    else if (event->button() == Qt::LeftButton)
     {
-
-        // NOTE: Explicitly set Depth Mask to True
-        // OtherWise TestIntersection fails to pick
-        glDepthMask(GL_TRUE);
-
-        // normalize position and pick size by the viewport size
-        auto pos = pxr::GfVec2d(m_lastMousePosition.x() / m_width, m_lastMousePosition.y() / m_height);
-
-        pos[0] = (pos[0] * 2.0 - 1.0);
-        pos[1] = -1.0 * (pos[1] * 2.0 - 1.0);
-
-        auto size = pxr::GfVec2d(1.0f / m_width, 1.0f / m_height);
-        auto cameraFrustum = m_usdCamera->getCamera().GetFrustum();
-        auto pickFrustum = cameraFrustum.ComputeNarrowedFrustum(pos, size);
-
-        pxr::GfVec3d outHitNormal;
-        pxr::GfVec3d outHitPoint;
-        pxr::SdfPath outHitInstancerPath;
-        pxr::SdfPath outHitPrimPath;
-        auto hit = m_renderEngineGL->getUsdImagingGLEngine()->TestIntersection(
-            pickFrustum.ComputeViewMatrix(),
-            pickFrustum.ComputeProjectionMatrix(),
-            m_stage->GetPseudoRoot(),
-            m_renderEngineGL->params(),
-            &outHitPoint,
-            &outHitNormal,
-            &outHitPrimPath,
-            &outHitInstancerPath);
-        if (hit)
-        {
-            auto hitPrim = m_stage->GetPrimAtPath(outHitPrimPath);
-            GlobalSelection::instance().setPrim(hitPrim);
-        }
-        else
-        {
-            GlobalSelection::instance().clearSelection();
-        }
+        // a click picks on release, a drag draws a selection marquee
+        m_selecting = true;
+        m_pressPosition = m_lastMousePosition;
+        m_marqueeEnd = m_lastMousePosition;
     }
 }
 
@@ -299,6 +710,32 @@ void ViewportOpenGLWidget::mouseMoveEvent(QMouseEvent* event)
     {
         return;
     }
+    m_lastMousePosition = currentMousePosition;
+
+    if (m_selecting)
+    {
+        const int dragDistance = static_cast<int>(QApplication::startDragDistance() * devicePixelRatio());
+        if (!m_marqueeActive && (currentMousePosition - m_pressPosition).manhattanLength() >= dragDistance)
+        {
+            m_marqueeActive = true;
+        }
+        if (m_marqueeActive)
+        {
+            m_marqueeEnd = currentMousePosition;
+            update();
+        }
+        return;
+    }
+
+    if (m_usdCamera->getDragMode() == UsdCamera::DragMode::NONE)
+    {
+        SdfPath hoveredPath;
+        if (pickFromIdBuffer(currentMousePosition, &hoveredPath))
+        {
+            setHoveredPath(hoveredPath);
+        }
+        return;
+    }
 
     if (m_usdCamera->getDragMode() == UsdCamera::DragMode::DOLLY)
     {
@@ -315,14 +752,256 @@ void ViewportOpenGLWidget::mouseMoveEvent(QMouseEvent* event)
         m_usdCamera->zoom(zoomDelta);
     }
 
-    m_lastMousePosition = event->pos() * devicePixelRatio();
-
+    beginInteraction();
+    restartConvergence();
     update();
 }
 
 void ViewportOpenGLWidget::mouseReleaseEvent(QMouseEvent* event)
 {
     m_usdCamera->setDragMode(UsdCamera::DragMode::NONE);
+
+    if (m_selecting && event->button() == Qt::LeftButton)
+    {
+        m_selecting = false;
+
+        SdfPathVector paths;
+        if (m_marqueeActive)
+        {
+            m_marqueeActive = false;
+            const QRect rect = QRect(m_pressPosition, m_marqueeEnd).normalized();
+            if (!pickFromIdBuffer(rect, &paths))
+            {
+                paths = pickWithIntersection(rect, HdxPickTokens->resolveUnique);
+            }
+            update();
+        }
+        else
+        {
+            SdfPath path;
+            if (pickFromIdBuffer(m_pressPosition, &path))
+            {
+                if (!path.IsEmpty())
+                {
+                    paths.push_back(path);
+                }
+            }
+            else
+            {
+                paths = pickWithIntersection(
+                    QRect(m_pressPosition, QSize(1, 1)), HdxPickTokens->resolveNearestToCenter);
+            }
+        }
+        applyPick(paths, event->modifiers());
+    }
+
+    endInteraction();
+}
+
+void ViewportOpenGLWidget::leaveEvent(QEvent* event)
+{
+    setHoveredPath(SdfPath());
+
+    QOpenGLWidget::leaveEvent(event);
+}
+
+void ViewportOpenGLWidget::applyPick(const SdfPathVector& paths, Qt::KeyboardModifiers modifiers)
+{
+    // shift extends the selection and control toggles the picked prims, like in the outliner
+    const bool extend = modifiers & Qt::ShiftModifier;
+    const bool toggle = modifiers & Qt::ControlModifier;
+    if (!paths.empty() && toggle)
+    {
+        GlobalSelection::instance().toggle(paths);
+    }
+    else if (!paths.empty() && extend)
+    {
+        GlobalSelection::instance().add(paths);
+    }
+    else if (!paths.empty())
+    {
+        GlobalSelection::instance().replace(paths);
+    }
+    else if (!extend && !toggle)
+    {
+        GlobalSelection::instance().clearSelection();
+    }
+}
+
+void ViewportOpenGLWidget::setHoveredPath(const SdfPath& path)
+{
+    if (path == m_hoveredPath)
+    {
+        return;
+    }
+    m_hoveredPath = path;
+    m_selectionBboxDirty = true;
+
+    // the bounds are drawn over the image, a converged image stays converged
+    requestRepaint();
+
+    emit primHovered(path);
+}
+
+void ViewportOpenGLWidget::requestIdReadback()
+{
+    if (!m_renderEngineGL->renderIds(m_stage))
+    {
+        return;
+    }
+
+    HdRenderBuffer* primIds = m_renderEngineGL->aovRenderBuffer(HdAovTokens->primId);
+    HdRenderBuffer* instanceIds = m_renderEngineGL->aovRenderBuffer(HdAovTokens->instanceId);
+    if (!m_idBuffer->requestReadback(primIds, instanceIds))
+    {
+        return;
+    }
+
+    // host memory AOVs are copied at once, GL textures arrive with collectIdBuffer
+    if (!m_idBuffer->isPending())
+    {
+        m_decodedIds.clear();
+    }
+}
+
+bool ViewportOpenGLWidget::collectIdBuffer()
+{
+    if (m_idBuffer && m_idBuffer->isPending())
+    {
+        makeCurrent();
+        const bool updated = m_idBuffer->update();
+        doneCurrent();
+        if (updated)
+        {
+            m_decodedIds.clear();
+        }
+    }
+
+    // ids of an image that changed since, or still on their way, would pick what is no longer there
+    return m_idBuffer && m_idBuffer->isValid() && !m_idBuffer->isPending() && !m_idBufferDirty;
+}
+
+SdfPath ViewportOpenGLWidget::decodeIds(const IdBuffer::Ids& ids)
+{
+    const auto key = std::make_pair(ids.primId, ids.instanceId);
+    auto       it = m_decodedIds.find(key);
+    if (it == m_decodedIds.end())
+    {
+        it = m_decodedIds.emplace(key, m_renderEngineGL->decodeIds(ids.primId, ids.instanceId)).first;
+    }
+    return it->second;
+}
+
+bool ViewportOpenGLWidget::pickFromIdBuffer(const QPoint& position, SdfPath* path)
+{
+    if (!collectIdBuffer())
+    {
+        return false;
+    }
+
+    // the ids may have been rendered at another size than the widget has now
+    const int x = static_cast<int>(position.x() * m_idBuffer->width() / m_width);
+    const int y = static_cast<int>(position.y() * m_idBuffer->height() / m_height);
+
+    const IdBuffer::Ids ids = m_idBuffer->idsAt(x, y);
+    *path = ids.primId < 0 ? SdfPath() : decodeIds(ids);
+    return true;
+}
+
+bool ViewportOpenGLWidget::pickFromIdBuffer(const QRect& rect, SdfPathVector* paths)
+{
+    if (!collectIdBuffer())
+    {
+        return false;
+    }
+
+    const double scaleX = m_idBuffer->width() / m_width;
+    const double scaleY = m_idBuffer->height() / m_height;
+    const QRect  bufferRect(
+        QPoint(static_cast<int>(rect.left() * scaleX), static_cast<int>(rect.top() * scaleY)),
+        QPoint(static_cast<int>(rect.right() * scaleX), static_cast<int>(rect.bottom() * scaleY)));
+
+    SdfPathSet picked;
+    for (const IdBuffer::Ids& ids : m_idBuffer->idsIn(bufferRect))
+    {
+        const SdfPath path = decodeIds(ids);
+        if (!path.IsEmpty() && picked.insert(path).second)
+        {
+            paths->push_back(path);
+        }
+    }
+    return true;
+}
+
+SdfPathVector ViewportOpenGLWidget::pickWithIntersection(const QRect& rect, const TfToken& resolveMode)
+{
+    makeCurrent();
+
+    // NOTE: Explicitly set Depth Mask to True
+    // OtherWise TestIntersection fails to pick
+    glDepthMask(GL_TRUE);
+
+    // normalize position and pick size by the viewport size
+    const QPointF center = QRectF(rect).center();
+    auto          pos = pxr::GfVec2d(center.x() / m_width, center.y() / m_height);
+
+    pos[0] = (pos[0] * 2.0 - 1.0);
+    pos[1] = -1.0 * (pos[1] * 2.0 - 1.0);
+
+    auto size = pxr::GfVec2d(rect.width() / m_width, rect.height() / m_height);
+    auto cameraFrustum = m_usdCamera->getCamera().GetFrustum();
+    auto pickFrustum = cameraFrustum.ComputeNarrowedFrustum(pos, size);
+
+    UsdImagingGLEngine::PickParams               pickParams = { resolveMode };
+    UsdImagingGLEngine::IntersectionResultVector results;
+    m_renderEngineGL->getUsdImagingGLEngine()->TestIntersection(
+        pickParams,
+        pickFrustum.ComputeViewMatrix(),
+        pickFrustum.ComputeProjectionMatrix(),
+        m_stage->GetPseudoRoot(),
+        m_renderEngineGL->params(),
+        &results);
+
+    doneCurrent();
+
+    SdfPathVector paths;
+    SdfPathSet    picked;
+    for (const auto& result : results)
+    {
+        if (!result.hitPrimPath.IsEmpty() && picked.insert(result.hitPrimPath).second)
+        {
+            paths.push_back(result.hitPrimPath);
+        }
+    }
+    return paths;
+}
+
+void ViewportOpenGLWidget::drawMarquee()
+{
+    const QRect rect = QRect(m_pressPosition, m_marqueeEnd).normalized();
+
+    // GL rows go up from the bottom of the widget
+    const int left = rect.left();
+    const int bottom = static_cast<int>(m_height) - rect.bottom() - 1;
+    const int width = rect.width();
+    const int height = rect.height();
+
+    // the outline is four cleared strips, no geometry needed
+    const QRect edges[] = {
+        QRect(left, bottom, width, 1),
+        QRect(left, bottom + height - 1, width, 1),
+        QRect(left, bottom, 1, height),
+        QRect(left + width - 1, bottom, 1, height),
+    };
+
+    glEnable(GL_SCISSOR_TEST);
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    for (const QRect& edge : edges)
+    {
+        glScissor(edge.x(), edge.y(), edge.width(), edge.height());
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    glDisable(GL_SCISSOR_TEST);
 }
 
 double ViewportOpenGLWidget::nearClip() const
@@ -344,6 +1023,7 @@ void ViewportOpenGLWidget::setClipPlanes(double nearClip, double farClip)
     m_usdCamera->setClippingRange(nearClip, farClip);
     m_usdCamera->updateTransform();
 
+    restartConvergence();
     update();
 }
 
@@ -356,23 +1036,81 @@ void ViewportOpenGLWidget::hudDrawRendereStats()
     auto hgiApiName = m_renderEngineGL->getUsdImagingGLEngine()->GetHgi()->GetAPIName();
     lines << QStringLiteral("Hgi: %1").arg(QString::fromStdString(hgiApiName.GetString()));
 
+    const VtDictionary renderStatsDict = m_renderEngineGL->getUsdImagingGLEngine()->GetRenderStats();
+
+    // progress as the renderer reports it, the frames rendered since the last change otherwise
+    auto numericStat = [&renderStatsDict](const std::string& key, double* result) {
+        const auto it = renderStatsDict.find(key);
+        if (it == renderStatsDict.end() || it->second.IsHolding<bool>() || !it->second.CanCast<double>())
+        {
+            return false;
+        }
+        *result = VtValue::Cast<double>(it->second).UncheckedGet<double>();
+        return true;
+    };
+
+    double samples = 0.0;
+    double percentDone = 0.0;
+    const bool hasSamples = numericStat(HdPerfTokens->numCompletedSamples.GetString(), &samples);
+    const bool hasPercentDone = numericStat("percentDone", &percentDone);
+    if (hasSamples)
+    {
+        lines << QStringLiteral("Samples: %1").arg(qRound64(samples));
+    }
+    if (hasPercentDone)
+    {
+        lines << QStringLiteral("Progress: %1%").arg(percentDone, 0, 'f', 1);
+    }
+    if (!hasSamples && !hasPercentDone)
+    {
+        lines << QStringLiteral("Frames since last change: %1").arg(m_convergence.frames);
+    }
+
+    if (m_convergence.convergedMs >= 0)
+    {
+        lines << QStringLiteral("Converged in: %1 ms").arg(m_convergence.convergedMs);
+    }
+    else
+    {
+        const qint64 elapsed = m_convergence.timer.isValid() ? m_convergence.timer.elapsed() : 0;
+        lines << QStringLiteral("Converging: %1 ms").arg(elapsed);
+    }
+
+    lines << m_profiler.hudLines();
+
+    if (m_quality.isInteracting())
+    {
+        const InteractiveQuality::Level& quality = m_quality.level();
+        lines << QStringLiteral("Interactive quality: level %1, %2% resolution, %3 ms avg / %4 ms budget")
+                     .arg(m_quality.levelIndex())
+                     .arg(qRound(quality.resolutionScale * 100.0f))
+                     .arg(m_quality.averageFrameMs(), 0, 'f', 1)
+                     .arg(m_quality.frameBudgetMs(), 0, 'f', 0);
+    }
+
+    lines << m_statsRecorder->hudLines();
+
     lines << "==================== ";
     lines << "Render Statistics: ";
     lines << "==================== ";
 
-    auto renderStatsDict = m_renderEngineGL->getUsdImagingGLEngine()->GetRenderStats();
     for (const auto& kv : renderStatsDict) {
         const std::string& key = kv.first;
         const VtValue& value   = kv.second;
 
-        lines << QStringLiteral("%1 = %2")
-                     .arg(QString::fromStdString(key))
-                     .arg(QString::fromStdString(TfStringify(value)));
-    }
+        QString line = QStringLiteral("%1 = %2")
+                           .arg(QString::fromStdString(key))
+                           .arg(QString::fromStdString(TfStringify(value)));
 
-    QString hudText = lines.join("\n");
+        // numeric stats are recorded over the session
+        const QString trend = m_statsRecorder->statSparkline(key, 16);
+        if (!trend.isEmpty()) {
+            line += "  " + trend;
+        }
+        lines << line;
+    }
 
-    m_hud.updateText(hudText, float(devicePixelRatioF()), 14);
+    m_hud.updateLines(lines, float(devicePixelRatioF()), 14);
     m_hud.draw(width(), height(), float(devicePixelRatioF()));
 }
 
@@ -6,12 +6,20 @@
 #include "render/usdDrawTargetFBO.h"
 #include "render/usdRenderEngineGL.h"
 #include "render/hudOverLay.h"
+#include "render/frameProfiler.h"
+#include "render/interactiveQuality.h"
+#include "render/idBuffer.h"
+#include "render/renderStatsRecorder.h"
 
 
 #include <QOpenGLFunctions_4_5_Core>
+#include <QElapsedTimer>
+#include <QTimer>
 #include <QOpenGLWidget>
 #include <QString>
 #include <QVector>
+
+#include <map>
 #include <pxr/base/tf/notice.h>
 #include <pxr/usd/usd/notice.h>
 #include <pxr/usd/usd/stage.h>
@@ -52,8 +60,37 @@ public:
     void setRendererAov(const std::string& name);
     std::vector<std::string> getRendererAovs() const;
 
+    // renderer plugin of the viewport, kept when another stage is opened.
+    PXR_NS::TfTokenVector rendererPlugins() const;
+    PXR_NS::TfToken       rendererPlugin() const;
+    bool                  setRendererPlugin(const PXR_NS::TfToken& rendererId);
+
+    // settings of the current renderer. Values set here are reapplied when the engine is
+    // recreated for another stage, and dropped when switching renderers.
+    PXR_NS::UsdImagingGLRendererSettingsList rendererSettings() const;
+    PXR_NS::VtValue                          rendererSetting(const PXR_NS::TfToken& key) const;
+    void setRendererSetting(const PXR_NS::TfToken& key, const PXR_NS::VtValue& value);
+
     void setShowRendererStats(bool val);
 
+    // lowers the render resolution, materials and lights while the camera moves, to keep
+    // frame times within the budget. Full quality comes back once the input stops.
+    void   setAdaptiveQuality(bool enabled);
+    bool   adaptiveQuality() const;
+    void   setFrameBudgetMs(double budgetMs);
+    double frameBudgetMs() const;
+
+    // color format of the offscreen targets the viewport renders into.
+    void                          setColorFormat(UsdDrawTargetFBO::ColorFormat colorFormat);
+    UsdDrawTargetFBO::ColorFormat colorFormat() const;
+
+    // writes the per-pass frame timings recorded so far, as JSON or CSV depending on the suffix.
+    bool exportFrameProfile(const QString& filePath) const;
+
+    // render stats, frame times and memory sampled over the session, see RenderStatsRecorder.
+    bool exportRenderStats(const QString& filePath) const;
+    bool setRenderStatsStreamFile(const QString& filePath);
+
     double nearClip() const;
     double farClip()  const;
 
@@ -65,15 +102,41 @@ protected:
     void mousePressEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
+    void leaveEvent(QEvent* event) override;
 
 private:
+    // builds the camera and the render engine of the current stage, the viewport context must be current.
     void initialize();
+    void applyRendererChoice();
+    void registerStageNotices();
     void onUsdObjectChanged(const UsdNotice::ObjectsChanged& notice);
+    bool affectsSelectionBounds(const UsdNotice::ObjectsChanged& notice) const;
+    void requestRepaint();
+    void restartConvergence();
+    void beginInteraction();
+    void endInteraction();
+    void updateConvergence();
     void onSelectionChanged();
+    void onTimeChanged();
+    void syncSelection();
     void hudDrawRendereStats();
+    void drawMarquee();
+
+    // picking from the ids of the last frame, positions in device pixels of the widget.
+    // Both return false while the ids are missing, pending or older than the image shown,
+    // picking then falls back to pickWithIntersection.
+    void                  requestIdReadback();
+    bool                  collectIdBuffer();
+    bool                  pickFromIdBuffer(const QPoint& position, PXR_NS::SdfPath* path);
+    bool                  pickFromIdBuffer(const QRect& rect, PXR_NS::SdfPathVector* paths);
+    PXR_NS::SdfPath       decodeIds(const IdBuffer::Ids& ids);
+    PXR_NS::SdfPathVector pickWithIntersection(const QRect& rect, const PXR_NS::TfToken& resolveMode);
+    void                  applyPick(const PXR_NS::SdfPathVector& paths, Qt::KeyboardModifiers modifiers);
+    void                  setHoveredPath(const PXR_NS::SdfPath& path);
 
 Q_SIGNALS:
     void rendererAvailable();
+    void primHovered(const PXR_NS::SdfPath& path);
 
 private slots:
     void onStageOpened(const QString& filePath);
@@ -87,16 +150,48 @@ private:
     UsdDocument*                       m_usdDocument;
     std::unique_ptr<UsdCamera>         m_usdCamera;
     std::unique_ptr<UsdDrawTargetFBO>  m_drawTarget;
+    std::unique_ptr<UsdDrawTargetFBO>  m_interactiveDrawTarget; // reduced resolution, see m_quality
     std::unique_ptr<UsdRenderEngineGL> m_renderEngineGL;
     std::unique_ptr<Grid>              m_grid;
+    std::unique_ptr<IdBuffer>          m_idBuffer;
+    std::map<std::pair<int32_t, int32_t>, PXR_NS::SdfPath> m_decodedIds; // of the current id buffer
+    PXR_NS::SdfPath                    m_hoveredPath;
     PXR_NS::UsdStageRefPtr             m_stage;
     QPoint                             m_lastMousePosition;
+    QPoint                             m_pressPosition;
+    QPoint                             m_marqueeEnd;
     TfNotice::Key                      m_ObjectsChangedKey;
     double                             m_height;
     double                             m_width;
     ShadingMode                        m_shadingMode;
+    UsdDrawTargetFBO::ColorFormat      m_colorFormat { UsdDrawTargetFBO::ColorFormat::RGBA16F };
+    PXR_NS::TfToken                    m_rendererId;
+    PXR_NS::VtDictionary               m_rendererSettings;
     HudOverlay                         m_hud;
+    FrameProfiler                      m_profiler;
+    InteractiveQuality                 m_quality;
+    int                                m_renderedQualityLevel { 0 };
+    uint64_t                           m_qualityLevelFrame { 0 }; // first frame rendered at that level
+    QTimer*                            m_interactionTimer;
+    RenderStatsRecorder*               m_statsRecorder;
     bool                               m_showRendererStats{false};
+    bool                               m_selectionDirty { false };
+    bool                               m_selectionBboxDirty { false }; // selection and hover bounds
+    bool                               m_idBufferDirty { true };
+    bool                               m_selecting { false };
+    bool                               m_marqueeActive { false };
+    bool                               m_repaintPending { false };
+    QElapsedTimer                      m_frameTimer;
+
+    // progressive rendering since the image was last invalidated, see updateConvergence
+    struct Convergence
+    {
+        QElapsedTimer timer;
+        int           frames { 0 };
+        qint64        convergedMs { -1 };
+        bool          restart { true };
+    };
+    Convergence m_convergence;
 };
 
 } // namespace TINKERUSD_NS
\ No newline at end of file
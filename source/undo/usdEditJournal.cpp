@@ -0,0 +1,1430 @@
+#include "usdEditJournal.h"
+
+#include <pxr/base/gf/half.h>
+#include <pxr/base/gf/matrix2d.h>
+#include <pxr/base/gf/matrix3d.h>
+#include <pxr/base/gf/matrix4d.h>
+#include <pxr/base/gf/quatd.h>
+#include <pxr/base/gf/quatf.h>
+#include <pxr/base/gf/quath.h>
+#include <pxr/base/gf/vec2d.h>
+#include <pxr/base/gf/vec2f.h>
+#include <pxr/base/gf/vec2h.h>
+#include <pxr/base/gf/vec2i.h>
+#include <pxr/base/gf/vec3d.h>
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/gf/vec3h.h>
+#include <pxr/base/gf/vec3i.h>
+#include <pxr/base/gf/vec4d.h>
+#include <pxr/base/gf/vec4f.h>
+#include <pxr/base/gf/vec4h.h>
+#include <pxr/base/gf/vec4i.h>
+#include <pxr/base/tf/diagnostic.h>
+#include <pxr/base/vt/array.h>
+#include <pxr/base/vt/dictionary.h>
+#include <pxr/usd/sdf/assetPath.h>
+#include <pxr/usd/sdf/changeBlock.h>
+#include <pxr/usd/sdf/layerOffset.h>
+#include <pxr/usd/sdf/listOp.h>
+#include <pxr/usd/sdf/payload.h>
+#include <pxr/usd/sdf/reference.h>
+#include <pxr/usd/sdf/types.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+
+constexpr char   JOURNAL_MAGIC[8] = { 'T', 'K', 'J', 'R', 'N', 'L', '0', '1' };
+constexpr size_t RECORD_HEADER_SIZE = sizeof(uint8_t) + 2 * sizeof(uint32_t);
+
+// a journal holds the edits of a single layer, the index of its layer records
+constexpr uint32_t JOURNAL_LAYER_INDEX = 0;
+
+// records are handed to the operating system once this much is buffered
+constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+enum RecordType : uint8_t
+{
+    RECORD_LAYER = 1,
+    RECORD_SET_FIELD,
+    RECORD_SET_FIELD_DICT_VALUE_BY_KEY,
+    RECORD_SET_TIME_SAMPLE,
+    RECORD_CREATE_SPEC,
+    RECORD_DELETE_SPEC,
+    RECORD_MOVE_SPEC,
+    RECORD_PUSH_TOKEN_CHILD,
+    RECORD_PUSH_PATH_CHILD,
+    RECORD_POP_TOKEN_CHILD,
+    RECORD_POP_PATH_CHILD,
+    RECORD_INCOMPLETE // an edit could not be journaled, the records after it are not written
+};
+
+enum ValueTag : uint8_t
+{
+    TAG_EMPTY = 0,
+    TAG_BLOCK,
+    TAG_STRING,
+    TAG_TOKEN,
+    TAG_ASSET_PATH,
+    TAG_PATH,
+    TAG_STRING_ARRAY,
+    TAG_TOKEN_ARRAY,
+    TAG_ASSET_PATH_ARRAY,
+    TAG_STRING_VECTOR,
+    TAG_TOKEN_VECTOR,
+    TAG_PATH_VECTOR,
+    TAG_LAYER_OFFSET_VECTOR,
+    TAG_DICTIONARY,
+    TAG_TIME_SAMPLES,
+    TAG_VARIANT_SELECTIONS,
+    TAG_PATH_LIST_OP,
+    TAG_TOKEN_LIST_OP,
+    TAG_STRING_LIST_OP,
+    TAG_REFERENCE_LIST_OP,
+    TAG_PAYLOAD_LIST_OP,
+
+    // trivially copyable types, the index in PodTypes is added to the base
+    TAG_POD = 64,
+    TAG_POD_ARRAY = 128
+};
+
+template <class... Ts> struct TypeList
+{
+    static constexpr size_t size = sizeof...(Ts);
+};
+
+// values stored as raw bytes, alone or in a VtArray
+using PodTypes = TypeList<
+    bool,
+    int,
+    unsigned int,
+    int64_t,
+    uint64_t,
+    unsigned char,
+    GfHalf,
+    float,
+    double,
+    GfVec2f,
+    GfVec3f,
+    GfVec4f,
+    GfVec2d,
+    GfVec3d,
+    GfVec4d,
+    GfVec2h,
+    GfVec3h,
+    GfVec4h,
+    GfVec2i,
+    GfVec3i,
+    GfVec4i,
+    GfQuatf,
+    GfQuatd,
+    GfQuath,
+    GfMatrix2d,
+    GfMatrix3d,
+    GfMatrix4d,
+    SdfSpecifier,
+    SdfVariability,
+    SdfPermission,
+    SdfSpecType>;
+
+static_assert(PodTypes::size < TAG_POD_ARRAY - TAG_POD);
+
+constexpr SdfListOpType LIST_OP_TYPES[] = { SdfListOpTypeAdded,     SdfListOpTypeDeleted,
+                                            SdfListOpTypeOrdered,   SdfListOpTypePrepended,
+                                            SdfListOpTypeAppended };
+
+// FNV-1a, detects records torn by a crash in the middle of a write
+uint32_t checksum(const char* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+class Writer
+{
+public:
+    Writer(std::string& out)
+        : _out(out)
+    {
+    }
+
+    template <class T> void pod(const T& value) { bytes(&value, sizeof(T)); }
+
+    void bytes(const void* data, size_t size) { _out.append(static_cast<const char*>(data), size); }
+    void size(size_t size) { pod<uint64_t>(size); }
+    void string(const std::string& value)
+    {
+        size(value.size());
+        _out.append(value);
+    }
+    void token(const TfToken& value) { string(value.GetString()); }
+    void path(const SdfPath& value) { string(value.GetString()); }
+    void assetPath(const SdfAssetPath& value) { string(value.GetAssetPath()); }
+
+    void layerOffset(const SdfLayerOffset& value)
+    {
+        pod(value.GetOffset());
+        pod(value.GetScale());
+    }
+
+    // custom data the journal cannot store fails the value holding the reference.
+    void reference(const SdfReference& value)
+    {
+        string(value.GetAssetPath());
+        path(value.GetPrimPath());
+        layerOffset(value.GetLayerOffset());
+        if (!dictionary(value.GetCustomData()))
+        {
+            _ok = false;
+        }
+    }
+
+    void payload(const SdfPayload& value)
+    {
+        string(value.GetAssetPath());
+        path(value.GetPrimPath());
+        layerOffset(value.GetLayerOffset());
+    }
+
+    template <class Sequence, class WriteItem> void sequence(const Sequence& items, WriteItem writeItem)
+    {
+        size(items.size());
+        for (const auto& item : items)
+        {
+            (this->*writeItem)(item);
+        }
+    }
+
+    template <class T, class WriteItem> void listOp(const SdfListOp<T>& op, WriteItem writeItem)
+    {
+        pod<uint8_t>(op.IsExplicit());
+        if (op.IsExplicit())
+        {
+            sequence(op.GetExplicitItems(), writeItem);
+            return;
+        }
+        for (SdfListOpType type : LIST_OP_TYPES)
+        {
+            sequence(op.GetItems(type), writeItem);
+        }
+    }
+
+    bool dictionary(const VtDictionary& value)
+    {
+        size(value.size());
+        for (const auto& [key, item] : value)
+        {
+            string(key);
+            if (!this->value(item))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // returns false for value types the journal cannot store.
+    bool value(const VtValue& value)
+    {
+        if (value.IsEmpty())
+        {
+            pod<uint8_t>(TAG_EMPTY);
+            return true;
+        }
+        if (value.IsHolding<SdfValueBlock>())
+        {
+            pod<uint8_t>(TAG_BLOCK);
+            return true;
+        }
+        if (podValue(value, PodTypes {}, std::make_index_sequence<PodTypes::size> {}))
+        {
+            return true;
+        }
+        if (value.IsHolding<std::string>())
+        {
+            pod<uint8_t>(TAG_STRING);
+            string(value.UncheckedGet<std::string>());
+            return true;
+        }
+        if (value.IsHolding<TfToken>())
+        {
+            pod<uint8_t>(TAG_TOKEN);
+            token(value.UncheckedGet<TfToken>());
+            return true;
+        }
+        if (value.IsHolding<SdfAssetPath>())
+        {
+            pod<uint8_t>(TAG_ASSET_PATH);
+            assetPath(value.UncheckedGet<SdfAssetPath>());
+            return true;
+        }
+        if (value.IsHolding<SdfPath>())
+        {
+            pod<uint8_t>(TAG_PATH);
+            path(value.UncheckedGet<SdfPath>());
+            return true;
+        }
+        if (value.IsHolding<VtStringArray>())
+        {
+            pod<uint8_t>(TAG_STRING_ARRAY);
+            sequence(value.UncheckedGet<VtStringArray>(), &Writer::string);
+            return true;
+        }
+        if (value.IsHolding<VtTokenArray>())
+        {
+            pod<uint8_t>(TAG_TOKEN_ARRAY);
+            sequence(value.UncheckedGet<VtTokenArray>(), &Writer::token);
+            return true;
+        }
+        if (value.IsHolding<VtArray<SdfAssetPath>>())
+        {
+            pod<uint8_t>(TAG_ASSET_PATH_ARRAY);
+            sequence(value.UncheckedGet<VtArray<SdfAssetPath>>(), &Writer::assetPath);
+            return true;
+        }
+        if (value.IsHolding<std::vector<std::string>>())
+        {
+            pod<uint8_t>(TAG_STRING_VECTOR);
+            sequence(value.UncheckedGet<std::vector<std::string>>(), &Writer::string);
+            return true;
+        }
+        if (value.IsHolding<TfTokenVector>())
+        {
+            pod<uint8_t>(TAG_TOKEN_VECTOR);
+            sequence(value.UncheckedGet<TfTokenVector>(), &Writer::token);
+            return true;
+        }
+        if (value.IsHolding<SdfPathVector>())
+        {
+            pod<uint8_t>(TAG_PATH_VECTOR);
+            sequence(value.UncheckedGet<SdfPathVector>(), &Writer::path);
+            return true;
+        }
+        if (value.IsHolding<SdfLayerOffsetVector>())
+        {
+            pod<uint8_t>(TAG_LAYER_OFFSET_VECTOR);
+            sequence(value.UncheckedGet<SdfLayerOffsetVector>(), &Writer::layerOffset);
+            return true;
+        }
+        if (value.IsHolding<VtDictionary>())
+        {
+            pod<uint8_t>(TAG_DICTIONARY);
+            return dictionary(value.UncheckedGet<VtDictionary>());
+        }
+        if (value.IsHolding<SdfTimeSampleMap>())
+        {
+            pod<uint8_t>(TAG_TIME_SAMPLES);
+            const auto& samples = value.UncheckedGet<SdfTimeSampleMap>();
+            size(samples.size());
+            for (const auto& [time, sample] : samples)
+            {
+                pod(time);
+                if (!this->value(sample))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        if (value.IsHolding<SdfVariantSelectionMap>())
+        {
+            pod<uint8_t>(TAG_VARIANT_SELECTIONS);
+            const auto& selections = value.UncheckedGet<SdfVariantSelectionMap>();
+            size(selections.size());
+            for (const auto& [variantSet, variant] : selections)
+            {
+                string(variantSet);
+                string(variant);
+            }
+            return true;
+        }
+        if (value.IsHolding<SdfPathListOp>())
+        {
+            pod<uint8_t>(TAG_PATH_LIST_OP);
+            listOp(value.UncheckedGet<SdfPathListOp>(), &Writer::path);
+            return true;
+        }
+        if (value.IsHolding<SdfTokenListOp>())
+        {
+            pod<uint8_t>(TAG_TOKEN_LIST_OP);
+            listOp(value.UncheckedGet<SdfTokenListOp>(), &Writer::token);
+            return true;
+        }
+        if (value.IsHolding<SdfStringListOp>())
+        {
+            pod<uint8_t>(TAG_STRING_LIST_OP);
+            listOp(value.UncheckedGet<SdfStringListOp>(), &Writer::string);
+            return true;
+        }
+        if (value.IsHolding<SdfReferenceListOp>())
+        {
+            pod<uint8_t>(TAG_REFERENCE_LIST_OP);
+            listOp(value.UncheckedGet<SdfReferenceListOp>(), &Writer::reference);
+            return _ok;
+        }
+        if (value.IsHolding<SdfPayloadListOp>())
+        {
+            pod<uint8_t>(TAG_PAYLOAD_LIST_OP);
+            listOp(value.UncheckedGet<SdfPayloadListOp>(), &Writer::payload);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    template <class T> bool podValueAs(const VtValue& value, uint8_t index)
+    {
+        if (value.IsHolding<T>())
+        {
+            pod<uint8_t>(TAG_POD + index);
+            pod(value.UncheckedGet<T>());
+            return true;
+        }
+        if (value.IsHolding<VtArray<T>>())
+        {
+            const auto& array = value.UncheckedGet<VtArray<T>>();
+            pod<uint8_t>(TAG_POD_ARRAY + index);
+            size(array.size());
+            bytes(array.cdata(), array.size() * sizeof(T));
+            return true;
+        }
+        return false;
+    }
+
+    template <class... Ts, size_t... Is>
+    bool podValue(const VtValue& value, TypeList<Ts...>, std::index_sequence<Is...>)
+    {
+        return (podValueAs<Ts>(value, static_cast<uint8_t>(Is)) || ...);
+    }
+
+private:
+    std::string& _out;
+    bool         _ok { true };
+};
+
+class Reader
+{
+public:
+    Reader(const char* data, size_t size)
+        : _data(data)
+        , _size(size)
+    {
+    }
+
+    bool ok() const { return _ok; }
+
+    template <class T> T pod()
+    {
+        T value {};
+        bytes(&value, sizeof(T));
+        return value;
+    }
+
+    void bytes(void* data, size_t size)
+    {
+        if (!require(size))
+        {
+            return;
+        }
+        std::memcpy(data, _data + _offset, size);
+        _offset += size;
+    }
+
+    // reads an element count, checking that at least minItemSize bytes per element are left.
+    size_t size(size_t minItemSize = 1)
+    {
+        const auto count = pod<uint64_t>();
+        if (minItemSize > 0 && count > (_size - _offset) / minItemSize)
+        {
+            _ok = false;
+            return 0;
+        }
+        return static_cast<size_t>(count);
+    }
+
+    std::string string()
+    {
+        const size_t length = size();
+        if (!require(length))
+        {
+            return std::string();
+        }
+        std::string value(_data + _offset, length);
+        _offset += length;
+        return value;
+    }
+
+    TfToken        token() { return TfToken(string()); }
+    SdfPath        path() { return SdfPath(string()); }
+    SdfAssetPath   assetPath() { return SdfAssetPath(string()); }
+    SdfLayerOffset layerOffset()
+    {
+        const auto offset = pod<double>();
+        const auto scale = pod<double>();
+        return SdfLayerOffset(offset, scale);
+    }
+
+    SdfReference reference()
+    {
+        const std::string    assetPath = string();
+        const SdfPath        primPath = path();
+        const SdfLayerOffset offset = layerOffset();
+        return SdfReference(assetPath, primPath, offset, dictionary());
+    }
+
+    SdfPayload payload()
+    {
+        const std::string    assetPath = string();
+        const SdfPath        primPath = path();
+        const SdfLayerOffset offset = layerOffset();
+        return SdfPayload(assetPath, primPath, offset);
+    }
+
+    template <class Sequence, class ReadItem> Sequence sequence(ReadItem readItem)
+    {
+        const size_t count = size();
+        Sequence     items;
+        items.reserve(count);
+        for (size_t i = 0; i < count && _ok; ++i)
+        {
+            items.push_back((this->*readItem)());
+        }
+        return items;
+    }
+
+    template <class T, class ReadItem> SdfListOp<T> listOp(ReadItem readItem)
+    {
+        using Items = typename SdfListOp<T>::ItemVector;
+
+        SdfListOp<T> op;
+        if (pod<uint8_t>())
+        {
+            op.SetExplicitItems(sequence<Items>(readItem));
+            return op;
+        }
+        for (SdfListOpType type : LIST_OP_TYPES)
+        {
+            op.SetItems(sequence<Items>(readItem), type);
+        }
+        return op;
+    }
+
+    VtDictionary dictionary()
+    {
+        VtDictionary dict;
+        const size_t count = size();
+        for (size_t i = 0; i < count && _ok; ++i)
+        {
+            std::string key = string();
+            dict[key] = value();
+        }
+        return dict;
+    }
+
+    VtValue value()
+    {
+        const auto tag = pod<uint8_t>();
+        if (!_ok)
+        {
+            return VtValue();
+        }
+
+        if (tag >= TAG_POD)
+        {
+            const bool    isArray = tag >= TAG_POD_ARRAY;
+            const uint8_t index = tag - (isArray ? TAG_POD_ARRAY : TAG_POD);
+            if (index >= PodTypes::size)
+            {
+                _ok = false;
+                return VtValue();
+            }
+            return podValue(index, isArray, PodTypes {}, std::make_index_sequence<PodTypes::size> {});
+        }
+
+        switch (tag)
+        {
+        case TAG_EMPTY: return VtValue();
+        case TAG_BLOCK: return VtValue(SdfValueBlock());
+        case TAG_STRING: return VtValue(string());
+        case TAG_TOKEN: return VtValue(token());
+        case TAG_ASSET_PATH: return VtValue(assetPath());
+        case TAG_PATH: return VtValue(path());
+        case TAG_STRING_ARRAY: return VtValue(sequence<VtStringArray>(&Reader::string));
+        case TAG_TOKEN_ARRAY: return VtValue(sequence<VtTokenArray>(&Reader::token));
+        case TAG_ASSET_PATH_ARRAY: return VtValue(sequence<VtArray<SdfAssetPath>>(&Reader::assetPath));
+        case TAG_STRING_VECTOR: return VtValue(sequence<std::vector<std::string>>(&Reader::string));
+        case TAG_TOKEN_VECTOR: return VtValue(sequence<TfTokenVector>(&Reader::token));
+        case TAG_PATH_VECTOR: return VtValue(sequence<SdfPathVector>(&Reader::path));
+        case TAG_LAYER_OFFSET_VECTOR: return VtValue(sequence<SdfLayerOffsetVector>(&Reader::layerOffset));
+        case TAG_DICTIONARY: return VtValue(dictionary());
+        case TAG_TIME_SAMPLES:
+        {
+            SdfTimeSampleMap samples;
+            const size_t     count = size();
+            for (size_t i = 0; i < count && _ok; ++i)
+            {
+                const auto time = pod<double>();
+                samples[time] = value();
+            }
+            return VtValue(samples);
+        }
+        case TAG_VARIANT_SELECTIONS:
+        {
+            SdfVariantSelectionMap selections;
+            const size_t           count = size();
+            for (size_t i = 0; i < count && _ok; ++i)
+            {
+                std::string variantSet = string();
+                selections[variantSet] = string();
+            }
+            return VtValue(selections);
+        }
+        case TAG_PATH_LIST_OP: return VtValue(listOp<SdfPath>(&Reader::path));
+        case TAG_TOKEN_LIST_OP: return VtValue(listOp<TfToken>(&Reader::token));
+        case TAG_STRING_LIST_OP: return VtValue(listOp<std::string>(&Reader::string));
+        case TAG_REFERENCE_LIST_OP: return VtValue(listOp<SdfReference>(&Reader::reference));
+        case TAG_PAYLOAD_LIST_OP: return VtValue(listOp<SdfPayload>(&Reader::payload));
+        default: _ok = false; return VtValue();
+        }
+    }
+
+private:
+    bool require(size_t size)
+    {
+        if (!_ok || size > _size - _offset)
+        {
+            _ok = false;
+        }
+        return _ok;
+    }
+
+    template <class T> VtValue podValueAs(bool isArray)
+    {
+        if (!isArray)
+        {
+            return VtValue(pod<T>());
+        }
+        VtArray<T> array(size(sizeof(T)));
+        bytes(array.data(), array.size() * sizeof(T));
+        return VtValue(array);
+    }
+
+    template <class... Ts, size_t... Is>
+    VtValue podValue(uint8_t index, bool isArray, TypeList<Ts...>, std::index_sequence<Is...>)
+    {
+        VtValue result;
+        ((Is == index ? (result = podValueAs<Ts>(isArray), true) : false) || ...);
+        return result;
+    }
+
+private:
+    const char* _data;
+    size_t      _size;
+    size_t      _offset { 0 };
+    bool        _ok { true };
+};
+
+// duplicates the descriptor of a journal file, the duplicate stays valid to sync after the
+// journal closed the file.
+int duplicateDescriptor(std::FILE* file)
+{
+#ifdef _WIN32
+    return _dup(_fileno(file));
+#else
+    return dup(fileno(file));
+#endif
+}
+
+// syncs and closes a duplicated descriptor.
+bool syncDescriptor(int descriptor)
+{
+#ifdef _WIN32
+    const bool synced = _commit(descriptor) == 0;
+    _close(descriptor);
+#else
+    const bool synced = fsync(descriptor) == 0;
+    close(descriptor);
+#endif
+    return synced;
+}
+
+bool syncFile(std::FILE* file)
+{
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+} // namespace
+
+namespace TINKERUSD_NS
+{
+
+UsdEditJournal& UsdEditJournal::instance()
+{
+    static UsdEditJournal editJournal;
+    return editJournal;
+}
+
+UsdEditJournal::~UsdEditJournal()
+{
+    // journals left open are kept, the process did not stop them
+    stopAll(false);
+}
+
+bool UsdEditJournal::start(const SdfLayerHandle& layer, const std::string& filePath)
+{
+    if (!layer)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (_journals.count(layer->GetIdentifier()))
+        {
+            return true;
+        }
+
+        Journal journal;
+        journal.filePath = filePath;
+        journal.identifier = layer->GetIdentifier();
+        if (!openFile(journal))
+        {
+            return false;
+        }
+        _journals.emplace(journal.identifier, std::move(journal));
+        _journalCount = _journals.size();
+    }
+
+    startSyncThread();
+    return true;
+}
+
+void UsdEditJournal::stop(const std::string& layerIdentifier, bool discard)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _journals.find(layerIdentifier);
+    if (it == _journals.end())
+    {
+        return;
+    }
+
+    closeFile(it->second, !discard);
+    if (discard)
+    {
+        std::remove(it->second.filePath.c_str());
+    }
+    _journals.erase(it);
+    _journalCount = _journals.size();
+}
+
+void UsdEditJournal::stopAll(bool discard)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (auto& entry : _journals)
+        {
+            closeFile(entry.second, !discard);
+            if (discard)
+            {
+                std::remove(entry.second.filePath.c_str());
+            }
+        }
+        _journals.clear();
+        _journalCount = 0;
+    }
+
+    stopSyncThread();
+}
+
+void UsdEditJournal::reset(const SdfLayerHandle& layer)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Journal* journal = journalOf(layer);
+    if (!journal || !journal->hasEdits)
+    {
+        return;
+    }
+
+    // reopening truncates the file
+    closeFile(*journal, false);
+    if (!openFile(*journal))
+    {
+        _journals.erase(layer->GetIdentifier());
+        _journalCount = _journals.size();
+    }
+}
+
+bool UsdEditJournal::isRecording(const SdfLayerHandle& layer) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return layer && _journals.count(layer->GetIdentifier());
+}
+
+std::string UsdEditJournal::filePath(const SdfLayerHandle& layer) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = layer ? _journals.find(layer->GetIdentifier()) : _journals.end();
+    return it != _journals.end() ? it->second.filePath : std::string();
+}
+
+void UsdEditJournal::flush()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& entry : _journals)
+    {
+        flushBuffer(entry.second);
+    }
+}
+
+void UsdEditJournal::sync()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& entry : _journals)
+    {
+        flushBuffer(entry.second);
+        if (entry.second.needsSync)
+        {
+            syncFile(entry.second.file);
+            entry.second.needsSync = false;
+        }
+    }
+}
+
+void UsdEditJournal::setSyncInterval(std::chrono::milliseconds interval)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _syncInterval = interval;
+    }
+    _syncCondition.notify_all();
+}
+
+bool UsdEditJournal::containsEdits(const std::string& filePath)
+{
+    std::ifstream stream(filePath, std::ios::binary | std::ios::ate);
+    return stream && static_cast<size_t>(stream.tellg()) > sizeof(JOURNAL_MAGIC) + RECORD_HEADER_SIZE;
+}
+
+bool UsdEditJournal::replay(const std::string& filePath, ReplayStats* stats)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    std::ifstream stream(filePath, std::ios::binary);
+    if (!stream)
+    {
+        TF_RUNTIME_ERROR("Failed to open edit journal '%s'", filePath.c_str());
+        return false;
+    }
+    const std::string content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    if (content.size() < sizeof(JOURNAL_MAGIC)
+        || std::memcmp(content.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0)
+    {
+        TF_RUNTIME_ERROR("'%s' is not an edit journal", filePath.c_str());
+        return false;
+    }
+
+    ReplayStats                 replayStats;
+    std::vector<SdfLayerRefPtr> layers;
+
+    // resolves the layer of a record, nullptr for layers that could not be opened
+    auto layerAt = [&layers](uint32_t index) -> SdfLayerStateDelegateBasePtr {
+        return index < layers.size() && layers[index] ? layers[index]->GetStateDelegate()
+                                                      : SdfLayerStateDelegateBasePtr();
+    };
+
+    SdfChangeBlock changeBlock;
+
+    size_t offset = sizeof(JOURNAL_MAGIC);
+    while (offset + RECORD_HEADER_SIZE <= content.size())
+    {
+        Reader header(content.data() + offset, RECORD_HEADER_SIZE);
+        const auto type = header.pod<uint8_t>();
+        const auto size = header.pod<uint32_t>();
+        const auto sum = header.pod<uint32_t>();
+
+        const char* payload = content.data() + offset + RECORD_HEADER_SIZE;
+        if (size > content.size() - offset - RECORD_HEADER_SIZE || checksum(payload, size) != sum)
+        {
+            // the application went down while this record was being written
+            TF_WARN("Edit journal '%s' ends with an incomplete record, ignoring it.", filePath.c_str());
+            break;
+        }
+        offset += RECORD_HEADER_SIZE + size;
+
+        Reader reader(payload, size);
+        if (type == RECORD_LAYER)
+        {
+            const auto        index = reader.pod<uint32_t>();
+            const std::string identifier = reader.string();
+            if (index >= layers.size())
+            {
+                layers.resize(index + 1);
+            }
+            layers[index] = SdfLayer::FindOrOpen(identifier);
+            if (!layers[index])
+            {
+                TF_WARN("Cannot open layer '%s', skipping its journaled edits.", identifier.c_str());
+            }
+            continue;
+        }
+
+        if (type == RECORD_INCOMPLETE)
+        {
+            // the edits before the lost one are consistent and kept, nothing follows it
+            reader.pod<uint32_t>();
+            const std::string typeName = reader.string();
+            TF_WARN(
+                "Edit journal '%s' is incomplete, an edit holding a '%s' value was not journaled. "
+                "The edits made after it are not recovered.",
+                filePath.c_str(),
+                typeName.c_str());
+            replayStats.incomplete = true;
+            break;
+        }
+
+        auto delegate = layerAt(reader.pod<uint32_t>());
+        if (!delegate || !reader.ok())
+        {
+            ++replayStats.skipped;
+            continue;
+        }
+
+        bool applied = false;
+        switch (type)
+        {
+        case RECORD_SET_FIELD:
+        {
+            const SdfPath path = reader.path();
+            const TfToken fieldName = reader.token();
+            const VtValue value = reader.value();
+            if (reader.ok())
+            {
+                delegate->SetField(path, fieldName, value);
+                applied = true;
+            }
+            break;
+        }
+        case RECORD_SET_FIELD_DICT_VALUE_BY_KEY:
+        {
+            const SdfPath path = reader.path();
+            const TfToken fieldName = reader.token();
+            const TfToken keyPath = reader.token();
+            const VtValue value = reader.value();
+            if (reader.ok())
+            {
+                delegate->SetFieldDictValueByKey(path, fieldName, keyPath, value);
+                applied = true;
+            }
+            break;
+        }
+        case RECORD_SET_TIME_SAMPLE:
+        {
+            const SdfPath path = reader.path();
+            const auto    time = reader.pod<double>();
+            const VtValue value = reader.value();
+            if (reader.ok())
+            {
+                delegate->SetTimeSample(path, time, value);
+                applied = true;
+            }
+            break;
+        }
+        case RECORD_CREATE_SPEC:
+        {
+            const SdfPath path = reader.path();
+            const auto    specType = reader.pod<SdfSpecType>();
+            const bool    inert = reader.pod<uint8_t>();
+            if (reader.ok())
+            {
+                delegate->CreateSpec(path, specType, inert);
+                applied = true;
+            }
+            break;
+        }
+        case RECORD_DELETE_SPEC:
+        {
+            const SdfPath path = reader.path();
+            const bool    inert = reader.pod<uint8_t>();
+            if (reader.ok())
+            {
+                delegate->DeleteSpec(path, inert);
+                applied = true;
+            }
+            break;
+        }
+        case RECORD_MOVE_SPEC:
+        {
+            const SdfPath oldPath = reader.path();
+            const SdfPath newPath = reader.path();
+            if (reader.ok())
+            {
+                delegate->MoveSpec(oldPath, newPath);
+                applied = true;
+            }
+            break;
+        }
+        case RECORD_PUSH_TOKEN_CHILD:
+        case RECORD_POP_TOKEN_CHILD:
+        {
+            const SdfPath parentPath = reader.path();
+            const TfToken fieldName = reader.token();
+            const TfToken value = reader.token();
+            if (reader.ok())
+            {
+                type == RECORD_PUSH_TOKEN_CHILD ? delegate->PushChild(parentPath, fieldName, value)
+                                                : delegate->PopChild(parentPath, fieldName, value);
+                applied = true;
+            }
+            break;
+        }
+        case RECORD_PUSH_PATH_CHILD:
+        case RECORD_POP_PATH_CHILD:
+        {
+            const SdfPath parentPath = reader.path();
+            const TfToken fieldName = reader.token();
+            const SdfPath value = reader.path();
+            if (reader.ok())
+            {
+                type == RECORD_PUSH_PATH_CHILD ? delegate->PushChild(parentPath, fieldName, value)
+                                               : delegate->PopChild(parentPath, fieldName, value);
+                applied = true;
+            }
+            break;
+        }
+        default: break;
+        }
+
+        if (applied)
+        {
+            ++replayStats.records;
+        }
+        else
+        {
+            ++replayStats.skipped;
+        }
+    }
+
+    replayStats.milliseconds
+        = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (stats)
+    {
+        *stats = replayStats;
+    }
+    return true;
+}
+
+void UsdEditJournal::recordSetField(
+    const SdfLayerHandle& layer,
+    const SdfPath&        path,
+    const TfToken&        fieldName,
+    const VtValue&        value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Journal*                    journal = journalOf(layer);
+    if (!journal)
+    {
+        return;
+    }
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.path(path);
+    writer.token(fieldName);
+    if (!writer.value(value))
+    {
+        markIncomplete(*journal, value);
+        return;
+    }
+    appendRecord(*journal, RECORD_SET_FIELD, payload);
+}
+
+void UsdEditJournal::recordSetFieldDictValueByKey(
+    const SdfLayerHandle& layer,
+    const SdfPath&        path,
+    const TfToken&        fieldName,
+    const TfToken&        keyPath,
+    const VtValue&        value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Journal*                    journal = journalOf(layer);
+    if (!journal)
+    {
+        return;
+    }
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.path(path);
+    writer.token(fieldName);
+    writer.token(keyPath);
+    if (!writer.value(value))
+    {
+        markIncomplete(*journal, value);
+        return;
+    }
+    appendRecord(*journal, RECORD_SET_FIELD_DICT_VALUE_BY_KEY, payload);
+}
+
+void UsdEditJournal::recordSetTimeSample(
+    const SdfLayerHandle& layer,
+    const SdfPath&        path,
+    double                time,
+    const VtValue&        value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Journal*                    journal = journalOf(layer);
+    if (!journal)
+    {
+        return;
+    }
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.path(path);
+    writer.pod(time);
+    if (!writer.value(value))
+    {
+        markIncomplete(*journal, value);
+        return;
+    }
+    appendRecord(*journal, RECORD_SET_TIME_SAMPLE, payload);
+}
+
+void UsdEditJournal::recordCreateSpec(
+    const SdfLayerHandle& layer,
+    const SdfPath&        path,
+    SdfSpecType           specType,
+    bool                  inert)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Journal*                    journal = journalOf(layer);
+    if (!journal)
+    {
+        return;
+    }
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.path(path);
+    writer.pod(specType);
+    writer.pod<uint8_t>(inert);
+    appendRecord(*journal, RECORD_CREATE_SPEC, payload);
+}
+
+void UsdEditJournal::recordDeleteSpec(const SdfLayerHandle& layer, const SdfPath& path, bool inert)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Journal*                    journal = journalOf(layer);
+    if (!journal)
+    {
+        return;
+    }
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.path(path);
+    writer.pod<uint8_t>(inert);
+    appendRecord(*journal, RECORD_DELETE_SPEC, payload);
+}
+
+void UsdEditJournal::recordMoveSpec(const SdfLayerHandle& layer, const SdfPath& oldPath, const SdfPath& newPath)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Journal*                    journal = journalOf(layer);
+    if (!journal)
+    {
+        return;
+    }
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.path(oldPath);
+    writer.path(newPath);
+    appendRecord(*journal, RECORD_MOVE_SPEC, payload);
+}
+
+void UsdEditJournal::recordPushChild(
+    const SdfLayerHandle& layer,
+    const SdfPath&        parentPath,
+    const TfToken&        fieldName,
+    const TfToken&        value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Journal*                    journal = journalOf(layer);
+    if (!journal)
+    {
+        return;
+    }
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.path(parentPath);
+    writer.token(fieldName);
+    writer.token(value);
+    appendRecord(*journal, RECORD_PUSH_TOKEN_CHILD, payload);
+}
+
+void UsdEditJournal::recordPushChild(
+    const SdfLayerHandle& layer,
+    const SdfPath&        parentPath,
+    const TfToken&        fieldName,
+    const SdfPath&        value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Journal*                    journal = journalOf(layer);
+    if (!journal)
+    {
+        return;
+    }
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.path(parentPath);
+    writer.token(fieldName);
+    writer.path(value);
+    appendRecord(*journal, RECORD_PUSH_PATH_CHILD, payload);
+}
+
+void UsdEditJournal::recordPopChild(
+    const SdfLayerHandle& layer,
+    const SdfPath&        parentPath,
+    const TfToken&        fieldName,
+    const TfToken&        value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Journal*                    journal = journalOf(layer);
+    if (!journal)
+    {
+        return;
+    }
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.path(parentPath);
+    writer.token(fieldName);
+    writer.token(value);
+    appendRecord(*journal, RECORD_POP_TOKEN_CHILD, payload);
+}
+
+void UsdEditJournal::recordPopChild(
+    const SdfLayerHandle& layer,
+    const SdfPath&        parentPath,
+    const TfToken&        fieldName,
+    const SdfPath&        value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Journal*                    journal = journalOf(layer);
+    if (!journal)
+    {
+        return;
+    }
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.path(parentPath);
+    writer.token(fieldName);
+    writer.path(value);
+    appendRecord(*journal, RECORD_POP_PATH_CHILD, payload);
+}
+
+UsdEditJournal::Journal* UsdEditJournal::journalOf(const SdfLayerHandle& layer)
+{
+    auto it = _journals.find(layer->GetIdentifier());
+    return it != _journals.end() ? &it->second : nullptr;
+}
+
+void UsdEditJournal::markIncomplete(Journal& journal, const VtValue& value)
+{
+    // the journal ends at the lost edit, later edits may depend on it
+    TF_WARN(
+        "Values of type '%s' cannot be journaled, edits to '%s' are not journaled until it is saved.",
+        value.GetTypeName().c_str(),
+        journal.identifier.c_str());
+
+    std::string payload;
+    Writer      writer(payload);
+    writer.pod(JOURNAL_LAYER_INDEX);
+    writer.string(value.GetTypeName());
+    appendRecord(journal, RECORD_INCOMPLETE, payload);
+    flushBuffer(journal);
+
+    journal.incomplete = true;
+}
+
+void UsdEditJournal::appendRecord(Journal& journal, uint8_t type, const std::string& payload)
+{
+    if (journal.incomplete)
+    {
+        return;
+    }
+
+    // the layer the edits apply to is recorded ahead of its first edit
+    if (!journal.hasEdits)
+    {
+        journal.hasEdits = true;
+
+        std::string layerPayload;
+        Writer      layerWriter(layerPayload);
+        layerWriter.pod(JOURNAL_LAYER_INDEX);
+        layerWriter.string(journal.identifier);
+        appendRecord(journal, RECORD_LAYER, layerPayload);
+    }
+
+    Writer writer(journal.buffer);
+    writer.pod(type);
+    writer.pod(static_cast<uint32_t>(payload.size()));
+    writer.pod(checksum(payload.data(), payload.size()));
+    writer.bytes(payload.data(), payload.size());
+
+    if (journal.buffer.size() >= FLUSH_THRESHOLD)
+    {
+        flushBuffer(journal);
+    }
+}
+
+bool UsdEditJournal::openFile(Journal& journal)
+{
+    journal.file = std::fopen(journal.filePath.c_str(), "wb");
+    if (!journal.file)
+    {
+        TF_RUNTIME_ERROR("Failed to create edit journal '%s'", journal.filePath.c_str());
+        return false;
+    }
+
+    journal.buffer.assign(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    journal.hasEdits = false;
+    journal.incomplete = false;
+    flushBuffer(journal);
+    return true;
+}
+
+void UsdEditJournal::closeFile(Journal& journal, bool syncToDisk)
+{
+    if (!journal.file)
+    {
+        return;
+    }
+
+    flushBuffer(journal);
+    if (syncToDisk)
+    {
+        syncFile(journal.file);
+    }
+    std::fclose(journal.file);
+    journal.file = nullptr;
+    journal.needsSync = false;
+}
+
+void UsdEditJournal::flushBuffer(Journal& journal)
+{
+    if (journal.buffer.empty() || !journal.file)
+    {
+        return;
+    }
+
+    std::fwrite(journal.buffer.data(), 1, journal.buffer.size(), journal.file);
+    std::fflush(journal.file);
+    journal.buffer.clear();
+    journal.needsSync = true;
+}
+
+void UsdEditJournal::startSyncThread()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_syncThread.joinable())
+    {
+        _stopSyncThread = false;
+        _syncThread = std::thread(&UsdEditJournal::syncLoop, this);
+    }
+}
+
+void UsdEditJournal::stopSyncThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopSyncThread = true;
+    }
+    _syncCondition.notify_all();
+
+    if (_syncThread.joinable())
+    {
+        _syncThread.join();
+    }
+}
+
+void UsdEditJournal::syncLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stopSyncThread)
+    {
+        _syncCondition.wait_for(lock, _syncInterval, [this]() { return _stopSyncThread; });
+
+        // edits made outside of an undo block are handed to the operating system here
+        std::vector<int> descriptors;
+        for (auto& entry : _journals)
+        {
+            Journal& journal = entry.second;
+            flushBuffer(journal);
+            if (journal.needsSync)
+            {
+                journal.needsSync = false;
+                const int descriptor = duplicateDescriptor(journal.file);
+                if (descriptor >= 0)
+                {
+                    descriptors.push_back(descriptor);
+                }
+            }
+        }
+
+        // the disk is waited for without the lock, edits keep being recorded meanwhile
+        lock.unlock();
+        for (const int descriptor : descriptors)
+        {
+            syncDescriptor(descriptor);
+        }
+        lock.lock();
+    }
+}
+
+} // namespace TINKERUSD_NS
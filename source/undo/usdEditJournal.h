@@ -0,0 +1,169 @@
+#pragma once
+
+#include "core/utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <pxr/usd/sdf/layer.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace TINKERUSD_NS
+{
+
+//! \brief Append-only binary journals of the forward edits made to tracked layers.
+/*!
+    UsdUndoStateDelegate reports every authoring operation on the layers it tracks
+    before the operation is applied. Each journaled layer has its own file, the
+    journal appends the edits of the layer to it as records, so that the edits made
+    since the layer was last saved survive a crash. Edits to layers without a
+    journal are not recorded.
+
+    Records are buffered and handed to the operating system at the end of every
+    outermost UsdUndoBlock, or once a buffer grows large. A background thread syncs
+    the files that received records to disk once the sync interval has elapsed, the
+    thread that edits never waits for the disk.
+
+    replay() applies a journal on top of freshly opened layers, through the state
+    delegates of those layers.
+
+    An edit whose value type cannot be serialized marks the journal as incomplete,
+    nothing is appended to it until the layer is saved. replay() applies the edits
+    recorded before that point only and reports the journal as incomplete.
+*/
+class UsdEditJournal
+{
+public:
+    struct ReplayStats
+    {
+        size_t records { 0 };
+        size_t skipped { 0 };
+        double milliseconds { 0.0 };
+        bool   incomplete { false }; // edits were lost when the journal was recorded
+    };
+
+    // returns an instance of the edit journal.
+    static UsdEditJournal& instance();
+
+    DISALLOW_COPY_MOVE_ASSIGNMENT(UsdEditJournal);
+
+    // starts journaling the edits of layer into filePath, replacing any journal already
+    // there. Does nothing when the layer is journaled already.
+    bool start(const SdfLayerHandle& layer, const std::string& filePath);
+
+    // stops journaling the layer with the given identifier. Its journal file is removed
+    // when discard is set.
+    void stop(const std::string& layerIdentifier, bool discard);
+
+    // stops journaling every layer.
+    void stopAll(bool discard);
+
+    // drops the recorded edits of a layer, e.g. once the layer has been saved.
+    void reset(const SdfLayerHandle& layer);
+
+    bool        isRecording() const { return _journalCount.load(std::memory_order_relaxed) > 0; }
+    bool        isRecording(const SdfLayerHandle& layer) const;
+    std::string filePath(const SdfLayerHandle& layer) const;
+
+    // hands buffered records to the operating system. The sync thread syncs them to disk
+    // once the sync interval has elapsed.
+    void flush();
+
+    // flushes and syncs every journal to disk, blocking until done.
+    void sync();
+
+    void setSyncInterval(std::chrono::milliseconds interval);
+
+    // whether the journal at filePath holds at least one edit.
+    static bool containsEdits(const std::string& filePath);
+
+    // applies the edits recorded in filePath to the layers they were recorded on.
+    static bool replay(const std::string& filePath, ReplayStats* stats = nullptr);
+
+    // edits reported by UsdUndoStateDelegate.
+    void recordSetField(
+        const SdfLayerHandle& layer,
+        const SdfPath&        path,
+        const TfToken&        fieldName,
+        const VtValue&        value);
+    void recordSetFieldDictValueByKey(
+        const SdfLayerHandle& layer,
+        const SdfPath&        path,
+        const TfToken&        fieldName,
+        const TfToken&        keyPath,
+        const VtValue&        value);
+    void recordSetTimeSample(const SdfLayerHandle& layer, const SdfPath& path, double time, const VtValue& value);
+    void recordCreateSpec(const SdfLayerHandle& layer, const SdfPath& path, SdfSpecType specType, bool inert);
+    void recordDeleteSpec(const SdfLayerHandle& layer, const SdfPath& path, bool inert);
+    void recordMoveSpec(const SdfLayerHandle& layer, const SdfPath& oldPath, const SdfPath& newPath);
+    void recordPushChild(
+        const SdfLayerHandle& layer,
+        const SdfPath&        parentPath,
+        const TfToken&        fieldName,
+        const TfToken&        value);
+    void recordPushChild(
+        const SdfLayerHandle& layer,
+        const SdfPath&        parentPath,
+        const TfToken&        fieldName,
+        const SdfPath&        value);
+    void recordPopChild(
+        const SdfLayerHandle& layer,
+        const SdfPath&        parentPath,
+        const TfToken&        fieldName,
+        const TfToken&        value);
+    void recordPopChild(
+        const SdfLayerHandle& layer,
+        const SdfPath&        parentPath,
+        const TfToken&        fieldName,
+        const SdfPath&        value);
+
+private:
+    // the journal file of one layer.
+    struct Journal
+    {
+        std::FILE*  file { nullptr };
+        std::string filePath;
+        std::string identifier;
+        std::string buffer;
+        bool        hasEdits { false };
+        bool        incomplete { false }; // an edit could not be journaled, nothing is appended anymore
+        bool        needsSync { false }; // records were handed to the OS since the last sync
+    };
+
+    UsdEditJournal() = default;
+    ~UsdEditJournal();
+
+    // returns the journal of the layer, nullptr when the layer is not journaled.
+    Journal* journalOf(const SdfLayerHandle& layer);
+
+    // records that an edit holding value was lost and stops appending to the journal.
+    void markIncomplete(Journal& journal, const VtValue& value);
+    void appendRecord(Journal& journal, uint8_t type, const std::string& payload);
+    bool openFile(Journal& journal);
+    void closeFile(Journal& journal, bool syncToDisk);
+    void flushBuffer(Journal& journal);
+
+    void startSyncThread();
+    void stopSyncThread();
+    void syncLoop();
+
+private:
+    mutable std::mutex                       _mutex;
+    std::unordered_map<std::string, Journal> _journals; // by layer identifier
+    std::atomic<size_t>                      _journalCount { 0 };
+
+    std::thread                           _syncThread;
+    std::condition_variable               _syncCondition;
+    std::chrono::milliseconds             _syncInterval { 1000 };
+    std::chrono::steady_clock::time_point _lastSync;
+    bool                                  _syncRequested { false };
+    bool                                  _stopSyncThread { false };
+};
+
+} // namespace TINKERUSD_NS
@@ -17,6 +17,7 @@
 #include "usdUndoBlock.h"
 
 #include "debugCodes.h"
+#include "usdEditJournal.h"
 
 namespace TINKERUSD_NS
 {
@@ -47,6 +48,12 @@ UsdUndoBlock::~UsdUndoBlock()
         TF_DEBUG_MSG(UNDOSTACK, "Undoable Item adopted the new edits.\n");
     }
 
+    // hand the journaled edits of the whole block to the operating system
+    if (_undoBlockDepth == 0)
+    {
+        UsdEditJournal::instance().flush();
+    }
+
     TF_DEBUG_MSG(UNDOSTACK, "--Closed undo block at depth %i\n", _undoBlockDepth);
 }
 
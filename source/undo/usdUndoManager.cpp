@@ -41,6 +41,20 @@ void UsdUndoManager::trackLayerStates(const SdfLayerHandle& layer)
     }
 }
 
+bool UsdUndoManager::markLayerClean(const SdfLayerHandle& layer)
+{
+    auto usdUndoStateDelegatePtr = TfDynamic_cast<UsdUndoStateDelegatePtr>(layer->GetStateDelegate());
+    if (!usdUndoStateDelegatePtr)
+    {
+        return false;
+    }
+
+    usdUndoStateDelegatePtr->_MarkCurrentStateAsClean();
+    return true;
+}
+
+void UsdUndoManager::setEditGuard(std::function<void()> guard) { _editGuard = std::move(guard); }
+
 void UsdUndoManager::addInverse(UsdUndoableItem::InvertFunc func)
 {
     if (UsdUndoBlock::depth() == 0)
@@ -67,4 +81,12 @@ void UsdUndoManager::transferEdits(UsdUndoableItem& undoableItem, bool extraEdit
     }
 }
 
+void UsdUndoManager::beforeEdit() const
+{
+    if (_editGuard)
+    {
+        _editGuard();
+    }
+}
+
 } // namespace TINKERUSD_NS
@@ -46,6 +46,14 @@ public:
     // tracks layer states by spawning a new UsdUndoStateDelegate
     void trackLayerStates(const SdfLayerHandle& layer);
 
+    // called before every edit of a tracked layer is applied, e.g. to stop the threads
+    // reading the stage: USD does not support reading a stage while it is being authored.
+    void setEditGuard(std::function<void()> guard);
+
+    // marks a tracked layer as saved without reloading it, once its current content was
+    // written by other means than SdfLayer::Save. Returns false for layers that are not tracked.
+    bool markLayerClean(const SdfLayerHandle& layer);
+
 private:
     friend class UsdUndoManagerAccessor;
 
@@ -54,13 +62,15 @@ private:
 
     void addInverse(UsdUndoableItem::InvertFunc func);
     void transferEdits(UsdUndoableItem& undoableItem, bool extraEdits);
+    void beforeEdit() const;
 
 private:
     UsdUndoableItem::InvertFuncs _invertFuncs;
+    std::function<void()>        _editGuard;
 };
 
 //! \brief Helper struct which exists only to provide controlled,
-//!        deliberate access to UsdUndoManager addInverse/transferEdits
+//!        deliberate access to UsdUndoManager addInverse/transferEdits/beforeEdit
 //!        private methods.
 class UsdUndoManagerAccessor
 {
@@ -80,6 +90,11 @@ public:
         auto& undoManager = UsdUndoManager::instance();
         undoManager.transferEdits(undoableItem, extraEdits);
     }
+    static void beforeEdit()
+    {
+        auto& undoManager = UsdUndoManager::instance();
+        undoManager.beforeEdit();
+    }
 };
 
 } // namespace TINKERUSD_NS
\ No newline at end of file
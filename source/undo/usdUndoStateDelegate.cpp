@@ -17,6 +17,7 @@
 #include "usdUndoStateDelegate.h"
 
 #include "debugCodes.h"
+#include "usdEditJournal.h"
 #include "usdUndoBlock.h"
 #include "usdUndoManager.h"
 
@@ -25,6 +26,13 @@ PXR_NAMESPACE_USING_DIRECTIVE
 namespace
 {
 
+VtValue toVtValue(const SdfAbstractDataConstValue& value)
+{
+    VtValue result;
+    value.GetValue(&result);
+    return result;
+}
+
 void copySpecAtPath(const SdfAbstractData& src, SdfAbstractData* dst, const SdfPath& path)
 {
     // create a new spec at a path with the given specType
@@ -250,8 +258,14 @@ void UsdUndoStateDelegate::invertSetTimeSample(const SdfPath& path, double time,
 
 void UsdUndoStateDelegate::_OnSetField(const SdfPath& path, const TfToken& fieldName, const VtValue& value)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
+    if (_layer)
+    {
+        UsdEditJournal::instance().recordSetField(_layer, path, fieldName, value);
+    }
+
     // early return if we are not inside an UsdUndoBlock
     if (UsdUndoBlock::depth() == 0)
     {
@@ -280,8 +294,14 @@ void UsdUndoStateDelegate::_OnSetField(
     const TfToken&                   fieldName,
     const SdfAbstractDataConstValue& value)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
+    if (_layer && UsdEditJournal::instance().isRecording())
+    {
+        UsdEditJournal::instance().recordSetField(_layer, path, fieldName, toVtValue(value));
+    }
+
     // early return if we are not inside an UsdUndoBlock
     if (UsdUndoBlock::depth() == 0)
     {
@@ -312,6 +332,11 @@ void UsdUndoStateDelegate::_OnSetFieldDictValueByKey(
     const TfToken& keyPath,
     const VtValue& value)
 {
+    if (_layer)
+    {
+        UsdEditJournal::instance().recordSetFieldDictValueByKey(_layer, path, fieldName, keyPath, value);
+    }
+
     _OnSetFieldDictValueByKeyImpl(path, fieldName, keyPath);
 }
 
@@ -321,11 +346,22 @@ void UsdUndoStateDelegate::_OnSetFieldDictValueByKey(
     const TfToken&                   keyPath,
     const SdfAbstractDataConstValue& value)
 {
+    if (_layer && UsdEditJournal::instance().isRecording())
+    {
+        UsdEditJournal::instance().recordSetFieldDictValueByKey(
+            _layer, path, fieldName, keyPath, toVtValue(value));
+    }
+
     _OnSetFieldDictValueByKeyImpl(path, fieldName, keyPath);
 }
 
 void UsdUndoStateDelegate::_OnSetTimeSample(const SdfPath& path, double time, const VtValue& value)
 {
+    if (_layer)
+    {
+        UsdEditJournal::instance().recordSetTimeSample(_layer, path, time, value);
+    }
+
     _OnSetTimeSampleImpl(path, time);
 }
 
@@ -334,13 +370,24 @@ void UsdUndoStateDelegate::_OnSetTimeSample(
     double                           time,
     const SdfAbstractDataConstValue& value)
 {
+    if (_layer && UsdEditJournal::instance().isRecording())
+    {
+        UsdEditJournal::instance().recordSetTimeSample(_layer, path, time, toVtValue(value));
+    }
+
     _OnSetTimeSampleImpl(path, time);
 }
 
 void UsdUndoStateDelegate::_OnCreateSpec(const SdfPath& path, SdfSpecType specType, bool inert)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
+    if (_layer)
+    {
+        UsdEditJournal::instance().recordCreateSpec(_layer, path, specType, inert);
+    }
+
     // early return if we are not inside an UsdUndoBlock
     if (UsdUndoBlock::depth() == 0)
     {
@@ -362,8 +409,14 @@ void UsdUndoStateDelegate::_OnCreateSpec(const SdfPath& path, SdfSpecType specTy
 
 void UsdUndoStateDelegate::_OnDeleteSpec(const SdfPath& path, bool inert)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
+    if (_layer)
+    {
+        UsdEditJournal::instance().recordDeleteSpec(_layer, path, inert);
+    }
+
     // early return if we are not inside an UsdUndoBlock
     if (UsdUndoBlock::depth() == 0)
     {
@@ -397,8 +450,14 @@ void UsdUndoStateDelegate::_OnDeleteSpec(const SdfPath& path, bool inert)
 
 void UsdUndoStateDelegate::_OnMoveSpec(const SdfPath& oldPath, const SdfPath& newPath)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
+    if (_layer)
+    {
+        UsdEditJournal::instance().recordMoveSpec(_layer, oldPath, newPath);
+    }
+
     // early return if we are not inside an UsdUndoBlock
     if (UsdUndoBlock::depth() == 0)
     {
@@ -425,8 +484,14 @@ void UsdUndoStateDelegate::_OnPushChild(
     const TfToken& fieldName,
     const TfToken& value)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
+    if (_layer)
+    {
+        UsdEditJournal::instance().recordPushChild(_layer, parentPath, fieldName, value);
+    }
+
     // early return if we are not inside an UsdUndoBlock
     if (UsdUndoBlock::depth() == 0)
     {
@@ -453,8 +518,14 @@ void UsdUndoStateDelegate::_OnPushChild(
     const TfToken& fieldName,
     const SdfPath& value)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
+    if (_layer)
+    {
+        UsdEditJournal::instance().recordPushChild(_layer, parentPath, fieldName, value);
+    }
+
     // early return if we are not inside an UsdUndoBlock
     if (UsdUndoBlock::depth() == 0)
     {
@@ -481,8 +552,14 @@ void UsdUndoStateDelegate::_OnPopChild(
     const TfToken& fieldName,
     const TfToken& oldValue)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
+    if (_layer)
+    {
+        UsdEditJournal::instance().recordPopChild(_layer, parentPath, fieldName, oldValue);
+    }
+
     // early return if we are not inside an UsdUndoBlock
     if (UsdUndoBlock::depth() == 0)
     {
@@ -509,8 +586,14 @@ void UsdUndoStateDelegate::_OnPopChild(
     const TfToken& fieldName,
     const SdfPath& oldValue)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
+    if (_layer)
+    {
+        UsdEditJournal::instance().recordPopChild(_layer, parentPath, fieldName, oldValue);
+    }
+
     // early return if we are not inside an UsdUndoBlock
     if (UsdUndoBlock::depth() == 0)
     {
@@ -537,6 +620,7 @@ void UsdUndoStateDelegate::_OnSetFieldDictValueByKeyImpl(
     const TfToken& fieldName,
     const TfToken& keyPath)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
     // early return if we are not inside an UsdUndoBlock
@@ -568,6 +652,7 @@ void UsdUndoStateDelegate::_OnSetFieldDictValueByKeyImpl(
 
 void UsdUndoStateDelegate::_OnSetTimeSampleImpl(const SdfPath& path, double time)
 {
+    UsdUndoManagerAccessor::beforeEdit();
     _MarkCurrentStateAsDirty();
 
     // early return if we are not inside an UsdUndoBlock
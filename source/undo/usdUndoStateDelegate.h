@@ -44,6 +44,8 @@ public:
     static UsdUndoStateDelegateRefPtr New();
 
 private:
+    friend class UsdUndoManager;
+
     void invertSetField(const SdfPath& path, const TfToken& fieldName, const VtValue& inverse);
     void invertCreateSpec(const SdfPath& path, bool inert);
     void invertDeleteSpec(